@@ -0,0 +1,281 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A fixed-size pool of worker threads sharing a single task queue.
+ *
+ * submit() queues a task and returns a future for its result. parallel_for()
+ * splits an index range into chunks that are claimed dynamically by the workers
+ * and by the calling thread, and returns once every index has been processed.
+ * The calling thread never waits on a queued task that has not started, so
+ * parallel_for() may be nested inside a task without deadlocking the pool.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	class thread_pool
+	{
+	public:
+		/**
+		 * Starts the given number of worker threads (at least one).
+		 */
+		explicit thread_pool( const std::size_t threads = std::thread::hardware_concurrency() )
+		{
+			const auto count = std::max< std::size_t >( threads, 1 );
+
+			this->workers.reserve( count );
+
+			for ( std::size_t worker = 0; worker < count; ++worker )
+			{
+				this->workers.emplace_back( [this]()
+				{
+					this->run();
+				} );
+			}
+		}
+
+		/**
+		 * Runs the remaining queued tasks, then joins the workers.
+		 */
+		~thread_pool() noexcept
+		{
+			{
+				std::lock_guard< std::mutex > lock( this->mutex );
+				this->stopping = true;
+			}
+
+			this->available.notify_all();
+
+			for ( auto& worker : this->workers )
+			{
+				worker.join();
+			}
+		}
+
+		thread_pool( const thread_pool& ) = delete;
+		thread_pool( thread_pool&& ) = delete;
+
+		thread_pool& operator=( const thread_pool& ) = delete;
+		thread_pool& operator=( thread_pool&& ) = delete;
+
+		std::size_t
+		size() const noexcept
+		{
+			return this->workers.size();
+		}
+
+		/**
+		 * Queues the function and returns a future holding its result (or its exception).
+		 */
+		template < typename Function >
+		auto
+		submit( Function&& function ) -> std::future< decltype( function() ) >
+		{
+			using result_type = decltype( function() );
+
+			auto task = std::make_shared< std::packaged_task< result_type() > >(
+				std::forward< Function >( function ) );
+			auto result = task->get_future();
+
+			this->enqueue( [task]()
+			{
+				( *task )();
+			} );
+
+			return result;
+		}
+
+		/**
+		 * Calls function( index ) for every index in [first, last), in chunks of grain
+		 * indices (0 picks a grain giving a few chunks per thread). The first exception
+		 * thrown by the function is rethrown once every chunk has completed.
+		 */
+		template < typename Function >
+		void
+		parallel_for(
+			const std::size_t first,
+			const std::size_t last,
+			Function&& function,
+			std::size_t grain = 0 )
+		{
+			if ( first >= last )
+			{
+				return;
+			}
+
+			const auto count = last - first;
+
+			if ( grain == 0 )
+			{
+				grain = std::max< std::size_t >( count / ( 4 * ( this->size() + 1 ) ), 1 );
+			}
+
+			const auto chunks = ( count + grain - 1 ) / grain;
+			const auto helpers = std::min( chunks - 1, this->size() );
+
+			auto state = std::make_shared< loop_state >( first, last, grain, chunks );
+
+			state->body = [&function]( const std::size_t begin, const std::size_t end )
+			{
+				for ( auto index = begin; index < end; ++index )
+				{
+					function( index );
+				}
+			};
+
+			for ( std::size_t helper = 0; helper < helpers; ++helper )
+			{
+				this->enqueue( [state]()
+				{
+					state->run_chunks();
+				} );
+			}
+
+			state->run_chunks();
+			state->wait();
+		}
+
+	private:
+		/**
+		 * Shared progress of one parallel_for() call. Helpers that start after every
+		 * chunk was claimed find no work and never touch the (possibly gone) body.
+		 */
+		struct loop_state
+		{
+			loop_state(
+				const std::size_t begin,
+				const std::size_t end,
+				const std::size_t chunk_size,
+				const std::size_t chunk_count ) :
+				next( begin ),
+				last( end ),
+				grain( chunk_size ),
+				pending( chunk_count )
+			{
+			}
+
+			void
+			run_chunks()
+			{
+				while ( true )
+				{
+					const auto begin = this->next.fetch_add( this->grain );
+
+					if ( begin >= this->last )
+					{
+						return;
+					}
+
+					try
+					{
+						this->body( begin, std::min( begin + this->grain, this->last ) );
+					}
+					catch ( ... )
+					{
+						std::lock_guard< std::mutex > lock( this->mutex );
+
+						if ( !this->error )
+						{
+							this->error = std::current_exception();
+						}
+					}
+
+					std::lock_guard< std::mutex > lock( this->mutex );
+
+					if ( --this->pending == 0 )
+					{
+						this->done.notify_all();
+					}
+				}
+			}
+
+			void
+			wait()
+			{
+				std::unique_lock< std::mutex > lock( this->mutex );
+
+				this->done.wait( lock, [this]()
+				{
+					return this->pending == 0;
+				} );
+
+				if ( this->error )
+				{
+					std::rethrow_exception( this->error );
+				}
+			}
+
+			std::atomic< std::size_t > next;
+			const std::size_t last;
+			const std::size_t grain;
+			std::function< void( std::size_t, std::size_t ) > body;
+
+			std::mutex mutex;
+			std::condition_variable done;
+			std::size_t pending;
+			std::exception_ptr error;
+		};
+
+		void
+		enqueue( std::function< void() > task )
+		{
+			{
+				std::lock_guard< std::mutex > lock( this->mutex );
+				this->tasks.push_back( std::move( task ) );
+			}
+
+			this->available.notify_one();
+		}
+
+		void
+		run()
+		{
+			while ( true )
+			{
+				std::function< void() > task;
+
+				{
+					std::unique_lock< std::mutex > lock( this->mutex );
+
+					this->available.wait( lock, [this]()
+					{
+						return this->stopping || !this->tasks.empty();
+					} );
+
+					if ( this->tasks.empty() )
+					{
+						return;
+					}
+
+					task = std::move( this->tasks.front() );
+					this->tasks.pop_front();
+				}
+
+				task();
+			}
+		}
+
+		std::vector< std::thread > workers;
+		std::deque< std::function< void() > > tasks;
+
+		std::mutex mutex;
+		std::condition_variable available;
+		bool stopping = false;
+	};
+}
@@ -0,0 +1,254 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Parallel direction-optimizing breadth-first search
+ * (Beamer, Asanovic, Patterson - "Direction-Optimizing Breadth-First Search").
+ *
+ * Each level is expanded either top-down (the frontier vertices claim their
+ * unvisited out-neighbors) or bottom-up (the unvisited vertices look for a
+ * parent among their in-neighbors in the frontier). Top-down is cheaper while
+ * the frontier is small; once the edges leaving the frontier outnumber the edges
+ * left to explore by a factor alpha, bottom-up is cheaper since most vertices
+ * find a parent after a few checks. The search returns to top-down once the
+ * frontier shrinks below 1 / beta of the vertices.
+ *
+ * Top-down levels keep the frontier as a queue and claim vertices by atomically
+ * setting their parent; bottom-up levels keep it as a bitmap and split the
+ * vertices by bitmap words, so every vertex and word has a single writer. Both
+ * run on a thread_pool.
+ *
+ * The graph exposes vertex_count(), edge_count(), degree( vertex ) and
+ * neighbors( vertex ) (such as csr_graph); the bottom-up steps read the in-edges
+ * from its transpose (the graph itself when it is undirected).
+ */
+
+#pragma once
+
+#include "../concurrency/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Vertex >
+	struct breadth_first_tree
+	{
+		static constexpr Vertex unreached = std::numeric_limits< Vertex >::max();
+
+		// Parent of every vertex in the search tree (the source is its own parent).
+		std::vector< Vertex > parents;
+
+		// Number of edges from the source to every vertex.
+		std::vector< Vertex > distances;
+	};
+
+	/**
+	 * Searches the graph from source. alpha = 0 disables the bottom-up levels and
+	 * beta = 0 keeps the search bottom-up once it switched. Throws std::out_of_range
+	 * if source is not a vertex of the graph.
+	 */
+	template < typename Graph >
+	breadth_first_tree< typename Graph::vertex_type >
+	breadth_first_search(
+		const Graph& graph,
+		const Graph& transposed,
+		const typename Graph::vertex_type source,
+		thread_pool& pool,
+		const std::size_t alpha = 15,
+		const std::size_t beta = 18 )
+	{
+		using vertex_type = typename Graph::vertex_type;
+		using tree_type = breadth_first_tree< vertex_type >;
+
+		constexpr std::size_t WORD_BITS = 64;
+
+		const auto vertices = graph.vertex_count();
+
+		if ( static_cast< std::size_t >( source ) >= vertices )
+		{
+			throw std::out_of_range( "breadth_first_search: source out of range" );
+		}
+
+		const auto words = ( vertices + WORD_BITS - 1 ) / WORD_BITS;
+		const auto chunks = 4 * ( pool.size() + 1 );
+
+		tree_type tree;
+		tree.distances.assign( vertices, tree_type::unreached );
+
+		std::vector< std::atomic< vertex_type > > parents( vertices );
+
+		pool.parallel_for( 0, vertices, [&parents]( const std::size_t vertex )
+		{
+			parents[ vertex ].store( tree_type::unreached, std::memory_order_relaxed );
+		} );
+
+		parents[ source ].store( source, std::memory_order_relaxed );
+		tree.distances[ source ] = 0;
+
+		std::vector< vertex_type > queue { source };
+		std::vector< std::uint64_t > bitmap;
+		std::vector< std::uint64_t > next_bitmap;
+
+		// Per-chunk outputs, merged after each level.
+		std::vector< std::vector< vertex_type > > chunk_queues( chunks );
+		std::vector< std::size_t > chunk_counts( chunks );
+		std::vector< std::size_t > chunk_edges( chunks );
+
+		std::size_t frontier_size = 1;
+		std::size_t frontier_edges = graph.degree( source );
+		std::size_t unexplored_edges = graph.edge_count() - frontier_edges;
+		bool bottom_up = false;
+
+		for ( vertex_type level = 1; frontier_size > 0; ++level )
+		{
+			if ( !bottom_up && alpha > 0 && frontier_edges * alpha > unexplored_edges )
+			{
+				// Convert the queue to a bitmap.
+				bitmap.assign( words, 0 );
+
+				for ( const auto vertex : queue )
+				{
+					bitmap[ vertex / WORD_BITS ] |= std::uint64_t { 1 } << ( vertex % WORD_BITS );
+				}
+
+				bottom_up = true;
+			}
+			else if ( bottom_up && frontier_size * beta < vertices )
+			{
+				// Convert the bitmap to a queue.
+				pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+				{
+					auto& output = chunk_queues[ chunk ];
+					output.clear();
+
+					for ( auto word = words * chunk / chunks; word < words * ( chunk + 1 ) / chunks; ++word )
+					{
+						for ( std::size_t bit = 0; bit < WORD_BITS; ++bit )
+						{
+							if ( ( bitmap[ word ] >> bit ) & 1 )
+							{
+								output.push_back( static_cast< vertex_type >( word * WORD_BITS + bit ) );
+							}
+						}
+					}
+				}, 1 );
+
+				queue.clear();
+
+				for ( const auto& output : chunk_queues )
+				{
+					queue.insert( std::end( queue ), std::begin( output ), std::end( output ) );
+				}
+
+				bottom_up = false;
+			}
+
+			if ( bottom_up )
+			{
+				next_bitmap.assign( words, 0 );
+
+				pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+				{
+					std::size_t count = 0;
+					std::size_t edges = 0;
+
+					for ( auto word = words * chunk / chunks; word < words * ( chunk + 1 ) / chunks; ++word )
+					{
+						const auto last = std::min( ( word + 1 ) * WORD_BITS, vertices );
+
+						for ( auto vertex = word * WORD_BITS; vertex < last; ++vertex )
+						{
+							if ( parents[ vertex ].load( std::memory_order_relaxed ) != tree_type::unreached )
+							{
+								continue;
+							}
+
+							for ( const auto parent : transposed.neighbors( static_cast< vertex_type >( vertex ) ) )
+							{
+								if ( ( bitmap[ parent / WORD_BITS ] >> ( parent % WORD_BITS ) ) & 1 )
+								{
+									parents[ vertex ].store( parent, std::memory_order_relaxed );
+									tree.distances[ vertex ] = level;
+									next_bitmap[ word ] |= std::uint64_t { 1 } << ( vertex % WORD_BITS );
+									edges += graph.degree( static_cast< vertex_type >( vertex ) );
+									++count;
+									break;
+								}
+							}
+						}
+					}
+
+					chunk_counts[ chunk ] = count;
+					chunk_edges[ chunk ] = edges;
+				}, 1 );
+
+				bitmap.swap( next_bitmap );
+			}
+			else
+			{
+				pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+				{
+					auto& output = chunk_queues[ chunk ];
+					std::size_t edges = 0;
+
+					output.clear();
+
+					for ( auto index = queue.size() * chunk / chunks; index < queue.size() * ( chunk + 1 ) / chunks; ++index )
+					{
+						const auto vertex = queue[ index ];
+
+						for ( const auto target : graph.neighbors( vertex ) )
+						{
+							auto expected = tree_type::unreached;
+
+							if ( parents[ target ].load( std::memory_order_relaxed ) == tree_type::unreached &&
+								parents[ target ].compare_exchange_strong( expected, vertex, std::memory_order_relaxed ) )
+							{
+								tree.distances[ target ] = level;
+								output.push_back( target );
+								edges += graph.degree( target );
+							}
+						}
+					}
+
+					chunk_counts[ chunk ] = output.size();
+					chunk_edges[ chunk ] = edges;
+				}, 1 );
+
+				queue.clear();
+
+				for ( const auto& output : chunk_queues )
+				{
+					queue.insert( std::end( queue ), std::begin( output ), std::end( output ) );
+				}
+			}
+
+			frontier_size = 0;
+			frontier_edges = 0;
+
+			for ( std::size_t chunk = 0; chunk < chunks; ++chunk )
+			{
+				frontier_size += chunk_counts[ chunk ];
+				frontier_edges += chunk_edges[ chunk ];
+			}
+
+			unexplored_edges -= frontier_edges;
+		}
+
+		tree.parents.resize( vertices );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			tree.parents[ vertex ] = parents[ vertex ].load( std::memory_order_relaxed );
+		}
+
+		return tree;
+	}
+}
@@ -0,0 +1,22 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Result of a component decomposition: the component of every vertex,
+ * numbered from 0 to count - 1.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Vertex >
+	struct component_labels
+	{
+		std::size_t count = 0;
+		std::vector< Vertex > labels;
+	};
+}
@@ -0,0 +1,129 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Parallel connected components by Afforest
+ * (Sutton, Ben-Nun, Barak - "Optimizing Parallel Graph Connectivity Computation
+ * via Subgraph Sampling").
+ *
+ * The edges are merged into a lock-free union_find on a thread_pool. The first
+ * few out-edges of every vertex are merged first, which usually links most
+ * vertices into one giant component. Its root is then estimated by sampling
+ * vertices, and the remaining edges are only merged from the vertices outside
+ * of it: an edge between the giant component and another vertex is seen from
+ * that vertex, through the transpose (the graph itself when it is undirected).
+ * For a directed graph, the components are the weakly connected ones.
+ *
+ * The graph exposes vertex_count() and neighbors( vertex ) (such as csr_graph).
+ */
+
+#pragma once
+
+#include "component_labels.hpp"
+#include "union_find.hpp"
+#include "../concurrency/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace dsa
+{
+	/**
+	 * Labels the connected components, numbered in the order of their smallest vertex.
+	 * neighbor_rounds is the number of out-edges per vertex merged before sampling.
+	 */
+	template < typename Graph >
+	component_labels< typename Graph::vertex_type >
+	connected_components(
+		const Graph& graph,
+		const Graph& transposed,
+		thread_pool& pool,
+		const std::size_t neighbor_rounds = 2 )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		constexpr std::size_t SAMPLES = 1024;
+
+		const auto vertices = graph.vertex_count();
+		const auto undirected = &graph == &transposed;
+
+		union_find< vertex_type > sets( vertices );
+
+		for ( std::size_t round = 0; round < neighbor_rounds; ++round )
+		{
+			pool.parallel_for( 0, vertices, [&]( const std::size_t vertex )
+			{
+				const auto neighbors = graph.neighbors( static_cast< vertex_type >( vertex ) );
+
+				if ( round < neighbors.size() )
+				{
+					sets.unite( static_cast< vertex_type >( vertex ), neighbors[ round ] );
+				}
+			} );
+		}
+
+		// Most frequent root among the samples.
+		auto giant = vertices;
+
+		if ( vertices > 0 )
+		{
+			std::mt19937 engine( 1 );
+			std::unordered_map< vertex_type, std::size_t > frequencies;
+			std::size_t most = 0;
+
+			for ( std::size_t sample = 0; sample < SAMPLES; ++sample )
+			{
+				const auto root = sets.find( static_cast< vertex_type >( engine() % vertices ) );
+				const auto frequency = ++frequencies[ root ];
+
+				if ( frequency > most )
+				{
+					most = frequency;
+					giant = root;
+				}
+			}
+		}
+
+		pool.parallel_for( 0, vertices, [&]( const std::size_t vertex )
+		{
+			if ( sets.find( static_cast< vertex_type >( vertex ) ) == giant )
+			{
+				return;
+			}
+
+			const auto neighbors = graph.neighbors( static_cast< vertex_type >( vertex ) );
+
+			for ( auto edge = std::min( neighbor_rounds, neighbors.size() ); edge < neighbors.size(); ++edge )
+			{
+				sets.unite( static_cast< vertex_type >( vertex ), neighbors[ edge ] );
+			}
+
+			if ( !undirected )
+			{
+				for ( const auto source : transposed.neighbors( static_cast< vertex_type >( vertex ) ) )
+				{
+					sets.unite( static_cast< vertex_type >( vertex ), source );
+				}
+			}
+		} );
+
+		// Roots are the smallest vertices of their components, so a vertex is never
+		// labeled before its root.
+		component_labels< vertex_type > components;
+		components.labels.resize( vertices );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			const auto root = sets.find( static_cast< vertex_type >( vertex ) );
+
+			components.labels[ vertex ] = root == vertex ?
+				static_cast< vertex_type >( components.count++ ) :
+				components.labels[ root ];
+		}
+
+		return components;
+	}
+}
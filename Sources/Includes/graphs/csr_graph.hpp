@@ -0,0 +1,329 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * An immutable directed graph in compressed sparse row (CSR) form.
+ *
+ * The out-edges of vertex v are targets[ offsets[ v ] .. offsets[ v + 1 ] ),
+ * with their weights at the same positions of the (optional) weights array, so
+ * a traversal reads the edges of consecutive vertices sequentially instead of
+ * chasing per-edge allocations. Vertices are 0-based.
+ *
+ * Building from an edge list is a counting sort on the source vertex, O(V + E),
+ * which keeps the input order of the out-edges of each vertex. transpose() is a
+ * second counting sort, which lists the in-edges of each vertex by source.
+ * Builders that already hold their edges grouped by source can hand over the
+ * arrays directly.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template <
+		typename Vertex = std::uint32_t,
+		typename Weight = std::int32_t >
+	class csr_graph
+	{
+	public:
+		using vertex_type = Vertex;
+		using weight_type = Weight;
+		using offset_type = std::size_t;
+
+		struct edge
+		{
+			Vertex source;
+			Vertex target;
+			Weight weight;
+		};
+
+		/**
+		 * Contiguous view over the targets (or weights) of the out-edges of a vertex.
+		 */
+		template < typename T >
+		class edge_range
+		{
+		public:
+			edge_range(
+				const T* const range_first,
+				const T* const range_last ) noexcept :
+				first( range_first ),
+				last( range_last )
+			{
+			}
+
+			const T*
+			begin() const noexcept
+			{
+				return this->first;
+			}
+
+			const T*
+			end() const noexcept
+			{
+				return this->last;
+			}
+
+			std::size_t
+			size() const noexcept
+			{
+				return static_cast< std::size_t >( this->last - this->first );
+			}
+
+			bool
+			empty() const noexcept
+			{
+				return this->first == this->last;
+			}
+
+			const T&
+			operator[]( const std::size_t index ) const noexcept
+			{
+				return this->first[ index ];
+			}
+
+		private:
+			const T* first;
+			const T* last;
+		};
+
+		csr_graph() = default;
+		~csr_graph() noexcept = default;
+
+		csr_graph( const csr_graph& other ) = default;
+		csr_graph( csr_graph&& other ) noexcept = default;
+
+		csr_graph& operator=( const csr_graph& rhs ) = default;
+		csr_graph& operator=( csr_graph&& rhs ) noexcept = default;
+
+		/**
+		 * Builds the graph from an edge list. The weights are dropped unless weighted is set.
+		 */
+		csr_graph(
+			const std::size_t vertices,
+			const std::vector< edge >& edges,
+			const bool weighted = true )
+		{
+			check_vertex_count( vertices );
+
+			this->vertex_offsets.assign( vertices + 1, 0 );
+
+			for ( const auto& input : edges )
+			{
+				if ( static_cast< std::size_t >( input.source ) >= vertices ||
+					static_cast< std::size_t >( input.target ) >= vertices )
+				{
+					throw std::out_of_range( "csr_graph: edge vertex out of range" );
+				}
+
+				++( this->vertex_offsets[ input.source + 1 ] );
+			}
+
+			std::partial_sum(
+				std::begin( this->vertex_offsets ),
+				std::end( this->vertex_offsets ),
+				std::begin( this->vertex_offsets ) );
+
+			this->edge_targets.resize( edges.size() );
+
+			if ( weighted )
+			{
+				this->edge_weights.resize( edges.size() );
+			}
+
+			std::vector< offset_type > cursors(
+				std::begin( this->vertex_offsets ),
+				std::prev( std::end( this->vertex_offsets ) ) );
+
+			for ( const auto& input : edges )
+			{
+				const auto position = cursors[ input.source ]++;
+
+				this->edge_targets[ position ] = input.target;
+
+				if ( weighted )
+				{
+					this->edge_weights[ position ] = input.weight;
+				}
+			}
+
+			this->is_weighted = weighted;
+		}
+
+		/**
+		 * Adopts arrays already in CSR form. The weights are either empty (unweighted graph)
+		 * or one per edge.
+		 */
+		csr_graph(
+			std::vector< offset_type > offsets,
+			std::vector< Vertex > targets,
+			std::vector< Weight > weights = {} ) :
+			vertex_offsets( std::move( offsets ) ),
+			edge_targets( std::move( targets ) ),
+			edge_weights( std::move( weights ) ),
+			is_weighted( !this->edge_weights.empty() )
+		{
+			if ( this->vertex_offsets.empty() ||
+				this->vertex_offsets.front() != 0 ||
+				this->vertex_offsets.back() != this->edge_targets.size() ||
+				( !this->edge_weights.empty() && this->edge_weights.size() != this->edge_targets.size() ) )
+			{
+				throw std::invalid_argument( "csr_graph: inconsistent arrays" );
+			}
+
+			check_vertex_count( this->vertex_count() );
+
+			for ( std::size_t vertex = 0; vertex < this->vertex_count(); ++vertex )
+			{
+				if ( this->vertex_offsets[ vertex ] > this->vertex_offsets[ vertex + 1 ] )
+				{
+					throw std::invalid_argument( "csr_graph: decreasing offsets" );
+				}
+			}
+
+			for ( const auto target : this->edge_targets )
+			{
+				if ( static_cast< std::size_t >( target ) >= this->vertex_count() )
+				{
+					throw std::out_of_range( "csr_graph: edge vertex out of range" );
+				}
+			}
+		}
+
+		std::size_t
+		vertex_count() const noexcept
+		{
+			return this->vertex_offsets.empty() ? 0 : this->vertex_offsets.size() - 1;
+		}
+
+		std::size_t
+		edge_count() const noexcept
+		{
+			return this->edge_targets.size();
+		}
+
+		bool
+		empty() const noexcept
+		{
+			return this->vertex_count() == 0;
+		}
+
+		bool
+		weighted() const noexcept
+		{
+			return this->is_weighted;
+		}
+
+		std::size_t
+		degree( const Vertex vertex ) const noexcept
+		{
+			return this->vertex_offsets[ vertex + 1 ] - this->vertex_offsets[ vertex ];
+		}
+
+		edge_range< Vertex >
+		neighbors( const Vertex vertex ) const noexcept
+		{
+			return edge_range< Vertex >(
+				this->edge_targets.data() + this->vertex_offsets[ vertex ],
+				this->edge_targets.data() + this->vertex_offsets[ vertex + 1 ] );
+		}
+
+		/**
+		 * Weights of the out-edges of a vertex, in the order of neighbors(); the graph must be weighted.
+		 */
+		edge_range< Weight >
+		neighbor_weights( const Vertex vertex ) const noexcept
+		{
+			return edge_range< Weight >(
+				this->edge_weights.data() + this->vertex_offsets[ vertex ],
+				this->edge_weights.data() + this->vertex_offsets[ vertex + 1 ] );
+		}
+
+		const std::vector< offset_type >&
+		offsets() const noexcept
+		{
+			return this->vertex_offsets;
+		}
+
+		const std::vector< Vertex >&
+		targets() const noexcept
+		{
+			return this->edge_targets;
+		}
+
+		const std::vector< Weight >&
+		weights() const noexcept
+		{
+			return this->edge_weights;
+		}
+
+		/**
+		 * Returns the graph with every edge reversed, keeping the weights.
+		 */
+		csr_graph
+		transpose() const
+		{
+			const auto vertices = this->vertex_count();
+
+			std::vector< offset_type > offsets( vertices + 1, 0 );
+
+			for ( const auto target : this->edge_targets )
+			{
+				++offsets[ target + 1 ];
+			}
+
+			std::partial_sum( std::begin( offsets ), std::end( offsets ), std::begin( offsets ) );
+
+			std::vector< Vertex > targets( this->edge_count() );
+			std::vector< Weight > weights( this->is_weighted ? this->edge_count() : 0 );
+			std::vector< offset_type > cursors( std::begin( offsets ), std::prev( std::end( offsets ) ) );
+
+			for ( std::size_t source = 0; source < vertices; ++source )
+			{
+				for ( auto index = this->vertex_offsets[ source ]; index < this->vertex_offsets[ source + 1 ]; ++index )
+				{
+					const auto position = cursors[ this->edge_targets[ index ] ]++;
+
+					targets[ position ] = static_cast< Vertex >( source );
+
+					if ( this->is_weighted )
+					{
+						weights[ position ] = this->edge_weights[ index ];
+					}
+				}
+			}
+
+			csr_graph transposed;
+			transposed.vertex_offsets = std::move( offsets );
+			transposed.edge_targets = std::move( targets );
+			transposed.edge_weights = std::move( weights );
+			transposed.is_weighted = this->is_weighted;
+
+			return transposed;
+		}
+
+	private:
+		static void
+		check_vertex_count( const std::size_t vertices )
+		{
+			if ( vertices > static_cast< std::size_t >( std::numeric_limits< Vertex >::max() ) )
+			{
+				throw std::length_error( "csr_graph: vertex index space exhausted" );
+			}
+		}
+
+		std::vector< offset_type > vertex_offsets;
+		std::vector< Vertex > edge_targets;
+		std::vector< Weight > edge_weights;
+		bool is_weighted = false;
+	};
+}
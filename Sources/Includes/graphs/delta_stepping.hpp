@@ -0,0 +1,295 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Parallel single-source shortest paths by delta-stepping
+ * (Meyer, Sanders - "Delta-stepping: a parallelizable shortest path algorithm").
+ *
+ * Vertices wait in buckets of width delta according to their tentative
+ * distance. The lowest non-empty bucket is taken as the frontier and the light
+ * edges (weighing at most delta) of all its vertices are relaxed in parallel;
+ * those relaxations may land in the same bucket and refill it, so they are
+ * repeated until the bucket stays empty. The heavy edges can only land in a
+ * later bucket, so they are relaxed once per vertex, when its bucket is
+ * settled. A small delta approaches Dijkstra's algorithm (little wasted work,
+ * little parallelism) and a large delta approaches Bellman-Ford (much
+ * parallelism, light edges relaxed many times).
+ *
+ * Tentative distances are lowered with an atomic compare-and-swap. The
+ * frontier is split into chunks run on a thread_pool, each filling its own
+ * buckets, which are merged when the next frontier is gathered. A relaxation
+ * lands at most heaviest / delta + 1 buckets past the current one, so the
+ * buckets are kept in a cyclic array of heaviest / delta + 2 slots, reused as
+ * the current bucket moves on. The edge weights must not be negative.
+ *
+ * The graph exposes vertex_count(), edge_count(), weighted(), neighbors( vertex )
+ * and neighbor_weights( vertex ) (such as csr_graph); the edges of an unweighted
+ * graph weigh 1.
+ */
+
+#pragma once
+
+#include "../concurrency/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace dsa
+{
+	/**
+	 * Returns the distance of every vertex from source, numeric_limits< Distance >::max()
+	 * for unreachable vertices. delta = 0 picks the bucket width from the graph: the
+	 * heaviest edge weight divided by the square of the average degree. With evenly
+	 * spread weights, a vertex then has 1 / degree light edges on average, so almost
+	 * every edge is relaxed only once (as a heavy edge) while the buckets stay wide.
+	 */
+	template <
+		typename Distance = std::int64_t,
+		typename Graph >
+	std::vector< Distance >
+	delta_stepping(
+		const Graph& graph,
+		const typename Graph::vertex_type source,
+		thread_pool& pool,
+		Distance delta = 0 )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		constexpr auto unreached = std::numeric_limits< Distance >::max();
+
+		const auto vertices = graph.vertex_count();
+		const auto chunks = 4 * ( pool.size() + 1 );
+
+		const auto weight = [&graph]( const vertex_type vertex, const std::size_t index ) -> Distance
+		{
+			return graph.weighted() ? static_cast< Distance >( graph.neighbor_weights( vertex )[ index ] ) : 1;
+		};
+
+		if ( static_cast< std::size_t >( source ) >= vertices )
+		{
+			throw std::out_of_range( "delta_stepping: source out of range" );
+		}
+
+		if ( delta < 0 )
+		{
+			throw std::invalid_argument( "delta_stepping: negative bucket width" );
+		}
+
+		// Check the weights and find the heaviest one.
+		std::vector< Distance > chunk_lightest( chunks, 0 );
+		std::vector< Distance > chunk_heaviest( chunks, 0 );
+
+		pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+		{
+			for ( auto vertex = vertices * chunk / chunks; vertex < vertices * ( chunk + 1 ) / chunks; ++vertex )
+			{
+				const auto degree = graph.neighbors( static_cast< vertex_type >( vertex ) ).size();
+
+				for ( std::size_t edge = 0; edge < degree; ++edge )
+				{
+					const auto edge_weight = weight( static_cast< vertex_type >( vertex ), edge );
+
+					chunk_lightest[ chunk ] = std::min( chunk_lightest[ chunk ], edge_weight );
+					chunk_heaviest[ chunk ] = std::max( chunk_heaviest[ chunk ], edge_weight );
+				}
+			}
+		}, 1 );
+
+		if ( *std::min_element( std::begin( chunk_lightest ), std::end( chunk_lightest ) ) < 0 )
+		{
+			throw std::invalid_argument( "delta_stepping: negative edge weight" );
+		}
+
+		const auto heaviest = *std::max_element( std::begin( chunk_heaviest ), std::end( chunk_heaviest ) );
+
+		if ( delta == 0 )
+		{
+			const auto degree = std::max< std::size_t >( 1, graph.edge_count() / vertices );
+
+			delta = std::max< Distance >( 1, heaviest / static_cast< Distance >( degree * degree ) );
+		}
+
+		std::vector< std::atomic< Distance > > distances( vertices );
+
+		pool.parallel_for( 0, vertices, [&distances]( const std::size_t vertex )
+		{
+			distances[ vertex ].store( unreached, std::memory_order_relaxed );
+		} );
+
+		distances[ source ].store( 0, std::memory_order_relaxed );
+
+		// Distance at which every vertex last had its light edges relaxed, so that
+		// duplicate frontier entries are skipped and each vertex is settled once.
+		std::vector< std::atomic< Distance > > relaxed( vertices );
+
+		pool.parallel_for( 0, vertices, [&relaxed]( const std::size_t vertex )
+		{
+			relaxed[ vertex ].store( unreached, std::memory_order_relaxed );
+		} );
+
+		// Buckets filled by every chunk, in the slot distance / delta modulo slots,
+		// and the vertices each chunk settled in the current bucket.
+		const auto slots = static_cast< std::size_t >( heaviest / delta ) + 2;
+
+		std::vector< std::vector< std::vector< vertex_type > > > chunk_buckets(
+			chunks,
+			std::vector< std::vector< vertex_type > >( slots ) );
+		std::vector< std::vector< vertex_type > > chunk_settled( chunks );
+		std::vector< vertex_type > frontier { source };
+		std::vector< vertex_type > settled;
+		std::size_t bucket = 0;
+
+		// Lowers the distance of target to candidate, queuing it in its bucket.
+		const auto relax = [&distances, delta, slots]( std::vector< std::vector< vertex_type > >& buckets, const vertex_type target, const Distance candidate )
+		{
+			auto current = distances[ target ].load( std::memory_order_relaxed );
+
+			while ( candidate < current &&
+				!distances[ target ].compare_exchange_weak( current, candidate, std::memory_order_relaxed ) )
+			{
+			}
+
+			if ( candidate < current )
+			{
+				buckets[ static_cast< std::size_t >( candidate / delta ) % slots ].push_back( target );
+			}
+		};
+
+		// Returns whether a bucket is empty in every chunk.
+		const auto bucket_empty = [&chunk_buckets, slots]( const std::size_t index )
+		{
+			return std::all_of( std::begin( chunk_buckets ), std::end( chunk_buckets ), [index, slots]( const std::vector< std::vector< vertex_type > >& buckets )
+			{
+				return buckets[ index % slots ].empty();
+			} );
+		};
+
+		// Moves a bucket of every chunk into the frontier.
+		const auto gather = [&chunk_buckets, &frontier, slots]( const std::size_t index )
+		{
+			frontier.clear();
+
+			for ( auto& buckets : chunk_buckets )
+			{
+				auto& slot = buckets[ index % slots ];
+
+				frontier.insert( std::end( frontier ), std::begin( slot ), std::end( slot ) );
+				slot.clear();
+			}
+		};
+
+		while ( !frontier.empty() )
+		{
+			// Relax the light edges of the bucket until it stays empty: they may
+			// land in it again, while heavy edges always land past it.
+			while ( !frontier.empty() )
+			{
+				pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+				{
+					auto& buckets = chunk_buckets[ chunk ];
+
+					for ( auto index = frontier.size() * chunk / chunks; index < frontier.size() * ( chunk + 1 ) / chunks; ++index )
+					{
+						const auto vertex = frontier[ index ];
+						const auto distance = distances[ vertex ].load( std::memory_order_relaxed );
+
+						// Vertices settled in a lower bucket, or already relaxed at
+						// this distance, are stale entries.
+						if ( distance / delta < static_cast< Distance >( bucket ) )
+						{
+							continue;
+						}
+
+						const auto previous = relaxed[ vertex ].exchange( distance, std::memory_order_relaxed );
+
+						if ( previous == distance )
+						{
+							continue;
+						}
+
+						if ( previous == unreached )
+						{
+							chunk_settled[ chunk ].push_back( vertex );
+						}
+
+						const auto neighbors = graph.neighbors( vertex );
+
+						for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+						{
+							const auto edge_weight = weight( vertex, edge );
+
+							if ( edge_weight <= delta )
+							{
+								relax( buckets, neighbors[ edge ], distance + edge_weight );
+							}
+						}
+					}
+				}, 1 );
+
+				gather( bucket );
+			}
+
+			// Relax the heavy edges of the settled vertices once, from their final distance.
+			settled.clear();
+
+			for ( auto& chunk_vertices : chunk_settled )
+			{
+				settled.insert( std::end( settled ), std::begin( chunk_vertices ), std::end( chunk_vertices ) );
+				chunk_vertices.clear();
+			}
+
+			pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+			{
+				auto& buckets = chunk_buckets[ chunk ];
+
+				for ( auto index = settled.size() * chunk / chunks; index < settled.size() * ( chunk + 1 ) / chunks; ++index )
+				{
+					const auto vertex = settled[ index ];
+					const auto distance = distances[ vertex ].load( std::memory_order_relaxed );
+					const auto neighbors = graph.neighbors( vertex );
+
+					for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+					{
+						const auto edge_weight = weight( vertex, edge );
+
+						if ( edge_weight > delta )
+						{
+							relax( buckets, neighbors[ edge ], distance + edge_weight );
+						}
+					}
+				}
+			}, 1 );
+
+			// The next frontier is the lowest non-empty bucket. Every queued vertex
+			// lies in the slots ahead of the current one, so the search stops after
+			// a single turn of the cyclic array.
+			std::size_t step = 1;
+
+			while ( step < slots && bucket_empty( bucket + step ) )
+			{
+				++step;
+			}
+
+			bucket += step;
+
+			if ( step < slots )
+			{
+				gather( bucket );
+			}
+		}
+
+		std::vector< Distance > result( vertices );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			result[ vertex ] = distances[ vertex ].load( std::memory_order_relaxed );
+		}
+
+		return result;
+	}
+}
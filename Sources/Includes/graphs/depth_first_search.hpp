@@ -0,0 +1,282 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Iterative depth-first search over a graph exposing vertex_count() and
+ * neighbors( vertex ) (such as csr_graph), plus the algorithms built on it:
+ * topological sort and Tarjan's strongly connected components.
+ *
+ * None of them recurse: the path being explored is kept on an explicit stack
+ * of (vertex, next edge) frames, so arbitrarily long paths cannot overflow the
+ * call stack. Vertices are visited in the same order as the recursive search
+ * (out-edges in neighbors() order), and visited vertices are tracked in a bitset.
+ */
+
+#pragma once
+
+#include "component_labels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Graph >
+	class depth_first_search
+	{
+	public:
+		using vertex_type = typename Graph::vertex_type;
+
+		explicit depth_first_search( const Graph& input_graph ) :
+			graph( input_graph ),
+			visited_bits( ( input_graph.vertex_count() + 63 ) / 64, 0 )
+		{
+		}
+
+		bool
+		visited( const vertex_type vertex ) const noexcept
+		{
+			return ( this->visited_bits[ vertex / 64 ] >> ( vertex % 64 ) ) & 1;
+		}
+
+		/**
+		 * Forgets the visited vertices.
+		 */
+		void
+		reset() noexcept
+		{
+			std::fill( std::begin( this->visited_bits ), std::end( this->visited_bits ), 0 );
+		}
+
+		/**
+		 * Visits the vertices reachable from root that were not visited yet, calling
+		 * pre_visit( vertex ) when a vertex is discovered and post_visit( vertex ) once
+		 * all its out-edges were explored.
+		 */
+		template <
+			typename PreVisitor,
+			typename PostVisitor >
+		void
+		visit(
+			const vertex_type root,
+			PreVisitor&& pre_visit,
+			PostVisitor&& post_visit )
+		{
+			if ( this->visited( root ) )
+			{
+				return;
+			}
+
+			this->discover( root, pre_visit );
+
+			while ( !this->stack.empty() )
+			{
+				auto& top = this->stack.back();
+				const auto neighbors = this->graph.neighbors( top.vertex );
+
+				if ( top.next < neighbors.size() )
+				{
+					const auto target = neighbors[ top.next++ ];
+
+					if ( !this->visited( target ) )
+					{
+						this->discover( target, pre_visit );
+					}
+				}
+				else
+				{
+					const auto finished = top.vertex;
+
+					this->stack.pop_back();
+					post_visit( finished );
+				}
+			}
+		}
+
+		/**
+		 * Visits every vertex, starting new searches from the unvisited vertices in index order.
+		 */
+		template <
+			typename PreVisitor,
+			typename PostVisitor >
+		void
+		visit_all(
+			PreVisitor&& pre_visit,
+			PostVisitor&& post_visit )
+		{
+			for ( std::size_t root = 0; root < this->graph.vertex_count(); ++root )
+			{
+				this->visit( static_cast< vertex_type >( root ), pre_visit, post_visit );
+			}
+		}
+
+	private:
+		struct frame
+		{
+			vertex_type vertex;
+			std::size_t next;
+		};
+
+		template < typename PreVisitor >
+		void
+		discover(
+			const vertex_type vertex,
+			PreVisitor& pre_visit )
+		{
+			this->visited_bits[ vertex / 64 ] |= std::uint64_t { 1 } << ( vertex % 64 );
+			this->stack.push_back( { vertex, 0 } );
+			pre_visit( vertex );
+		}
+
+		const Graph& graph;
+		std::vector< std::uint64_t > visited_bits;
+		std::vector< frame > stack;
+	};
+
+	/**
+	 * Orders the vertices so that every edge goes forward (reverse post-order).
+	 * Returns false, leaving order unspecified, if the graph has a cycle.
+	 */
+	template < typename Graph >
+	bool
+	topological_sort(
+		const Graph& graph,
+		std::vector< typename Graph::vertex_type >& order )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		order.clear();
+		order.reserve( graph.vertex_count() );
+
+		depth_first_search< Graph > search( graph );
+		search.visit_all(
+			[]( const vertex_type )
+			{
+			},
+			[&order]( const vertex_type vertex )
+			{
+				order.push_back( vertex );
+			} );
+
+		std::reverse( std::begin( order ), std::end( order ) );
+
+		// Any edge going backward in the order closes a cycle.
+		std::vector< std::size_t > position( graph.vertex_count() );
+
+		for ( std::size_t index = 0; index < order.size(); ++index )
+		{
+			position[ order[ index ] ] = index;
+		}
+
+		for ( std::size_t source = 0; source < graph.vertex_count(); ++source )
+		{
+			for ( const auto target : graph.neighbors( static_cast< vertex_type >( source ) ) )
+			{
+				if ( position[ target ] <= position[ source ] )
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Labels the strongly connected components with Tarjan's algorithm. Components
+	 * are numbered in reverse topological order of the condensed graph: edges between
+	 * components go from higher to lower labels.
+	 */
+	template < typename Graph >
+	component_labels< typename Graph::vertex_type >
+	strongly_connected_components( const Graph& graph )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		struct frame
+		{
+			vertex_type vertex;
+			std::size_t next;
+		};
+
+		constexpr auto unvisited = std::numeric_limits< vertex_type >::max();
+		const auto vertices = graph.vertex_count();
+
+		component_labels< vertex_type > components;
+		components.labels.assign( vertices, unvisited );
+
+		std::vector< vertex_type > index( vertices, unvisited );
+		std::vector< vertex_type > low_link( vertices );
+		std::vector< vertex_type > component_stack;
+		std::vector< frame > stack;
+		vertex_type next_index = 0;
+
+		const auto discover = [&]( const vertex_type vertex )
+		{
+			index[ vertex ] = low_link[ vertex ] = next_index++;
+			component_stack.push_back( vertex );
+			stack.push_back( { vertex, 0 } );
+		};
+
+		for ( std::size_t root = 0; root < vertices; ++root )
+		{
+			if ( index[ root ] != unvisited )
+			{
+				continue;
+			}
+
+			discover( static_cast< vertex_type >( root ) );
+
+			while ( !stack.empty() )
+			{
+				auto& top = stack.back();
+				const auto vertex = top.vertex;
+				const auto neighbors = graph.neighbors( vertex );
+
+				if ( top.next < neighbors.size() )
+				{
+					const auto target = neighbors[ top.next++ ];
+
+					if ( index[ target ] == unvisited )
+					{
+						discover( target );
+					}
+					else if ( components.labels[ target ] == unvisited )
+					{
+						// The target is still on the component stack.
+						low_link[ vertex ] = std::min( low_link[ vertex ], index[ target ] );
+					}
+
+					continue;
+				}
+
+				stack.pop_back();
+
+				if ( !stack.empty() )
+				{
+					auto& parent = low_link[ stack.back().vertex ];
+					parent = std::min( parent, low_link[ vertex ] );
+				}
+
+				if ( low_link[ vertex ] == index[ vertex ] )
+				{
+					const auto label = static_cast< vertex_type >( components.count++ );
+					vertex_type member;
+
+					do
+					{
+						member = component_stack.back();
+						component_stack.pop_back();
+						components.labels[ member ] = label;
+					}
+					while ( member != vertex );
+				}
+			}
+		}
+
+		return components;
+	}
+}
@@ -0,0 +1,690 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Bulk loaders producing edge lists, ready to be turned into a csr_graph or
+ * handed to GraphM::buildGraph and GraphL::buildGraph.
+ *
+ * Two formats are understood. The text format is the one of the GraphM and
+ * GraphL data files: a line with the number of nodes n, n description lines,
+ * then one "from to [label]" line per edge (1-based vertices) until a line
+ * whose from or to is 0. A file may hold several graphs back to back. The
+ * binary format is a header (the 8 byte magic "DSAEDGES", then the vertex and
+ * edge counts as 64-bit integers) followed by one (source, target, weight)
+ * triple of 32-bit integers per edge (0-based vertices), in host byte order.
+ *
+ * Files are memory-mapped where supported (read in a single bulk read
+ * otherwise) and integers are parsed by hand instead of through a stream. The
+ * edge lines are parsed in parallel: the edges are split into chunks at line
+ * boundaries, every chunk is parsed on a thread_pool and the chunks are then
+ * concatenated in order. Since the end of a graph is only known once its
+ * terminating line is found, the chunks cover a window that doubles until it
+ * contains that line, so a file holding many small graphs is not parsed to
+ * its end for each of them.
+ */
+
+#pragma once
+
+#include "../concurrency/thread_pool.hpp"
+#include "csr_graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DSA_GRAPH_LOADER_HAS_MMAP
+#endif
+
+namespace dsa
+{
+	/**
+	 * Read-only view of a whole file.
+	 */
+	class mapped_file
+	{
+	public:
+		explicit mapped_file( const std::string& path )
+		{
+#ifdef DSA_GRAPH_LOADER_HAS_MMAP
+			const int descriptor = ::open( path.c_str(), O_RDONLY );
+
+			if ( descriptor < 0 )
+			{
+				throw std::invalid_argument( "mapped_file: cannot open " + path );
+			}
+
+			struct stat status;
+
+			if ( ::fstat( descriptor, &status ) != 0 )
+			{
+				::close( descriptor );
+				throw std::invalid_argument( "mapped_file: cannot open " + path );
+			}
+
+			this->length = static_cast< std::size_t >( status.st_size );
+
+			if ( this->length > 0 )
+			{
+				void* const view = ::mmap( nullptr, this->length, PROT_READ, MAP_PRIVATE, descriptor, 0 );
+
+				if ( view == MAP_FAILED )
+				{
+					::close( descriptor );
+					throw std::invalid_argument( "mapped_file: cannot map " + path );
+				}
+
+				::madvise( view, this->length, MADV_SEQUENTIAL );
+				this->bytes = static_cast< const char* >( view );
+			}
+
+			::close( descriptor );
+#else
+			std::ifstream input( path, std::ios::in | std::ios::binary | std::ios::ate );
+
+			if ( !input.is_open() )
+			{
+				throw std::invalid_argument( "mapped_file: cannot open " + path );
+			}
+
+			this->buffer.resize( static_cast< std::size_t >( input.tellg() ) );
+			input.seekg( 0 );
+			input.read( this->buffer.data(), static_cast< std::streamsize >( this->buffer.size() ) );
+
+			if ( input.fail() )
+			{
+				throw std::invalid_argument( "mapped_file: cannot read " + path );
+			}
+
+			this->bytes = this->buffer.data();
+			this->length = this->buffer.size();
+#endif
+		}
+
+		~mapped_file() noexcept
+		{
+#ifdef DSA_GRAPH_LOADER_HAS_MMAP
+			if ( this->bytes != nullptr )
+			{
+				::munmap( const_cast< char* >( this->bytes ), this->length );
+			}
+#endif
+		}
+
+		mapped_file( const mapped_file& ) = delete;
+		mapped_file( mapped_file&& ) noexcept = delete;
+
+		mapped_file& operator=( const mapped_file& ) = delete;
+		mapped_file& operator=( mapped_file&& ) noexcept = delete;
+
+		const char*
+		data() const noexcept
+		{
+			return this->bytes;
+		}
+
+		std::size_t
+		size() const noexcept
+		{
+			return this->length;
+		}
+
+	private:
+		const char* bytes = nullptr;
+		std::size_t length = 0;
+#ifndef DSA_GRAPH_LOADER_HAS_MMAP
+		std::vector< char > buffer;
+#endif
+	};
+
+	/**
+	 * A graph as loaded from a file: its vertex count, the descriptions of its
+	 * vertices (text format only) and its edges, 0-based and in file order.
+	 */
+	struct loaded_graph
+	{
+		using vertex_type = csr_graph<>::vertex_type;
+		using weight_type = csr_graph<>::weight_type;
+		using edge = csr_graph<>::edge;
+
+		std::size_t vertices = 0;
+		std::vector< std::string > descriptions;
+		std::vector< edge > edges;
+	};
+
+	namespace graph_loader_detail
+	{
+		constexpr char BINARY_MAGIC[ 8 ] = { 'D', 'S', 'A', 'E', 'D', 'G', 'E', 'S' };
+		constexpr std::size_t BINARY_HEADER_SIZE = 24;
+		constexpr std::size_t BINARY_EDGE_SIZE = 12;
+		constexpr std::size_t INITIAL_WINDOW = std::size_t { 1 } << 20;
+
+		enum class line_kind
+		{
+			edge,
+			blank,
+			terminator,
+			invalid,
+			out_of_range
+		};
+
+		inline bool
+		is_blank( const char character ) noexcept
+		{
+			return character == ' ' || character == '\t' || character == '\r' || character == '\v' || character == '\f';
+		}
+
+		/**
+		 * Parses a signed decimal integer after any blanks of the current line,
+		 * advancing position past it. Fails on a missing or overflowing integer.
+		 */
+		inline bool
+		parse_integer(
+			const char*& position,
+			const char* const last,
+			std::int64_t& value ) noexcept
+		{
+			constexpr std::int64_t LIMIT = std::numeric_limits< std::int64_t >::max() / 10 - 1;
+
+			while ( position != last && is_blank( *position ) )
+			{
+				++position;
+			}
+
+			bool negative = false;
+
+			if ( position != last && ( *position == '-' || *position == '+' ) )
+			{
+				negative = ( *position == '-' );
+				++position;
+			}
+
+			if ( position == last || static_cast< unsigned char >( *position - '0' ) > 9 )
+			{
+				return false;
+			}
+
+			value = 0;
+
+			while ( position != last && static_cast< unsigned char >( *position - '0' ) <= 9 )
+			{
+				if ( value > LIMIT )
+				{
+					return false;
+				}
+
+				value = value * 10 + ( *position++ - '0' );
+			}
+
+			if ( negative )
+			{
+				value = -value;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Parses the edge line [first, last), which holds edge_fields integers (the
+		 * label being the third one), into a 0-based edge.
+		 */
+		inline line_kind
+		parse_edge_line(
+			const char* first,
+			const char* const last,
+			const std::size_t edge_fields,
+			const std::size_t vertices,
+			loaded_graph::edge& output ) noexcept
+		{
+			const char* position = first;
+
+			while ( position != last && is_blank( *position ) )
+			{
+				++position;
+			}
+
+			if ( position == last )
+			{
+				return line_kind::blank;
+			}
+
+			std::int64_t source = 0;
+			std::int64_t target = 0;
+			std::int64_t weight = 0;
+
+			if ( !parse_integer( position, last, source ) ||
+				!parse_integer( position, last, target ) )
+			{
+				return line_kind::invalid;
+			}
+
+			if ( source == 0 || target == 0 )
+			{
+				return line_kind::terminator;
+			}
+
+			if ( edge_fields > 2 &&
+				( !parse_integer( position, last, weight ) ||
+					weight < std::numeric_limits< loaded_graph::weight_type >::min() ||
+					weight > std::numeric_limits< loaded_graph::weight_type >::max() ) )
+			{
+				return line_kind::invalid;
+			}
+
+			if ( source < 1 || static_cast< std::uint64_t >( source ) > vertices ||
+				target < 1 || static_cast< std::uint64_t >( target ) > vertices )
+			{
+				return line_kind::out_of_range;
+			}
+
+			output.source = static_cast< loaded_graph::vertex_type >( source - 1 );
+			output.target = static_cast< loaded_graph::vertex_type >( target - 1 );
+			output.weight = static_cast< loaded_graph::weight_type >( weight );
+
+			return line_kind::edge;
+		}
+
+		inline void
+		throw_line_error( const line_kind kind )
+		{
+			if ( kind == line_kind::out_of_range )
+			{
+				throw std::out_of_range( "graph_loader: edge vertex out of range" );
+			}
+
+			throw std::invalid_argument( "graph_loader: invalid edge data" );
+		}
+
+		/**
+		 * Checks a node count read from a file and returns it as a vertex count.
+		 */
+		inline std::size_t
+		check_node_count( const std::int64_t count )
+		{
+			if ( count < 0 ||
+				static_cast< std::uint64_t >( count ) > std::numeric_limits< loaded_graph::vertex_type >::max() )
+			{
+				throw std::invalid_argument( "graph_loader: invalid number of nodes" );
+			}
+
+			return static_cast< std::size_t >( count );
+		}
+
+		inline const char*
+		line_end(
+			const char* const position,
+			const char* const last ) noexcept
+		{
+			const auto newline = static_cast< const char* >( std::memchr( position, '\n', static_cast< std::size_t >( last - position ) ) );
+
+			return newline == nullptr ? last : newline;
+		}
+
+		/**
+		 * Returns the start of the line following position.
+		 */
+		inline const char*
+		next_line(
+			const char* const position,
+			const char* const last ) noexcept
+		{
+			const auto end = line_end( position, last );
+
+			return end == last ? last : end + 1;
+		}
+	}
+
+	/**
+	 * Parses the text graph starting at first, returning the position past its
+	 * terminating line. Leaves the graph empty (0 vertices) if only blanks remain.
+	 * Throws std::invalid_argument on malformed data and std::out_of_range on an
+	 * edge whose vertices are not in [1, n].
+	 */
+	inline const char*
+	parse_text_graph(
+		const char* first,
+		const char* const last,
+		const std::size_t edge_fields,
+		thread_pool& pool,
+		loaded_graph& graph )
+	{
+		using namespace graph_loader_detail;
+
+		struct chunk_result
+		{
+			std::vector< loaded_graph::edge > edges;
+			line_kind stop = line_kind::edge;   // edge when the chunk has no terminating line
+			const char* stop_position = nullptr;
+		};
+
+		graph.vertices = 0;
+		graph.descriptions.clear();
+		graph.edges.clear();
+
+		// A count of 0 is skipped, as by the stream-based builders.
+		while ( graph.vertices == 0 )
+		{
+			while ( first != last && ( is_blank( *first ) || *first == '\n' ) )
+			{
+				++first;
+			}
+
+			if ( first == last )
+			{
+				return last;
+			}
+
+			std::int64_t count = 0;
+
+			if ( !parse_integer( first, last, count ) )
+			{
+				throw std::invalid_argument( "graph_loader: invalid number of nodes" );
+			}
+
+			graph.vertices = check_node_count( count );
+			first = next_line( first, last );
+		}
+
+		for ( std::size_t vertex = 0; vertex < graph.vertices; ++vertex )
+		{
+			const auto end = line_end( first, last );
+
+			if ( end == last )
+			{
+				throw std::invalid_argument( "graph_loader: invalid node data" );
+			}
+
+			graph.descriptions.emplace_back( first, end );
+			first = end + 1;
+		}
+
+		const auto chunks = 4 * ( pool.size() + 1 );
+		std::vector< chunk_result > results( chunks );
+		std::vector< const char* > boundaries( chunks + 1 );
+
+		for ( auto window = INITIAL_WINDOW; first != last; window *= 2 )
+		{
+			const auto window_last = next_line( first + std::min( window, static_cast< std::size_t >( last - first ) ) - 1, last );
+
+			// Split the window into chunks starting at line boundaries.
+			boundaries[ 0 ] = first;
+			boundaries[ chunks ] = window_last;
+
+			for ( std::size_t chunk = 1; chunk < chunks; ++chunk )
+			{
+				const auto split = first + ( window_last - first ) * chunk / chunks;
+
+				boundaries[ chunk ] = std::max( boundaries[ chunk - 1 ], split == first ? first : next_line( split - 1, window_last ) );
+			}
+
+			pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+			{
+				auto& result = results[ chunk ];
+				loaded_graph::edge output {};
+
+				result.edges.clear();
+				result.stop = line_kind::edge;
+
+				for ( auto line = boundaries[ chunk ]; line != boundaries[ chunk + 1 ]; )
+				{
+					const auto end = line_end( line, boundaries[ chunk + 1 ] );
+					const auto kind = parse_edge_line( line, end, edge_fields, graph.vertices, output );
+
+					line = ( end == boundaries[ chunk + 1 ] ) ? end : end + 1;
+
+					if ( kind == line_kind::edge )
+					{
+						result.edges.push_back( output );
+					}
+					else if ( kind != line_kind::blank )
+					{
+						result.stop = kind;
+						result.stop_position = line;
+						break;
+					}
+				}
+			}, 1 );
+
+			for ( const auto& result : results )
+			{
+				graph.edges.insert( std::end( graph.edges ), std::begin( result.edges ), std::end( result.edges ) );
+
+				if ( result.stop == line_kind::terminator )
+				{
+					return result.stop_position;
+				}
+				else if ( result.stop != line_kind::edge )
+				{
+					throw_line_error( result.stop );
+				}
+			}
+
+			first = window_last;
+		}
+
+		return last;
+	}
+
+	/**
+	 * Loads every graph of a text file, parsing edge_fields integers per edge line.
+	 */
+	inline std::vector< loaded_graph >
+	load_text_graphs(
+		const std::string& path,
+		const std::size_t edge_fields,
+		thread_pool& pool )
+	{
+		const mapped_file file( path );
+		const char* position = file.data();
+		const char* const last = file.data() + file.size();
+
+		std::vector< loaded_graph > graphs;
+
+		while ( position != last )
+		{
+			loaded_graph graph;
+			position = parse_text_graph( position, last, edge_fields, pool, graph );
+
+			if ( graph.vertices > 0 )
+			{
+				graphs.push_back( std::move( graph ) );
+			}
+		}
+
+		return graphs;
+	}
+
+	/**
+	 * Reads the next text graph from a stream, one line at a time, leaving the
+	 * stream past its terminating line. Returns false if the stream holds no
+	 * further graph; throws as parse_text_graph on malformed data. The parsing is
+	 * sequential: graphs stored in a file are read faster by load_text_graphs.
+	 */
+	inline bool
+	read_text_graph(
+		std::istream& input,
+		const std::size_t edge_fields,
+		loaded_graph& graph )
+	{
+		using namespace graph_loader_detail;
+
+		std::string line;
+
+		graph.vertices = 0;
+		graph.descriptions.clear();
+		graph.edges.clear();
+
+		while ( graph.vertices == 0 )
+		{
+			if ( !std::getline( input, line ) )
+			{
+				return false;
+			}
+
+			const char* position = line.data();
+			const char* const last = line.data() + line.size();
+			std::int64_t count = 0;
+
+			while ( position != last && is_blank( *position ) )
+			{
+				++position;
+			}
+
+			if ( position == last )
+			{
+				continue;
+			}
+
+			if ( !parse_integer( position, last, count ) )
+			{
+				throw std::invalid_argument( "graph_loader: invalid number of nodes" );
+			}
+
+			graph.vertices = check_node_count( count );
+		}
+
+		for ( std::size_t vertex = 0; vertex < graph.vertices; ++vertex )
+		{
+			if ( !std::getline( input, line ) || input.eof() )
+			{
+				throw std::invalid_argument( "graph_loader: invalid node data" );
+			}
+
+			graph.descriptions.push_back( line );
+		}
+
+		loaded_graph::edge output {};
+
+		while ( std::getline( input, line ) )
+		{
+			const auto kind = parse_edge_line( line.data(), line.data() + line.size(), edge_fields, graph.vertices, output );
+
+			if ( kind == line_kind::edge )
+			{
+				graph.edges.push_back( output );
+			}
+			else if ( kind == line_kind::terminator )
+			{
+				break;
+			}
+			else if ( kind != line_kind::blank )
+			{
+				throw_line_error( kind );
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Loads a binary edge list, decoding the edges in parallel.
+	 */
+	inline loaded_graph
+	load_binary_edge_list(
+		const std::string& path,
+		thread_pool& pool )
+	{
+		using namespace graph_loader_detail;
+
+		const mapped_file file( path );
+
+		std::uint64_t vertices = 0;
+		std::uint64_t edges = 0;
+
+		if ( file.size() < BINARY_HEADER_SIZE ||
+			std::memcmp( file.data(), BINARY_MAGIC, sizeof( BINARY_MAGIC ) ) != 0 )
+		{
+			throw std::invalid_argument( "graph_loader: not a binary edge list" );
+		}
+
+		std::memcpy( &vertices, file.data() + 8, sizeof( vertices ) );
+		std::memcpy( &edges, file.data() + 16, sizeof( edges ) );
+
+		if ( vertices > std::numeric_limits< loaded_graph::vertex_type >::max() ||
+			edges != ( file.size() - BINARY_HEADER_SIZE ) / BINARY_EDGE_SIZE ||
+			( file.size() - BINARY_HEADER_SIZE ) % BINARY_EDGE_SIZE != 0 )
+		{
+			throw std::invalid_argument( "graph_loader: truncated binary edge list" );
+		}
+
+		loaded_graph graph;
+		graph.vertices = static_cast< std::size_t >( vertices );
+		graph.edges.resize( static_cast< std::size_t >( edges ) );
+
+		const auto chunks = 4 * ( pool.size() + 1 );
+		std::vector< char > out_of_range( chunks, false );
+
+		pool.parallel_for( 0, chunks, [&]( const std::size_t chunk )
+		{
+			for ( auto index = graph.edges.size() * chunk / chunks; index < graph.edges.size() * ( chunk + 1 ) / chunks; ++index )
+			{
+				const char* const record = file.data() + BINARY_HEADER_SIZE + index * BINARY_EDGE_SIZE;
+				auto& output = graph.edges[ index ];
+
+				std::memcpy( &output.source, record, 4 );
+				std::memcpy( &output.target, record + 4, 4 );
+				std::memcpy( &output.weight, record + 8, 4 );
+
+				if ( output.source >= vertices || output.target >= vertices )
+				{
+					out_of_range[ chunk ] = true;
+				}
+			}
+		}, 1 );
+
+		if ( std::find( std::begin( out_of_range ), std::end( out_of_range ), true ) != std::end( out_of_range ) )
+		{
+			throw std::out_of_range( "graph_loader: edge vertex out of range" );
+		}
+
+		return graph;
+	}
+
+	/**
+	 * Saves the vertex count and edges of a graph as a binary edge list.
+	 */
+	inline void
+	save_binary_edge_list(
+		const std::string& path,
+		const loaded_graph& graph )
+	{
+		using namespace graph_loader_detail;
+
+		std::ofstream output( path, std::ios::out | std::ios::binary | std::ios::trunc );
+
+		const std::uint64_t vertices = graph.vertices;
+		const std::uint64_t edges = graph.edges.size();
+		std::vector< char > buffer( BINARY_HEADER_SIZE + graph.edges.size() * BINARY_EDGE_SIZE );
+
+		std::memcpy( buffer.data(), BINARY_MAGIC, sizeof( BINARY_MAGIC ) );
+		std::memcpy( buffer.data() + 8, &vertices, sizeof( vertices ) );
+		std::memcpy( buffer.data() + 16, &edges, sizeof( edges ) );
+
+		for ( std::size_t index = 0; index < graph.edges.size(); ++index )
+		{
+			char* const record = buffer.data() + BINARY_HEADER_SIZE + index * BINARY_EDGE_SIZE;
+
+			std::memcpy( record, &graph.edges[ index ].source, 4 );
+			std::memcpy( record + 4, &graph.edges[ index ].target, 4 );
+			std::memcpy( record + 8, &graph.edges[ index ].weight, 4 );
+		}
+
+		output.write( buffer.data(), static_cast< std::streamsize >( buffer.size() ) );
+
+		if ( !output )
+		{
+			throw std::invalid_argument( "graph_loader: cannot write " + path );
+		}
+	}
+}
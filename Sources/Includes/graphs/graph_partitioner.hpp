@@ -0,0 +1,648 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Multilevel k-way graph partitioning
+ * (Karypis, Kumar - "Multilevel k-way Partitioning Scheme for Irregular Graphs").
+ *
+ * The graph is taken as undirected, an edge weighing the number of directed
+ * edges between its endpoints. It is coarsened by collapsing heavy-edge
+ * matchings until a few vertices per part remain, each coarse vertex weighing
+ * the vertices it stands for. The coarsest graph is cut into parts of equal
+ * weight by recursive bisection, growing each half from a seed vertex (greedy
+ * graph growing). The partition is then projected back one level at a time,
+ * and refined at every level by moving the boundary vertices to the
+ * neighboring part they are most connected to, while keeping the parts within
+ * the allowed imbalance.
+ *
+ * partition_ordering() then labels the vertices part by part, so that once the
+ * graph is relabeled (see vertex_ordering.hpp) each part is a contiguous range
+ * of vertices that a thread can own.
+ *
+ * The graph exposes vertex_count() and neighbors( vertex ) (such as csr_graph).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Vertex >
+	struct graph_partition
+	{
+		// Number of parts.
+		std::size_t count = 0;
+
+		// Part of every vertex, from 0 to count - 1.
+		std::vector< Vertex > parts;
+
+		// Number of vertices in every part.
+		std::vector< std::size_t > sizes;
+
+		// Number of edges between vertices of different parts.
+		std::size_t cut = 0;
+	};
+
+	namespace graph_partitioner_detail
+	{
+		/**
+		 * Undirected weighted graph of one coarsening level.
+		 */
+		template < typename Vertex >
+		struct partition_level
+		{
+			std::vector< std::size_t > offsets;
+			std::vector< Vertex > targets;
+			std::vector< std::size_t > edge_weights;
+			std::vector< std::size_t > vertex_weights;
+
+			// Vertex of the next (coarser) level standing for every vertex.
+			std::vector< Vertex > coarse;
+
+			std::size_t
+			vertex_count() const noexcept
+			{
+				return this->vertex_weights.size();
+			}
+		};
+
+		/**
+		 * Merges the edges of every vertex of a level given as unmerged adjacency lists,
+		 * summing the weights of parallel edges and dropping self-loops.
+		 */
+		template < typename Vertex >
+		void
+		merge_edges( partition_level< Vertex >& level )
+		{
+			const auto vertices = level.vertex_count();
+
+			std::vector< std::size_t > positions( vertices, SIZE_MAX );
+			std::size_t merged = 0;
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				const auto first = merged;
+
+				for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+				{
+					const auto target = level.targets[ edge ];
+
+					if ( target == vertex )
+					{
+						continue;
+					}
+
+					if ( positions[ target ] == SIZE_MAX || positions[ target ] < first )
+					{
+						positions[ target ] = merged;
+						level.targets[ merged ] = target;
+						level.edge_weights[ merged++ ] = level.edge_weights[ edge ];
+					}
+					else
+					{
+						level.edge_weights[ positions[ target ] ] += level.edge_weights[ edge ];
+					}
+				}
+
+				level.offsets[ vertex ] = first;
+			}
+
+			level.offsets[ vertices ] = merged;
+			level.targets.resize( merged );
+			level.edge_weights.resize( merged );
+		}
+
+		/**
+		 * Builds the first level: the graph with every edge taken both ways.
+		 */
+		template < typename Graph >
+		partition_level< typename Graph::vertex_type >
+		symmetric_level( const Graph& graph )
+		{
+			using vertex_type = typename Graph::vertex_type;
+
+			const auto vertices = graph.vertex_count();
+
+			partition_level< vertex_type > level;
+			level.offsets.assign( vertices + 1, 0 );
+			level.vertex_weights.assign( vertices, 1 );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				for ( const auto target : graph.neighbors( static_cast< vertex_type >( vertex ) ) )
+				{
+					++level.offsets[ vertex + 1 ];
+					++level.offsets[ target + 1 ];
+				}
+			}
+
+			std::partial_sum( std::begin( level.offsets ), std::end( level.offsets ), std::begin( level.offsets ) );
+
+			level.targets.resize( level.offsets.back() );
+			level.edge_weights.assign( level.offsets.back(), 1 );
+
+			std::vector< std::size_t > cursors( std::begin( level.offsets ), std::prev( std::end( level.offsets ) ) );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				for ( const auto target : graph.neighbors( static_cast< vertex_type >( vertex ) ) )
+				{
+					level.targets[ cursors[ vertex ]++ ] = target;
+					level.targets[ cursors[ target ]++ ] = static_cast< vertex_type >( vertex );
+				}
+			}
+
+			merge_edges( level );
+
+			return level;
+		}
+
+		/**
+		 * Matches every vertex with its unmatched neighbor of heaviest edge (visiting
+		 * the vertices in random order), fills level.coarse and returns the coarser level.
+		 */
+		template < typename Vertex >
+		partition_level< Vertex >
+		coarsen(
+			partition_level< Vertex >& level,
+			const std::size_t heaviest_vertex,
+			std::mt19937& engine )
+		{
+			constexpr auto unmatched = static_cast< std::size_t >( -1 );
+
+			const auto vertices = level.vertex_count();
+
+			std::vector< Vertex > order( vertices );
+			std::iota( std::begin( order ), std::end( order ), Vertex { 0 } );
+			std::shuffle( std::begin( order ), std::end( order ), engine );
+
+			std::vector< std::size_t > matches( vertices, unmatched );
+
+			for ( const auto vertex : order )
+			{
+				if ( matches[ vertex ] != unmatched )
+				{
+					continue;
+				}
+
+				auto match = static_cast< std::size_t >( vertex );
+				std::size_t heaviest_edge = 0;
+
+				for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+				{
+					const auto target = level.targets[ edge ];
+
+					if ( matches[ target ] == unmatched &&
+						level.edge_weights[ edge ] > heaviest_edge &&
+						level.vertex_weights[ vertex ] + level.vertex_weights[ target ] <= heaviest_vertex )
+					{
+						match = target;
+						heaviest_edge = level.edge_weights[ edge ];
+					}
+				}
+
+				matches[ vertex ] = match;
+				matches[ match ] = vertex;
+			}
+
+			// Number the coarse vertices, a matched pair after its lower vertex.
+			partition_level< Vertex > coarser;
+			level.coarse.resize( vertices );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				if ( matches[ vertex ] >= vertex )
+				{
+					level.coarse[ vertex ] = static_cast< Vertex >( coarser.vertex_weights.size() );
+					coarser.vertex_weights.push_back( level.vertex_weights[ vertex ] +
+						( matches[ vertex ] != vertex ? level.vertex_weights[ matches[ vertex ] ] : 0 ) );
+				}
+				else
+				{
+					level.coarse[ vertex ] = level.coarse[ matches[ vertex ] ];
+				}
+			}
+
+			coarser.offsets.assign( coarser.vertex_count() + 1, 0 );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				coarser.offsets[ level.coarse[ vertex ] + 1 ] += level.offsets[ vertex + 1 ] - level.offsets[ vertex ];
+			}
+
+			std::partial_sum( std::begin( coarser.offsets ), std::end( coarser.offsets ), std::begin( coarser.offsets ) );
+
+			coarser.targets.resize( coarser.offsets.back() );
+			coarser.edge_weights.resize( coarser.offsets.back() );
+
+			std::vector< std::size_t > cursors( std::begin( coarser.offsets ), std::prev( std::end( coarser.offsets ) ) );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				auto& cursor = cursors[ level.coarse[ vertex ] ];
+
+				for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+				{
+					coarser.targets[ cursor ] = level.coarse[ level.targets[ edge ] ];
+					coarser.edge_weights[ cursor++ ] = level.edge_weights[ edge ];
+				}
+			}
+
+			merge_edges( coarser );
+
+			return coarser;
+		}
+
+		/**
+		 * Splits the vertices of subset into the count parts from first_part on, by
+		 * recursive bisection. Each half is grown from a random seed, adding the vertex
+		 * that most reduces the cut, until it reaches its share of the weight; the
+		 * best of a few seeds is kept.
+		 */
+		template < typename Vertex >
+		void
+		bisect_parts(
+			const partition_level< Vertex >& level,
+			const std::vector< Vertex >& subset,
+			const std::size_t first_part,
+			const std::size_t count,
+			std::mt19937& engine,
+			std::vector< Vertex >& parts )
+		{
+			using gain_entry = std::pair< std::ptrdiff_t, Vertex >;
+
+			constexpr std::size_t SEEDS = 4;
+
+			if ( count == 1 || subset.empty() )
+			{
+				for ( const auto vertex : subset )
+				{
+					parts[ vertex ] = static_cast< Vertex >( first_part );
+				}
+
+				return;
+			}
+
+			const auto vertices = level.vertex_count();
+			const auto left_count = count / 2;
+
+			std::size_t total = 0;
+			std::vector< bool > members( vertices, false );
+
+			for ( const auto vertex : subset )
+			{
+				total += level.vertex_weights[ vertex ];
+				members[ vertex ] = true;
+			}
+
+			const auto target = total * left_count / count;
+
+			std::vector< bool > region( vertices, false );
+			std::vector< bool > best_region;
+			auto best_cut = std::numeric_limits< std::size_t >::max();
+			std::vector< std::ptrdiff_t > gains( vertices, 0 );
+
+			for ( std::size_t seed = 0; seed < SEEDS; ++seed )
+			{
+				// Gain of a vertex: its edges to the region minus the others.
+				for ( const auto vertex : subset )
+				{
+					region[ vertex ] = false;
+					gains[ vertex ] = 0;
+
+					for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+					{
+						if ( members[ level.targets[ edge ] ] )
+						{
+							gains[ vertex ] -= static_cast< std::ptrdiff_t >( level.edge_weights[ edge ] );
+						}
+					}
+				}
+
+				std::priority_queue< gain_entry > heap;
+				std::size_t weight = 0;
+				std::size_t next = 0;
+
+				const auto root = subset[ engine() % subset.size() ];
+
+				heap.emplace( gains[ root ], root );
+
+				while ( weight < target )
+				{
+					if ( heap.empty() )
+					{
+						// Disconnected subset: start again from the next vertex left out.
+						while ( region[ subset[ next ] ] )
+						{
+							++next;
+						}
+
+						heap.emplace( gains[ subset[ next ] ], subset[ next ] );
+					}
+
+					const auto top = heap.top();
+					const auto vertex = top.second;
+
+					heap.pop();
+
+					if ( region[ vertex ] || top.first != gains[ vertex ] )
+					{
+						// Outdated entry.
+						continue;
+					}
+
+					if ( weight + level.vertex_weights[ vertex ] > 2 * target - weight )
+					{
+						break;
+					}
+
+					region[ vertex ] = true;
+					weight += level.vertex_weights[ vertex ];
+
+					for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+					{
+						const auto neighbor = level.targets[ edge ];
+
+						if ( members[ neighbor ] && !region[ neighbor ] )
+						{
+							gains[ neighbor ] += 2 * static_cast< std::ptrdiff_t >( level.edge_weights[ edge ] );
+							heap.emplace( gains[ neighbor ], neighbor );
+						}
+					}
+				}
+
+				std::size_t cut = 0;
+
+				for ( const auto vertex : subset )
+				{
+					if ( region[ vertex ] )
+					{
+						for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+						{
+							if ( members[ level.targets[ edge ] ] && !region[ level.targets[ edge ] ] )
+							{
+								cut += level.edge_weights[ edge ];
+							}
+						}
+					}
+				}
+
+				if ( cut < best_cut )
+				{
+					best_cut = cut;
+					best_region = region;
+				}
+			}
+
+			std::vector< Vertex > left;
+			std::vector< Vertex > right;
+
+			for ( const auto vertex : subset )
+			{
+				( best_region[ vertex ] ? left : right ).push_back( vertex );
+			}
+
+			bisect_parts( level, left, first_part, left_count, engine, parts );
+			bisect_parts( level, right, first_part + left_count, count - left_count, engine, parts );
+		}
+
+		/**
+		 * Moves the vertices to the neighboring part they are most connected to as long
+		 * as the cut shrinks (or stays, in favor of the lighter part). The vertices of a
+		 * part heavier than heaviest_part are moved out regardless of the cut, to the
+		 * best part with room, or else to the lightest part.
+		 */
+		template < typename Vertex >
+		void
+		refine_parts(
+			const partition_level< Vertex >& level,
+			const std::size_t count,
+			const std::size_t heaviest_part,
+			const std::size_t passes,
+			std::vector< Vertex >& parts )
+		{
+			const auto vertices = level.vertex_count();
+
+			std::vector< std::size_t > weights( count, 0 );
+			std::vector< std::size_t > connections( count, 0 );
+			std::vector< Vertex > touched;
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				weights[ parts[ vertex ] ] += level.vertex_weights[ vertex ];
+			}
+
+			for ( std::size_t pass = 0; pass < passes; ++pass )
+			{
+				std::size_t moves = 0;
+
+				for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+				{
+					const auto own = parts[ vertex ];
+					const auto vertex_weight = level.vertex_weights[ vertex ];
+					const auto overweight = weights[ own ] > heaviest_part;
+
+					for ( auto edge = level.offsets[ vertex ]; edge < level.offsets[ vertex + 1 ]; ++edge )
+					{
+						const auto part = parts[ level.targets[ edge ] ];
+
+						if ( connections[ part ] == 0 )
+						{
+							touched.push_back( part );
+						}
+
+						connections[ part ] += level.edge_weights[ edge ];
+					}
+
+					auto best = own;
+
+					for ( const auto part : touched )
+					{
+						if ( part == own || weights[ part ] + vertex_weight > heaviest_part )
+						{
+							continue;
+						}
+
+						if ( best == own )
+						{
+							if ( overweight ||
+								connections[ part ] > connections[ own ] ||
+								( connections[ part ] == connections[ own ] && weights[ part ] + vertex_weight < weights[ own ] ) )
+							{
+								best = part;
+							}
+						}
+						else if ( connections[ part ] > connections[ best ] ||
+							( connections[ part ] == connections[ best ] && weights[ part ] < weights[ best ] ) )
+						{
+							best = part;
+						}
+					}
+
+					if ( overweight && best == own )
+					{
+						const auto lightest = static_cast< Vertex >( std::min_element( std::begin( weights ), std::end( weights ) ) - std::begin( weights ) );
+
+						if ( weights[ lightest ] + vertex_weight <= heaviest_part )
+						{
+							best = lightest;
+						}
+					}
+
+					for ( const auto part : touched )
+					{
+						connections[ part ] = 0;
+					}
+
+					touched.clear();
+
+					if ( best != own )
+					{
+						weights[ own ] -= vertex_weight;
+						weights[ best ] += vertex_weight;
+						parts[ vertex ] = best;
+						++moves;
+					}
+				}
+
+				if ( moves == 0 )
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Splits the vertices into count parts, none heavier than (1 + imbalance) times
+	 * the average, with few edges between the parts.
+	 */
+	template < typename Graph >
+	graph_partition< typename Graph::vertex_type >
+	partition_graph(
+		const Graph& graph,
+		const std::size_t count,
+		const double imbalance = 0.03 )
+	{
+		using namespace graph_partitioner_detail;
+
+		using vertex_type = typename Graph::vertex_type;
+
+		constexpr std::size_t COARSEST_VERTICES_PER_PART = 20;
+		constexpr std::size_t REFINEMENT_PASSES = 8;
+		constexpr double MINIMUM_SHRINK = 0.95;
+
+		if ( count == 0 )
+		{
+			throw std::invalid_argument( "partition_graph: no parts" );
+		}
+
+		if ( imbalance < 0 )
+		{
+			throw std::invalid_argument( "partition_graph: negative imbalance" );
+		}
+
+		const auto vertices = graph.vertex_count();
+		const auto coarsest = std::max< std::size_t >( COARSEST_VERTICES_PER_PART * count, 1 );
+		const auto heaviest_part = static_cast< std::size_t >( std::ceil( static_cast< double >( vertices ) / count * ( 1 + imbalance ) ) );
+
+		// Coarse vertices may not outweigh 1.5 times the average coarsest vertex.
+		const auto heaviest_vertex = std::max< std::size_t >( 1, 3 * vertices / ( 2 * coarsest ) );
+
+		std::mt19937 engine( 1 );
+		std::vector< partition_level< vertex_type > > levels;
+
+		levels.push_back( symmetric_level( graph ) );
+
+		while ( levels.back().vertex_count() > coarsest )
+		{
+			auto coarser = coarsen( levels.back(), heaviest_vertex, engine );
+
+			if ( coarser.vertex_count() > MINIMUM_SHRINK * levels.back().vertex_count() )
+			{
+				levels.back().coarse.clear();
+				break;
+			}
+
+			levels.push_back( std::move( coarser ) );
+		}
+
+		std::vector< vertex_type > coarsest_vertices( levels.back().vertex_count() );
+		std::vector< vertex_type > parts( levels.back().vertex_count() );
+
+		std::iota( std::begin( coarsest_vertices ), std::end( coarsest_vertices ), vertex_type { 0 } );
+		bisect_parts( levels.back(), coarsest_vertices, 0, count, engine, parts );
+
+		refine_parts( levels.back(), count, heaviest_part, REFINEMENT_PASSES, parts );
+
+		for ( auto level = levels.size() - 1; level > 0; --level )
+		{
+			const auto& finer = levels[ level - 1 ];
+			std::vector< vertex_type > finer_parts( finer.vertex_count() );
+
+			for ( std::size_t vertex = 0; vertex < finer.vertex_count(); ++vertex )
+			{
+				finer_parts[ vertex ] = parts[ finer.coarse[ vertex ] ];
+			}
+
+			parts = std::move( finer_parts );
+			levels.pop_back();
+
+			refine_parts( levels.back(), count, heaviest_part, REFINEMENT_PASSES, parts );
+		}
+
+		graph_partition< vertex_type > partition;
+		partition.count = count;
+		partition.sizes.assign( count, 0 );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			++partition.sizes[ parts[ vertex ] ];
+
+			for ( const auto target : graph.neighbors( static_cast< vertex_type >( vertex ) ) )
+			{
+				partition.cut += parts[ vertex ] != parts[ target ] ? 1 : 0;
+			}
+		}
+
+		partition.parts = std::move( parts );
+
+		return partition;
+	}
+
+	/**
+	 * Labels the vertices part by part (keeping their order within a part), so that
+	 * part p holds the labels from sizes[ 0 ] + ... + sizes[ p - 1 ] on.
+	 */
+	template < typename Vertex >
+	std::vector< Vertex >
+	partition_ordering( const graph_partition< Vertex >& partition )
+	{
+		std::vector< std::size_t > firsts( partition.count, 0 );
+
+		for ( std::size_t part = 1; part < partition.count; ++part )
+		{
+			firsts[ part ] = firsts[ part - 1 ] + partition.sizes[ part - 1 ];
+		}
+
+		std::vector< Vertex > labels( partition.parts.size() );
+
+		for ( std::size_t vertex = 0; vertex < partition.parts.size(); ++vertex )
+		{
+			labels[ vertex ] = static_cast< Vertex >( firsts[ partition.parts[ vertex ] ]++ );
+		}
+
+		return labels;
+	}
+}
@@ -6,9 +6,13 @@
  */
 
 #include "graphl.hpp"
+#include "graph_loader.hpp"
 
+#include <algorithm>
+#include <limits.h>
 #include <sstream>
 #include <iostream>
+#include <utility>
 
 namespace dsa
 {
@@ -16,6 +20,9 @@ namespace dsa
     const int DATA_INDENT = 15;     // indentation of node data
     const int EDGE_INDENT = 2;      // indentation of edge info
 
+    // Data file layout
+    const int EDGE_FIELDS = 2;      // integers per edge line
+
     // ---------------------------------------------------------------------------
     // Default constructor for class GraphL
     GraphL::GraphL()
@@ -46,12 +53,24 @@ namespace dsa
         return size;
     }
 
+    // ---------------------------------------------------------------------------
+    // findNode
+    // Returns the node described by "name", or 0 if there is none. When several
+    // nodes share a description, the first of them is returned. The lookup is
+    // a hash probe in the dictionary of the descriptions built by buildGraph.
+    int GraphL::findNode(const std::string& name) const
+    {
+        vertex_dictionary<>::id_type id = names.find(name);
+
+        return (id == vertex_dictionary<>::npos) ? 0 : namedNode[id];
+    }
+
     // ---------------------------------------------------------------------------
     // makeEmpty
-    // Clears the Graph data.
+    // Clears the Graph data and releases its memory.
     void GraphL::makeEmpty()
     {
-        for (int i = 0; i < size; i++)
+        for (std::size_t i = 0; i < node.size(); i++)
         {
             EdgeNode* edge = node[i].edgeHead;
             while (edge != nullptr)
@@ -60,10 +79,12 @@ namespace dsa
                 delete edge;
                 edge = temp;
             }
-            node[i].edgeHead = nullptr;
         }
+        node.clear();
+        dfsPath.clear();
         size = 0;
-        dfsSize = 0;
+        names = vertex_dictionary<>();
+        namedNode.clear();
     }
 
     //---------------------------------------------------------------------------
@@ -168,80 +189,35 @@ namespace dsa
     // buildGraph
     // Populates the Graph with data from an input stream.
     // Stream data is assumed to be organized as follows:
-    //      First line has an integer telling the number of nodes, say n.
-    //      Following is a text description of each of the 1 through n nodes.
-    //      After that, each line consists of 2 integer representing an edge.
+    //      First line has an integer telling the number of nodes, say n.
+    //      Following is a text description of each of the 1 through n nodes.
+    //      After that, each line consists of 2 integer representing an edge.
     //          {fromNode toNode}
-    //      A zero for any of the integers signifies the end of the data for
-    //      that one graph.
-    // A graph has at most 100 nodes.
+    //      A zero for any of the integers signifies the end of the data for
+    //      that one graph.
+    // The data is parsed by read_text_graph, which leaves the stream past the
+    // end of the graph, then handed over to the bulk buildGraph. The stream is
+    // read sequentially, one line at a time: for a data file, loadGraphs maps
+    // the file and parses the edges in parallel.
     void GraphL::buildGraph( std::istream& infile)
     {
-        int noNodes = 0;            // number of nodes
-        bool done = false;          // whether data read is complete
-        std::string error;               // error info (if any)
+        loaded_graph graph;         // graph data read from the stream
+        std::string error;          // error info (if any)
 
         makeEmpty();                // clear the graph of memory
 
-        while (!done && infile.good())
+        try
         {
-            if (noNodes == 0)
-            {
-                infile >> noNodes;  // read the number of nodes
-                if (!infile.eof())
-                {
-                    std::string s;       // used to read through to end of line
-                    getline(infile, s);
-                }
-            }
-            else if ((noNodes < 0) || (noNodes > MAXNODES))
-            {
-                // invalid number of nodes: bail out
-                error = "Invalid number of nodes!";
-                done = true;
-            }
-            else if (size < noNodes)
+            if (read_text_graph(infile, EDGE_FIELDS, graph) &&
+                !buildGraph(graph))
             {
-                // read graph node information
-                if (node[size].data.setData(infile))
-                {
-                    size++;
-                }
-                else
-                {
-                    // error
-                    error = "Invalid node data!";
-                    done = true;
-                }
-            }
-            else
-            {
-                int fromNode = 0, toNode = 0;
-
-                // read the edge data and add to the adjacency list
-                infile >> fromNode;
-                infile >> toNode;
-                if ((fromNode == 0) || (toNode == 0))
-                {
-                    // end of edge data
-                    done = true;
-                }
-                else if (!insertEdge(fromNode, toNode))
-                {
-                    // error
-                    error = "Invalid edge data!";
-                    done = true;
-                }
-                else
-                {
-                    if (!infile.eof())
-                    {
-                        std::string s;       // used to read through to end of line
-                        getline(infile, s);
-                    }
-                }
+                error = "Invalid edge data!";
             }
         }
+        catch (const std::exception& exception)
+        {
+            error = exception.what();
+        }
 
         if (!error.empty())
         {
@@ -252,25 +228,119 @@ namespace dsa
         }
     }
 
+    //---------------------------------------------------------------------------
+    // buildGraph
+    // Populates the Graph with a loaded graph (see graph_loader.hpp), e.g. one
+    // of the graphs returned by load_text_graphs or load_binary_edge_list.
+    // Instead of inserting the edges one at a time (a walk of the edge list
+    // each), the edges are grouped by node with a counting sort, the targets
+    // of each node sorted, and the edge lists linked in one pass.
+    // Returns true if all the edges are valid (no self-loop nor duplicate
+    // edge); otherwise, the Graph is left empty. The storage is sized to the
+    // number of nodes.
+    bool GraphL::buildGraph(const loaded_graph& graph)
+    {
+        makeEmpty();                // clear the graph of memory
+
+        if (graph.vertices > static_cast<std::size_t>(INT_MAX))
+        {
+            return false;
+        }
+
+        for (const loaded_graph::edge& edge : graph.edges)
+        {
+            if ((edge.source >= graph.vertices) ||
+                (edge.target >= graph.vertices) ||
+                (edge.source == edge.target))
+            {
+                return false;
+            }
+        }
+
+        int nodes = static_cast<int>(graph.vertices);
+        csr_graph<> edges(graph.vertices, graph.edges, false);
+        std::vector<csr_graph<>::vertex_type> targets;
+
+        resizeGraph(nodes);
+        size = nodes;
+        for (int start = 0; start < nodes; start++)
+        {
+            if (static_cast<std::size_t>(start) < graph.descriptions.size())
+            {
+                node[start].data = NodeData(graph.descriptions[start]);
+                nameNode(start, graph.descriptions[start]);
+            }
+
+            auto neighbors = edges.neighbors(start);
+
+            targets.assign(neighbors.begin(), neighbors.end());
+            std::sort(targets.begin(), targets.end());
+            if (std::adjacent_find(targets.begin(), targets.end()) !=
+                targets.end())
+            {
+                // edge already exists
+                makeEmpty();        // reset data (as it is invalid)
+                return false;
+            }
+
+            // Link the edges from the last, so the list is in ascending order
+            for (std::size_t i = targets.size(); i > 0; i--)
+            {
+                EdgeNode* edge = new EdgeNode;
+                edge->adjGraphNode = static_cast<int>(targets[i - 1]);
+                edge->nextEdge = node[start].edgeHead;
+                node[start].edgeHead = edge;
+            }
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------
+    // loadGraphs
+    // Reads all the graphs of a data file, organized as for buildGraph, with
+    // load_text_graphs: the file is memory-mapped and the edges are parsed in
+    // parallel. Each of them can then be handed over to the bulk buildGraph.
+    // Throws std::invalid_argument if the file cannot be read or its data is
+    // malformed.
+    std::vector<loaded_graph> GraphL::loadGraphs(const std::string& path)
+    {
+        thread_pool pool;
+
+        return load_text_graphs(path, EDGE_FIELDS, pool);
+    }
+
     //---------------------------------------------------------------------------
     // depthFirstSearch
-    // Rebuilds the Depth-First Search path
+    // Rebuilds the Depth-First Search path, starting from the first node.
+    // The search runs iteratively over a frozen (CSR) copy of the Graph, so
+    // long paths cannot overflow the call stack.
     void GraphL::depthFirstSearch()
     {
         if (size > 0)
         {
-            clearDFS();     // clear previous data
-            dfs(0);         // perform DFS
+            csr_graph<> graph = freeze();
+            depth_first_search<csr_graph<> > search(graph);
+
+            dfsPath.clear();    // clear previous data
+            dfsPath.reserve(size);
+            search.visit(0,
+                [this](csr_graph<>::vertex_type vertex)
+                {
+                    dfsPath.push_back(vertex);
+                },
+                [](csr_graph<>::vertex_type)
+                {
+                });
 
             //  Display result
             std::cout << "Depth - first ordering:";
-            if (dfsSize != size)
+            if (static_cast<int>(dfsPath.size()) != size)
             {
                 std::cout << " search failed!";
             }
             else
             {
-                for (int i = 0; i < dfsSize; i++)
+                for (std::size_t i = 0; i < dfsPath.size(); i++)
                 {
                     std::cout << " " << (dfsPath[i] + 1);
                 }
@@ -280,6 +350,31 @@ namespace dsa
         }
     }
 
+    //---------------------------------------------------------------------------
+    // freeze
+    // Returns a compact (CSR) copy of the Graph edges, in which the edges of
+    // each node are stored contiguously, for fast traversals. The edge lists
+    // are already grouped by node and sorted, so the arrays are filled in a
+    // single pass.
+    // Note: the CSR graph uses the 0-based internal indexing scheme.
+    csr_graph<> GraphL::freeze() const
+    {
+        std::vector<csr_graph<>::offset_type> offsets(size + 1, 0);
+        std::vector<csr_graph<>::vertex_type> targets;
+
+        for (int i = 0; i < size; i++)
+        {
+            for (EdgeNode* edge = node[i].edgeHead; edge != nullptr;
+                 edge = edge->nextEdge)
+            {
+                targets.push_back(edge->adjGraphNode);
+            }
+            offsets[i + 1] = targets.size();
+        }
+
+        return csr_graph<>(std::move(offsets), std::move(targets));
+    }
+
     //---------------------------------------------------------------------------
     // displayGraph
     // Displays the Graph info including the data for nodes and edges.
@@ -323,44 +418,30 @@ namespace dsa
     void GraphL::initGraph()
     {
         size = 0;
-        dfsSize = 0;
-        for (int i = 0; i < MAXNODES; i++)
-        {
-            node[i].edgeHead = nullptr;
-            node[i].visited = false;
-            dfsPath[i] = -1;
-        }
     }
 
-    //---------------------------------------------------------------------------
-    // clearDFS
-    // Helper method used to clear the Depth-First Search data
-    void GraphL::clearDFS()
+    // ---------------------------------------------------------------------------
+    // resizeGraph
+    // Helper method that allocates the storage for a number of nodes, without
+    // any edge between them.
+    void GraphL::resizeGraph(int nodes)
     {
-        for (int i = 0; i < size; i++)
-        {
-            node[i].visited = false;
-            dfsPath[i] = -1;
-        }
-        dfsSize = 0;
+        GraphNode empty;
+
+        empty.edgeHead = nullptr;
+        node.resize(nodes, empty);
     }
 
-    //---------------------------------------------------------------------------
-    // clearDFS
-    // Helper method implementing Depth-First Search starting from a given node
-    void  GraphL::dfs(int fromNode)
+    // ---------------------------------------------------------------------------
+    // nameNode
+    // Helper method that indexes the description of a node (0-based) for
+    // findNode. Empty descriptions are not indexed, and a description shared
+    // by several nodes keeps naming the first of them.
+    void GraphL::nameNode(int index, const std::string& name)
     {
-        if ((fromNode >= 0) && (fromNode < size) && !node[fromNode].visited)
+        if (!name.empty() && (names.intern(name) == namedNode.size()))
         {
-            EdgeNode* edge = node[fromNode].edgeHead;
-
-            dfsPath[dfsSize++] = fromNode;
-            node[fromNode].visited = true;
-            while (edge != nullptr)
-            {
-                dfs(edge->adjGraphNode);
-                edge = edge->nextEdge;
-            }
+            namedNode.push_back(index + 1);
         }
     }
 
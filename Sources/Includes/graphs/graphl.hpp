@@ -4,10 +4,18 @@
 
 #pragma once
 
+#include "csr_graph.hpp"
+#include "depth_first_search.hpp"
 #include "node_data.hpp"
+#include "vertex_dictionary.hpp"
+
+#include <string>
+#include <vector>
 
 namespace dsa
 {
+    struct loaded_graph;
+
     //---------------------------------------------------------------------------
     // EdgeNode: ordered link list of edge information for Graph nodes
     // An edge is a directed connection between to nodes in the Graph.
@@ -23,16 +31,20 @@ namespace dsa
     {
         NodeData data;                  // graph node information
         EdgeNode* edgeHead;             // head of the linked list of edges
-        bool visited;                   // flag to mark a "visited" node
     };
 
     //---------------------------------------------------------------------------
     // GraphL class: implementation of a Graph holding nodes with data packaged
     // as NodeData objects and having directional edges. 
     // Features:
-    //  --  allows building the Graph with a stream of data
+    //  --  allows building the Graph with a stream of data or in bulk with
+    //      a loaded graph (see graph_loader.hpp); a stream is parsed one line
+    //      at a time, so the graphs of a data file are best read at once
+    //      with loadGraphs
+    //  --  allows finding a node by its description in constant time
     //  --  allows displaying the Graph info (including nodes data and edges)
     //  --  allows performing the depth-first traversal of the Graph
+    //  --  allows freezing the Graph into a compact (CSR) graph
     // Note: the public interface assumes a 1-based indexing of nodes while
     // the internal implementation uses a 0-based indexing scheme.
     //---------------------------------------------------------------------------
@@ -45,13 +57,17 @@ namespace dsa
         // Accessors
         bool isEmpty() const;
         int getSize() const;
+        int findNode(const std::string& name) const;
 
         // Graph operations
         void makeEmpty();
         bool insertEdge(int fromNode, int toNode);
         bool removeEdge(int fromNode, int toNode);
         void buildGraph( std::istream& infile);
+        bool buildGraph(const loaded_graph& graph);
+        static std::vector<loaded_graph> loadGraphs(const std::string& path);
         void depthFirstSearch();
+        csr_graph<> freeze() const;
 
         // Display operations
         void displayGraph() const;
@@ -59,18 +75,18 @@ namespace dsa
     private:
         // Helper methods
         void initGraph();
-        void clearDFS();
-        void dfs(int fromNode);
+        void resizeGraph(int nodes);
+        void nameNode(int index, const std::string& name);
 
         // Display helpers
         static void addIntToString( std::string &info, int value);
         static void padString( std::string &info, int length);
 
         // Data members
-        static const int MAXNODES = 100;    // max. number of graph nodes
-        GraphNode node[MAXNODES];           // Graph nodes
-        int dfsPath[MAXNODES];              // Depth-First Search path
+        std::vector<GraphNode> node;        // Graph nodes
+        std::vector<int> dfsPath;           // Depth-First Search path
         int size;                           // number of nodes in the graph
-        int dfsSize;                        // size of DFS path 
+        vertex_dictionary<> names;          // ids of the node descriptions
+        std::vector<int> namedNode;         // node (1-based) of each id
     };
 }
@@ -6,16 +6,24 @@
  */
 
 #include "graphm.hpp"
+#include "graph_loader.hpp"
+#include "../concurrency/thread_pool.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <limits.h>
+#include <queue>
+#include <tuple>
 #include <sstream>
 #include <iostream>
+#include <utility>
 
 namespace dsa
 {
     // Path cost range
     const int MIN_COST_PATH = 0;
     const int MAX_COST_PATH = INT_MAX;
+    const long long NO_PATH = LLONG_MAX;    // distance of unreached nodes
 
     // Graph display layout definitions (0-based, i.e. first column is 0).
     const int DESCRIPTION_LENGTH = 21;  // length of node data (padded)
@@ -24,6 +32,18 @@ namespace dsa
     const int DISTANCE_INDENT = 20;     // indentation of "Dijkstra's Distance"
     const int PATH_INDENT = 32;         // indentation of "Path" data
 
+    // Shortest path tuning
+    const int DENSE_GRAPH_RATIO = 16;   // Floyd-Warshall is used by default when
+                                        // at least 1 in 16 edges is present
+    const int FLOYD_WARSHALL_BLOCK = 64;// tile size (nodes) of Floyd-Warshall
+
+    // Data file layout
+    const int EDGE_FIELDS = 3;          // integers per edge line
+
+    // Function prototypes
+    void relaxTile(Matrix<int>& dist, Matrix<int>& hops, Matrix<int>& path,
+                   int fromBlock, int toBlock, int viaBlock);
+
     // ---------------------------------------------------------------------------
     // Default constructor for class GraphM
     GraphM::GraphM()
@@ -53,27 +73,38 @@ namespace dsa
         return size;
     }
 
+    // ---------------------------------------------------------------------------
+    // findNode
+    // Returns the node described by "name", or 0 if there is none. When several
+    // nodes share a description, the first of them is returned. The lookup is
+    // a hash probe in the dictionary of the descriptions built by buildGraph.
+    int GraphM::findNode(const std::string& name) const
+    {
+        vertex_dictionary<>::id_type id = names.find(name);
+
+        return (id == vertex_dictionary<>::npos) ? 0 : namedNode[id];
+    }
+
     // ---------------------------------------------------------------------------
     // makeEmpty
-    // Clears the Graph data.
+    // Clears the Graph data and releases its memory.
     void GraphM::makeEmpty()
     {
-        for (int fromNode = 0; fromNode < size; fromNode++)
-        {
-            for (int toNode = 0; toNode < size; toNode++)
-            {
-                C[fromNode][toNode] =
-                    (toNode == fromNode) ? MIN_COST_PATH : MAX_COST_PATH;
-            }
-        }
-        clearShortestPath();
+        data.clear();
+        C.clear();
+        T.clear();
+        shortestPath = false;
         size = 0;
+        names = vertex_dictionary<>();
+        namedNode.clear();
     }
 
     //---------------------------------------------------------------------------
     // insertEdge
     // Sets an edge (i.e. sets the value of the link connecting two vertices
     // within the Graph). Returns true if data is valid and the edge is modified.
+    // If the shortest paths were computed, only the paths affected by the new
+    // cost are repaired.
     // Note: the public interface assumes a 1-based indexing of nodes while
     // the internal implementation uses a 0-based indexing scheme.
     bool GraphM::insertEdge(int fromNode, int toNode, int label)
@@ -83,10 +114,19 @@ namespace dsa
             (toNode != fromNode) &&
             (label >= MIN_COST_PATH) && (label <= MAX_COST_PATH))
         {
-            if (C[fromNode - 1][toNode - 1] != label)
+            int previous = C[fromNode - 1][toNode - 1];
+
+            if (previous != label)
             {
                 C[fromNode - 1][toNode - 1] = label;
-                shortestPath = false;
+                if (shortestPath && (label < previous))
+                {
+                    shortenPaths(fromNode - 1, toNode - 1);
+                }
+                else if (shortestPath)
+                {
+                    lengthenPaths(fromNode - 1, toNode - 1);
+                }
                 return true;
             }
         }
@@ -97,6 +137,8 @@ namespace dsa
     // removeEdge
     // Resets an edge (i.e. removes the link connecting two vertices within the
     // Graph). Returns true if data is valid and the edge is reset.
+    // If the shortest paths were computed, only the paths which went through
+    // the edge are repaired.
     // Note: the public interface assumes a 1-based indexing of nodes while
     // the internal implementation uses a 0-based indexing scheme.
     bool GraphM::removeEdge(int fromNode, int toNode)
@@ -108,7 +150,10 @@ namespace dsa
             if (C[fromNode - 1][toNode - 1] != MAX_COST_PATH)
             {
                 C[fromNode - 1][toNode - 1] = MAX_COST_PATH;
-                shortestPath = false;
+                if (shortestPath)
+                {
+                    lengthenPaths(fromNode - 1, toNode - 1);
+                }
                 return true;
             }
         }
@@ -119,144 +164,310 @@ namespace dsa
     // buildGraph
     // Populates the Graph with data from an input stream.
     // Stream data is assumed to be organized as follows:
-    //      First line has an integer telling the number of nodes, say n.
-    //      Following is a text description of each of the 1 through n nodes.
-    //      After that, each line consists of 3 integers representing an edge.
+    //      First line has an integer telling the number of nodes, say n.
+    //      Following is a text description of each of the 1 through n nodes.
+    //      After that, each line consists of 3 integers representing an edge.
     //          {fromNode toNode label}
-    //      A zero for any of the node index integers signifies the end of the
-    //      data for that one graph.
-    // A graph has at most 100 nodes.
+    //      A zero for any of the node index integers signifies the end of the
+    //      data for that one graph.
+    // The data is parsed by read_text_graph, which leaves the stream past the
+    // end of the graph, then handed over to the bulk buildGraph. The stream is
+    // read sequentially, one line at a time: for a data file, loadGraphs maps
+    // the file and parses the edges in parallel.
     void GraphM::buildGraph( std::istream& infile)
     {
-        int noNodes = 0;            // number of nodes
-        bool done = false;          // whether data read is complete
-        std::string error;               // error info (if any)
+        loaded_graph graph;         // graph data read from the stream
+        std::string error;          // error info (if any)
 
         makeEmpty();                // clear the graph of memory
 
-        while (!done && infile.good())
+        try
         {
-            if (noNodes == 0)
+            if (read_text_graph(infile, EDGE_FIELDS, graph) &&
+                !buildGraph(graph))
             {
-                infile >> noNodes;  // read the number of nodes
-                if (!infile.eof())
-                {
-                    std::string s;       // used to read through to end of line
-                    std::getline(infile, s);
-                }
+                error = "Invalid edge data!";
+            }
+        }
+        catch (const std::exception& exception)
+        {
+            error = exception.what();
+        }
+
+        if (!error.empty())
+        {
+            std::cerr << error << std::endl;
+            makeEmpty();                    // reset data (as it is invalid)
+            infile.seekg(0, infile.end);    // move input stream to the end
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    // buildGraph
+    // Populates the Graph with a loaded graph (see graph_loader.hpp), e.g. one
+    // of the graphs returned by load_text_graphs or load_binary_edge_list.
+    // The edges are inserted in order, with the same checks as insertEdge.
+    // Returns true if all the edges are valid; otherwise, the Graph is left
+    // empty. The storage is sized to the number of nodes.
+    bool GraphM::buildGraph(const loaded_graph& graph)
+    {
+        makeEmpty();                // clear the graph of memory
+
+        if (graph.vertices > static_cast<std::size_t>(INT_MAX))
+        {
+            return false;
+        }
+
+        int nodes = static_cast<int>(graph.vertices);
+
+        resizeGraph(nodes);
+        size = nodes;
+        for (std::size_t node = 0; node < graph.descriptions.size() &&
+             node < graph.vertices; node++)
+        {
+            data[node] = NodeData(graph.descriptions[node]);
+            nameNode(static_cast<int>(node), graph.descriptions[node]);
+        }
+
+        for (const loaded_graph::edge& edge : graph.edges)
+        {
+            if ((edge.source >= graph.vertices) ||
+                (edge.target >= graph.vertices) ||
+                !insertEdge(static_cast<int>(edge.source) + 1,
+                            static_cast<int>(edge.target) + 1, edge.weight))
+            {
+                makeEmpty();        // reset data (as it is invalid)
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------
+    // loadGraphs
+    // Reads all the graphs of a data file, organized as for buildGraph, with
+    // load_text_graphs: the file is memory-mapped and the edges are parsed in
+    // parallel. Each of them can then be handed over to the bulk buildGraph.
+    // Throws std::invalid_argument if the file cannot be read or its data is
+    // malformed.
+    std::vector<loaded_graph> GraphM::loadGraphs(const std::string& path)
+    {
+        thread_pool pool;
+
+        return load_text_graphs(path, EDGE_FIELDS, pool);
+    }
+
+    //---------------------------------------------------------------------------
+    // findShortestPath
+    // Calculates the shortest path between any two vertices within the Graph,
+    // either by running Dijkstra's shortest path algorithm from every vertex
+    // (suited to sparse graphs) or by running Floyd-Warshall's algorithm
+    // (suited to dense graphs). SHORTEST_PATH_AUTO picks one based on the
+    // number of edges. The work is spread over all hardware threads.
+    void GraphM::findShortestPath(int algorithm)
+    {
+        clearShortestPath();        // Clear previous data (if any)
+
+        if (size > 0)
+        {
+            thread_pool pool;
+
+            if (algorithm == SHORTEST_PATH_AUTO)
+            {
+                algorithm = (countEdges() * DENSE_GRAPH_RATIO >=
+                             static_cast<long long>(size) * (size - 1)) ?
+                    SHORTEST_PATH_FLOYD_WARSHALL : SHORTEST_PATH_DIJKSTRA;
             }
-            else if ((noNodes < 0) || (noNodes > MAXNODES))
+
+            if (algorithm == SHORTEST_PATH_FLOYD_WARSHALL)
             {
-                // invalid number of nodes: bail out
-                error = "Invalid number of nodes!";
-                done = true;
+                findShortestPathFloydWarshall(pool);
             }
-            else if (size < noNodes)
+            else
             {
-                // read graph node information
-                if (data[size].setData(infile))
-                {
-                    size++;
-                }
-                else
+                findShortestPathDijkstra(pool);
+            }
+
+            shortestPath = true;
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    // findPath
+    // Finds the shortest path between two vertices within the Graph, without
+    // computing (nor using) the all-pairs shortest paths. Dijkstra's algorithm
+    // is run from both ends at once, forward from "fromNode" and backward
+    // (over the incoming edges) from "toNode", expanding the side with the
+    // nearest unsettled node. The search ends as soon as the two nearest
+    // unsettled nodes are together farther than the shortest path found where
+    // the frontiers met.
+    // Returns the nodes along the path (both ends included), or an empty path
+    // if the nodes are invalid, identical or not connected.
+    // Note: the public interface assumes a 1-based indexing of nodes while
+    // the internal implementation uses a 0-based indexing scheme.
+    std::vector<int> GraphM::findPath(int fromNode, int toNode) const
+    {
+        typedef std::pair<long long, int> HeapEntry;    // distance, node
+        typedef std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                                    std::greater<HeapEntry> > Heap;
+
+        if ((fromNode < 1) || (fromNode > size) ||
+            (toNode < 1) || (toNode > size) ||
+            (toNode == fromNode))
+        {
+            return std::vector<int>();
+        }
+
+        int start = fromNode - 1;
+        int end = toNode - 1;
+        std::vector<long long> dist[2] = {          // forward, backward
+            std::vector<long long>(size, NO_PATH),
+            std::vector<long long>(size, NO_PATH) };
+        std::vector<int> path[2] = {                // previous, next node
+            std::vector<int>(size, -1),
+            std::vector<int>(size, -1) };
+        std::vector<bool> settled[2] = {
+            std::vector<bool>(size, false),
+            std::vector<bool>(size, false) };
+        Heap heap[2];
+        long long best = NO_PATH;                   // shortest path found
+        int meetFrom = -1;                          // edge where the
+        int meetTo = -1;                            // frontiers met
+
+        dist[0][start] = MIN_COST_PATH;
+        dist[1][end] = MIN_COST_PATH;
+        heap[0].push(HeapEntry(MIN_COST_PATH, start));
+        heap[1].push(HeapEntry(MIN_COST_PATH, end));
+
+        while (true)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                // Outdated entries: nodes already reached with a lower cost
+                while (!heap[side].empty() &&
+                       settled[side][heap[side].top().second])
                 {
-                    // error
-                    error = "Invalid node data!";
-                    done = true;
+                    heap[side].pop();
                 }
             }
-            else
+
+            if (heap[0].empty() || heap[1].empty() ||
+                (heap[0].top().first + heap[1].top().first >= best))
+            {
+                break;
+            }
+
+            int side = (heap[0].top().first <= heap[1].top().first) ? 0 : 1;
+            int node = heap[side].top().second;
+            long long distance = heap[side].top().first;
+
+            heap[side].pop();
+            settled[side][node] = true;
+
+            for (int nextNode = 0; nextNode < size; nextNode++)
             {
-                int fromNode = 0, toNode = 0, label = 0;
+                int cost = (side == 0) ? C[node][nextNode] : C[nextNode][node];
 
-                // read the edge data and add to the adjacency list
-                infile >> fromNode;
-                infile >> toNode;
-                infile >> label;
-                if ((fromNode == 0) || (toNode == 0))
+                if ((nextNode == node) || (cost >= MAX_COST_PATH))
                 {
-                    // end of edge data
-                    done = true;
+                    continue;
                 }
-                else if (!insertEdge(fromNode, toNode, label))
+
+                if (distance + cost < dist[side][nextNode])
                 {
-                    // error
-                    error = "Invalid edge data!";
-                    done = true;
+                    // Update min. distance and record path
+                    dist[side][nextNode] = distance + cost;
+                    path[side][nextNode] = node;
+                    heap[side].push(HeapEntry(distance + cost, nextNode));
                 }
-                else
+
+                if ((dist[1 - side][nextNode] < NO_PATH) &&
+                    (distance + cost + dist[1 - side][nextNode] < best))
                 {
-                    if (!infile.eof())
-                    {
-                        std::string s;       // used to read through to end of line
-                        std::getline(infile, s);
-                    }
+                    // The frontiers meet on the edge to "nextNode"
+                    best = distance + cost + dist[1 - side][nextNode];
+                    meetFrom = (side == 0) ? node : nextNode;
+                    meetTo = (side == 0) ? nextNode : node;
                 }
             }
         }
-        if (!error.empty())
-        {
-            std::cerr << error << std::endl;
-            makeEmpty();                    // reset data (as it is invalid)
-            infile.seekg(0, infile.end);    // move input stream to the end
-        }
+
+        return (meetFrom >= 0) ?
+            tracePath(start, meetFrom, meetTo, path[0], path[1]) :
+            std::vector<int>();
     }
 
     //---------------------------------------------------------------------------
-    // findShortestPath
-    // Calculates the shortest path between any two vertices within the Graph
-    // by implementing Dijkstra's shortest path algorithm. 
-    void GraphM::findShortestPath()
+    // findPath
+    // Finds the shortest path between two vertices within the Graph with the
+    // A* algorithm, without computing (nor using) the all-pairs shortest paths.
+    // The nodes are visited in increasing order of their distance from
+    // "fromNode" plus the estimated cost from the node to "toNode" given by the
+    // heuristic (called with the 1-based index of the node), and the search
+    // ends when "toNode" is reached. The path is the shortest one as long as
+    // the heuristic never overestimates the remaining cost; nodes are visited
+    // again when a shorter path to them turns up, so that a heuristic which is
+    // not consistent still finds it.
+    // Returns the nodes along the path (both ends included), or an empty path
+    // if the nodes are invalid, identical or not connected.
+    // Note: the public interface assumes a 1-based indexing of nodes while
+    // the internal implementation uses a 0-based indexing scheme.
+    std::vector<int> GraphM::findPath(int fromNode, int toNode,
+                                      const std::function<int(int)>& heuristic) const
     {
-        clearShortestPath();        // Clear previous data (if any)
+        typedef std::tuple<long long, long long, int> HeapEntry;// estimate,
+                                                                // distance, node
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                            std::greater<HeapEntry> > heap;
 
-        // For each node in the graph, assess shortest path to all other vertices
-        for (int fromNode = 0; fromNode < size; fromNode++)
+        if ((fromNode < 1) || (fromNode > size) ||
+            (toNode < 1) || (toNode > size) ||
+            (toNode == fromNode))
         {
-            // As all paths are un-optimized, we visit the other nodes one by one
-            // and we mark them as "visited". The nodes are visited in increasing
-            // order of their distance to current node (i.e. "fromNode").
-            for (int pass = size - 1; pass >= 0; pass--)
-            {
-                // Find vertex within the smallest distance from current node
-                int toNode = findNode(fromNode);
+            return std::vector<int>();
+        }
 
-                if ((toNode < 0) || (T[fromNode][toNode].dist >= MAX_COST_PATH))
-                {
-                    // All remaining vertices are inaccessible from current node
-                    break;
-                }
+        int start = fromNode - 1;
+        int end = toNode - 1;
+        std::vector<long long> dist(size, NO_PATH);
+        std::vector<int> path(size, -1);            // previous node
 
-                T[fromNode][toNode].visited = true;
+        dist[start] = MIN_COST_PATH;
+        heap.push(HeapEntry(heuristic(fromNode), MIN_COST_PATH, start));
 
-                // If we found one path, then record the fact that we have at least
-                // one path available
-                shortestPath = true;
+        while (!heap.empty())
+        {
+            long long distance = std::get<1>(heap.top());
+            int node = std::get<2>(heap.top());
 
-                // Assess short path from current node (i.e. "fromNode") to all
-                // (yet to be visited) neighbors of closest node (i.e. "toNode").
-                for (int nextNode = 0; nextNode < size; nextNode++)
+            heap.pop();
+            if (distance > dist[node])
+            {
+                // Outdated entry: node was reached again with a lower cost
+                continue;
+            }
+            if (node == end)
+            {
+                return tracePath(start, end, -1, path, std::vector<int>());
+            }
+
+            for (int nextNode = 0; nextNode < size; nextNode++)
+            {
+                int cost = C[node][nextNode];
+
+                if ((nextNode != node) && (cost < MAX_COST_PATH) &&
+                    (distance + cost < dist[nextNode]))
                 {
-                    // Iterate over all neighbors of "toNode" yet to be visited
-                    if ((nextNode != fromNode) &&
-                        (nextNode != toNode) &&
-                        !T[fromNode][nextNode].visited &&
-                        (C[toNode][nextNode] < MAX_COST_PATH))
-                    {
-                        int dist = T[fromNode][toNode].dist + C[toNode][nextNode];
-                        if (dist < T[fromNode][nextNode].dist)
-                        {
-                            // Update max. distance and record path
-                            int path = T[fromNode][nextNode].path;
-
-                            T[fromNode][nextNode].dist = dist;
-                            T[fromNode][nextNode].path =
-                                (path >= 0) ? path : toNode;
-                        }
-                    }
+                    // Update min. distance and record path
+                    dist[nextNode] = distance + cost;
+                    path[nextNode] = node;
+                    heap.push(HeapEntry(distance + cost + heuristic(nextNode + 1),
+                                        distance + cost, nextNode));
                 }
             }
         }
+
+        return std::vector<int>();
     }
 
     //---------------------------------------------------------------------------
@@ -284,7 +495,7 @@ namespace dsa
 
             displayPathDistance(start, end);
             std::cout << std::endl;
-            if (T[start][end].dist < MAX_COST_PATH)
+            if (shortestPath && (T[start][end].dist < MAX_COST_PATH))
             {
                 int current = T[start][end].path;
 
@@ -352,17 +563,45 @@ namespace dsa
     // Helper method for initializing Graph data within constructors
     void GraphM::initGraph()
     {
-        size = MAXNODES;
-        makeEmpty();
+        size = 0;
+        shortestPath = false;
+    }
+
+    // ---------------------------------------------------------------------------
+    // resizeGraph
+    // Helper method that allocates the storage for a number of nodes, without
+    // any edge between them.
+    void GraphM::resizeGraph(int nodes)
+    {
+        data.resize(nodes);
+        C.resize(nodes, nodes, MAX_COST_PATH);
+        for (int node = 0; node < nodes; node++)
+        {
+            C[node][node] = MIN_COST_PATH;
+        }
+    }
+
+    // ---------------------------------------------------------------------------
+    // nameNode
+    // Helper method that indexes the description of a node (0-based) for
+    // findNode. Empty descriptions are not indexed, and a description shared
+    // by several nodes keeps naming the first of them.
+    void GraphM::nameNode(int index, const std::string& name)
+    {
+        if (!name.empty() && (names.intern(name) == namedNode.size()))
+        {
+            namedNode.push_back(index + 1);
+        }
     }
 
     //---------------------------------------------------------------------------
     // clearShortestPath
     // Helper method used to clear the shortest path data computed by
-    // findShortestPath method.
+    // findShortestPath method; the table is sized to the number of nodes.
     void GraphM::clearShortestPath()
     {
         shortestPath = false;
+        T.resize(size, size);
         for (int fromNode = 0; fromNode < size; fromNode++)
         {
             for (int toNode = 0; toNode < size; toNode++)
@@ -376,29 +615,412 @@ namespace dsa
     }
 
     //---------------------------------------------------------------------------
-    // findNode
-    // Helper method that locates and returns the node within the shortest
-    // distance from a reference node and not marked as "visited".
-    int GraphM::findNode(int fromNode) const
+    // shortenPaths
+    // Helper method that repairs the shortest paths after the cost of an edge
+    // went down. A path from x to y improves only if it can go through the
+    // edge, i.e. dist(x, fromNode) + cost + dist(toNode, y) < dist(x, y);
+    // this requires both dist(x, fromNode) + cost < dist(x, toNode) and
+    // cost + dist(toNode, y) < dist(fromNode, y), so only the pairs of such
+    // sources and targets are checked. The improved paths follow the path
+    // towards "fromNode" (so they share its first hop), then the edge.
+    // Note: As a private method it assumes that the arguments are 0-based (as
+    // used by the internal indexing scheme).
+    void GraphM::shortenPaths(int fromNode, int toNode)
+    {
+        long long cost = C[fromNode][toNode];
+        std::vector<int> sources;               // nodes reaching "fromNode"
+        std::vector<int> targets;               // nodes reached by "toNode"
+
+        for (int node = 0; node < size; node++)
+        {
+            if ((T[node][fromNode].dist < MAX_COST_PATH) &&
+                (T[node][fromNode].dist + cost < T[node][toNode].dist))
+            {
+                sources.push_back(node);
+            }
+            if ((T[toNode][node].dist < MAX_COST_PATH) &&
+                (cost + T[toNode][node].dist < T[fromNode][node].dist))
+            {
+                targets.push_back(node);
+            }
+        }
+
+        // The distances read below are not changed by the loop: no path to
+        // "fromNode" nor from "toNode" can go through the edge
+        for (int source : sources)
+        {
+            long long first = T[source][fromNode].dist + cost;
+            int path = (source != fromNode) ?
+                ((T[source][fromNode].path >= 0) ?
+                 T[source][fromNode].path : fromNode) : toNode;
+
+            for (int target : targets)
+            {
+                long long dist = first + T[toNode][target].dist;
+
+                if ((target != source) && (dist < T[source][target].dist) &&
+                    (dist < MAX_COST_PATH))
+                {
+                    T[source][target].visited = true;
+                    T[source][target].dist = static_cast<int>(dist);
+                    T[source][target].path = (path != target) ? path : -1;
+                }
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    // lengthenPaths
+    // Helper method that repairs the shortest paths after the cost of an edge
+    // went up (or the edge was removed), one target node at a time (as done
+    // by Ramalingam and Reps). The first hops towards a target form a tree;
+    // if the edge is part of it, the nodes whose path runs through the edge
+    // are the ones under "fromNode" in the tree, and only those lose their
+    // distance. Each of them first gets the best path through an edge to an
+    // unaffected node, then Dijkstra's algorithm is run backward from the
+    // target over the affected nodes, so that each one is settled through a
+    // node settled before it.
+    // Note: As a private method it assumes that the arguments are 0-based (as
+    // used by the internal indexing scheme).
+    void GraphM::lengthenPaths(int fromNode, int toNode)
+    {
+        typedef std::pair<long long, int> HeapEntry;    // distance, node
+        const char UNKNOWN = 0;                 // states of the nodes
+        const char AFFECTED = 1;
+        const char UNAFFECTED = 2;
+        std::vector<char> state(size);
+        std::vector<int> affected;              // affected nodes
+        std::vector<int> chain;                 // nodes being classified
+
+        for (int target = 0; target < size; target++)
+        {
+            const TableType& edge = T[fromNode][target];
+
+            if ((target == fromNode) || (edge.dist >= MAX_COST_PATH) ||
+                (((edge.path >= 0) ? edge.path : target) != toNode))
+            {
+                // The edge is not on the paths towards "target"
+                continue;
+            }
+
+            // Classify the nodes by following their first hops until a node
+            // of known state is met
+            std::fill(state.begin(), state.end(), UNKNOWN);
+            state[fromNode] = AFFECTED;
+            state[target] = UNAFFECTED;
+            affected.clear();
+            for (int node = 0; node < size; node++)
+            {
+                int current = node;
+
+                while (state[current] == UNKNOWN)
+                {
+                    if (T[current][target].dist >= MAX_COST_PATH)
+                    {
+                        state[current] = UNAFFECTED;
+                        break;
+                    }
+                    chain.push_back(current);
+                    current = (T[current][target].path >= 0) ?
+                        T[current][target].path : target;
+                }
+                for (int link : chain)
+                {
+                    state[link] = state[current];
+                }
+                chain.clear();
+                if (state[node] == AFFECTED)
+                {
+                    affected.push_back(node);
+                }
+            }
+
+            // Best paths of the affected nodes through an unaffected node
+            std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                                std::greater<HeapEntry> > heap;
+
+            for (int node : affected)
+            {
+                TableType& table = T[node][target];
+
+                table.visited = false;
+                table.dist = MAX_COST_PATH;
+                table.path = -1;
+                for (int nextNode = 0; nextNode < size; nextNode++)
+                {
+                    long long cost = C[node][nextNode];
+
+                    if ((nextNode != node) && (state[nextNode] == UNAFFECTED) &&
+                        (cost < MAX_COST_PATH) &&
+                        (T[nextNode][target].dist < MAX_COST_PATH) &&
+                        (cost + T[nextNode][target].dist < table.dist))
+                    {
+                        table.dist = static_cast<int>(
+                            cost + T[nextNode][target].dist);
+                        table.path = (nextNode != target) ? nextNode : -1;
+                    }
+                }
+                if (table.dist < MAX_COST_PATH)
+                {
+                    heap.push(HeapEntry(table.dist, node));
+                }
+            }
+
+            // Settle the affected nodes in increasing order of distance
+            while (!heap.empty())
+            {
+                int node = heap.top().second;
+
+                heap.pop();
+                if (T[node][target].visited)
+                {
+                    // Outdated entry: node was already reached with a lower cost
+                    continue;
+                }
+                T[node][target].visited = true;
+
+                long long dist = T[node][target].dist;
+
+                for (int prevNode = 0; prevNode < size; prevNode++)
+                {
+                    TableType& table = T[prevNode][target];
+                    long long cost = C[prevNode][node];
+
+                    if ((state[prevNode] == AFFECTED) && !table.visited &&
+                        (prevNode != node) && (cost < MAX_COST_PATH - dist) &&
+                        (dist + cost < table.dist))
+                    {
+                        // Update min. distance and record path
+                        table.dist = static_cast<int>(dist + cost);
+                        table.path = node;
+                        heap.push(HeapEntry(table.dist, prevNode));
+                    }
+                }
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    // countEdges
+    // Helper method that returns the number of edges within the Graph.
+    long long GraphM::countEdges() const
+    {
+        long long edges = 0;
+
+        for (int fromNode = 0; fromNode < size; fromNode++)
+        {
+            for (int toNode = 0; toNode < size; toNode++)
+            {
+                if ((toNode != fromNode) &&
+                    (C[fromNode][toNode] < MAX_COST_PATH))
+                {
+                    edges++;
+                }
+            }
+        }
+
+        return edges;
+    }
+
+    //---------------------------------------------------------------------------
+    // findShortestPathDijkstra
+    // Helper method that computes the shortest paths by running Dijkstra's
+    // algorithm from every vertex in parallel. The edges are first packed into
+    // compact adjacency lists so that each pass only visits existing edges.
+    void GraphM::findShortestPathDijkstra(thread_pool& pool)
     {
-        int nextNode = -1;
+        std::vector<std::size_t> offsets(size + 1, 0);  // first edge of nodes
+        std::vector<int> targets;               // edge destinations
+        std::vector<int> costs;                 // edge costs
 
-        if ((fromNode >= 0) && (fromNode < size))
+        for (int fromNode = 0; fromNode < size; fromNode++)
         {
             for (int toNode = 0; toNode < size; toNode++)
             {
-                if ((toNode != fromNode) && !T[fromNode][toNode].visited)
+                if ((toNode != fromNode) &&
+                    (C[fromNode][toNode] < MAX_COST_PATH))
                 {
-                    if ((nextNode < 0) ||
-                        (T[fromNode][toNode].dist < T[fromNode][nextNode].dist))
+                    targets.push_back(toNode);
+                    costs.push_back(C[fromNode][toNode]);
+                }
+            }
+            offsets[fromNode + 1] = targets.size();
+        }
+
+        // Each pass only writes the row of its source node
+        pool.parallel_for(0, size, [&](std::size_t fromNode)
+        {
+            dijkstra(static_cast<int>(fromNode), offsets, targets, costs);
+        });
+    }
+
+    //---------------------------------------------------------------------------
+    // dijkstra
+    // Helper method that computes the shortest paths from one vertex to all the
+    // other vertices, visiting them in increasing order of their distance with
+    // the help of a binary heap (of which outdated entries are skipped).
+    // Paths of equal distance are ranked by their number of edges, so that
+    // following the first hops always ends even with zero-cost edges.
+    void GraphM::dijkstra(int fromNode,
+                          const std::vector<std::size_t>& offsets,
+                          const std::vector<int>& targets,
+                          const std::vector<int>& costs)
+    {
+        typedef std::tuple<int, int, int> HeapEntry;    // distance, hops, node
+        std::priority_queue<HeapEntry, std::vector<HeapEntry>,
+                            std::greater<HeapEntry> > heap;
+        std::vector<int> hops(size, 0);                 // edges in path
+        TableType* table = T[fromNode];
+
+        for (int toNode = 0; toNode < size; toNode++)
+        {
+            table[toNode].visited = false;
+            table[toNode].dist = MAX_COST_PATH;
+            table[toNode].path = -1;
+        }
+        table[fromNode].dist = MIN_COST_PATH;
+        heap.push(HeapEntry(MIN_COST_PATH, 0, fromNode));
+
+        while (!heap.empty())
+        {
+            int toNode = std::get<2>(heap.top());
+
+            heap.pop();
+            if (table[toNode].visited)
+            {
+                // Outdated entry: node was already reached with a lower cost
+                continue;
+            }
+            table[toNode].visited = true;
+
+            // The first hop towards the neighbors is the one towards "toNode"
+            // (or the neighbor itself when leaving the source node)
+            int dist = table[toNode].dist;
+            int edges = hops[toNode] + 1;
+            int path = (toNode == fromNode) ? -1 :
+                       (table[toNode].path >= 0) ? table[toNode].path : toNode;
+
+            for (std::size_t edge = offsets[toNode];
+                 edge < offsets[toNode + 1]; edge++)
+            {
+                int nextNode = targets[edge];
+
+                if (!table[nextNode].visited &&
+                    (costs[edge] < MAX_COST_PATH - dist) &&
+                    ((dist + costs[edge] < table[nextNode].dist) ||
+                     ((dist + costs[edge] == table[nextNode].dist) &&
+                      (edges < hops[nextNode]))))
+                {
+                    // Update min. distance and record path
+                    table[nextNode].dist = dist + costs[edge];
+                    table[nextNode].path = path;
+                    hops[nextNode] = edges;
+                    heap.push(HeapEntry(table[nextNode].dist, edges, nextNode));
+                }
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    // findShortestPathFloydWarshall
+    // Helper method that computes the shortest paths with Floyd-Warshall's
+    // algorithm. The distance matrix is split into square tiles that fit in the
+    // cache; for each diagonal tile, the tile itself is relaxed first, then the
+    // tiles sharing its rows or columns, then all remaining tiles. The tiles of
+    // the last two phases are independent and are relaxed in parallel.
+    // Paths of equal distance are ranked by their number of edges, as done by
+    // dijkstra.
+    void GraphM::findShortestPathFloydWarshall(thread_pool& pool)
+    {
+        int blocks = (size + FLOYD_WARSHALL_BLOCK - 1) / FLOYD_WARSHALL_BLOCK;
+        Matrix<int> dist(size, size);           // distances
+        Matrix<int> hops(size, size);           // numbers of edges
+        Matrix<int> path(size, size);           // first hops
+
+        for (int fromNode = 0; fromNode < size; fromNode++)
+        {
+            for (int toNode = 0; toNode < size; toNode++)
+            {
+                dist[fromNode][toNode] = T[fromNode][toNode].dist;
+                hops[fromNode][toNode] = (toNode != fromNode) ? 1 : 0;
+                path[fromNode][toNode] = T[fromNode][toNode].path;
+            }
+        }
+
+        for (int viaBlock = 0; viaBlock < blocks; viaBlock++)
+        {
+            relaxTile(dist, hops, path, viaBlock, viaBlock, viaBlock);
+
+            pool.parallel_for(0, 2 * blocks, [&](std::size_t index)
+            {
+                int block = static_cast<int>(index) / 2;
+
+                if (block != viaBlock)
+                {
+                    if (index % 2 == 0)
+                    {
+                        relaxTile(dist, hops, path, viaBlock, block, viaBlock);
+                    }
+                    else
                     {
-                        nextNode = toNode;
+                        relaxTile(dist, hops, path, block, viaBlock, viaBlock);
                     }
                 }
+            }, 1);
+
+            pool.parallel_for(0, blocks, [&](std::size_t index)
+            {
+                int fromBlock = static_cast<int>(index);
+
+                for (int toBlock = 0; toBlock < blocks; toBlock++)
+                {
+                    if ((fromBlock != viaBlock) && (toBlock != viaBlock))
+                    {
+                        relaxTile(dist, hops, path, fromBlock, toBlock, viaBlock);
+                    }
+                }
+            }, 1);
+        }
+
+        for (int fromNode = 0; fromNode < size; fromNode++)
+        {
+            for (int toNode = 0; toNode < size; toNode++)
+            {
+                T[fromNode][toNode].visited =
+                    (dist[fromNode][toNode] < MAX_COST_PATH);
+                T[fromNode][toNode].dist = dist[fromNode][toNode];
+                T[fromNode][toNode].path = path[fromNode][toNode];
             }
         }
+    }
+
+    //---------------------------------------------------------------------------
+    // tracePath
+    // Helper method that builds the path found by findPath: the "forward"
+    // links lead back from "lastNode" to "fromNode", and the path goes on with
+    // "nextNode" (if any, -1 otherwise) and its "backward" links to the end.
+    // Note: As a private method it assumes that the arguments are 0-based (as
+    // used by the internal indexing scheme), while the path is 1-based.
+    std::vector<int> GraphM::tracePath(int fromNode, int lastNode, int nextNode,
+                                       const std::vector<int>& forward,
+                                       const std::vector<int>& backward) const
+    {
+        std::vector<int> path;
+
+        for (int current = lastNode; current != fromNode;
+             current = forward[current])
+        {
+            path.push_back(current + 1);
+        }
+        path.push_back(fromNode + 1);
+        std::reverse(path.begin(), path.end());
+
+        for (int current = nextNode; current >= 0; current = backward[current])
+        {
+            path.push_back(current + 1);
+        }
 
-        return nextNode;
+        return path;
     }
 
     //---------------------------------------------------------------------------
@@ -492,4 +1114,59 @@ namespace dsa
             info += ss.str();
         }
     }
+
+    //---------------------------------------------------------------------------
+    // relaxTile
+    // Helper function that relaxes the paths of one tile of the Floyd-Warshall
+    // distance matrix (rows of "fromBlock", columns of "toBlock") through the
+    // intermediate nodes of "viaBlock". The "path" matrix records the first hop
+    // of each path (-1 when the edge is direct) and "hops" its number of edges.
+    void relaxTile(Matrix<int>& dist, Matrix<int>& hops, Matrix<int>& path,
+                   int fromBlock, int toBlock, int viaBlock)
+    {
+        int size = dist.getRows();
+        int fromEnd = std::min((fromBlock + 1) * FLOYD_WARSHALL_BLOCK, size);
+        int toEnd = std::min((toBlock + 1) * FLOYD_WARSHALL_BLOCK, size);
+        int viaEnd = std::min((viaBlock + 1) * FLOYD_WARSHALL_BLOCK, size);
+
+        for (int viaNode = viaBlock * FLOYD_WARSHALL_BLOCK;
+             viaNode < viaEnd; viaNode++)
+        {
+            const int* viaDist = dist[viaNode];
+            const int* viaHops = hops[viaNode];
+
+            for (int fromNode = fromBlock * FLOYD_WARSHALL_BLOCK;
+                 fromNode < fromEnd; fromNode++)
+            {
+                int* fromDist = dist[fromNode];
+                int* fromHops = hops[fromNode];
+                int* fromPath = path[fromNode];
+                int firstDist = fromDist[viaNode];
+                int firstHops = fromHops[viaNode];
+
+                if (firstDist >= MAX_COST_PATH)
+                {
+                    // "viaNode" is inaccessible from "fromNode"
+                    continue;
+                }
+
+                int firstHop = (fromPath[viaNode] >= 0) ?
+                    fromPath[viaNode] : viaNode;
+
+                for (int toNode = toBlock * FLOYD_WARSHALL_BLOCK;
+                     toNode < toEnd; toNode++)
+                {
+                    if ((viaDist[toNode] < MAX_COST_PATH - firstDist) &&
+                        ((firstDist + viaDist[toNode] < fromDist[toNode]) ||
+                         ((firstDist + viaDist[toNode] == fromDist[toNode]) &&
+                          (firstHops + viaHops[toNode] < fromHops[toNode]))))
+                    {
+                        fromDist[toNode] = firstDist + viaDist[toNode];
+                        fromHops[toNode] = firstHops + viaHops[toNode];
+                        fromPath[toNode] = firstHop;
+                    }
+                }
+            }
+        }
+    }
 }
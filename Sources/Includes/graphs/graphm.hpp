@@ -4,17 +4,41 @@
 
 #pragma once
 
+#include "matrix.hpp"
 #include "node_data.hpp"
+#include "vertex_dictionary.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace dsa
 {
+    class thread_pool;
+    struct loaded_graph;
+
+    // Shortest path algorithms
+    const int SHORTEST_PATH_AUTO = 0;           // picked from the graph density
+    const int SHORTEST_PATH_DIJKSTRA = 1;       // heap-based Dijkstra per source
+    const int SHORTEST_PATH_FLOYD_WARSHALL = 2; // blocked Floyd-Warshall
+
     //---------------------------------------------------------------------------
     // GraphM class: implementation of a Graph holding nodes with data packaged
     // as NodeData objects and having directional edges with integer weights. 
     // Features:
-    //  --  allows building the Graph with a stream of data
+    //  --  allows building the Graph with a stream of data or in bulk with
+    //      a loaded graph (see graph_loader.hpp); a stream is parsed one line
+    //      at a time, so the graphs of a data file are best read at once
+    //      with loadGraphs
+    //  --  allows finding a node by its description in constant time
     //  --  allows insertion and removal of edges
-    //  --  allows computing and displaying of Dijkstra's shortest path
+    //  --  allows computing and displaying of the all-pairs shortest paths,
+    //      either with Dijkstra's algorithm from every source (sparse graphs)
+    //      or with a blocked Floyd-Warshall (dense graphs), in parallel
+    //  --  keeps the computed shortest paths up to date when an edge is
+    //      inserted, modified or removed, repairing only the affected paths
+    //  --  allows finding the shortest path between two vertices on demand,
+    //      with a bidirectional Dijkstra or with A* given a heuristic
     // Note: the public interface assumes a 1-based indexing of nodes while
     // the internal implementation uses a 0-based indexing scheme.
     //---------------------------------------------------------------------------
@@ -27,13 +51,19 @@ namespace dsa
         // Accessors
         bool isEmpty() const;
         int getSize() const;
+        int findNode(const std::string& name) const;
 
         // Graph operations
         void makeEmpty();
         bool insertEdge(int fromNode, int toNode, int label);
         bool removeEdge(int fromNode, int toNode);
         void buildGraph( std::istream& infile);
-        void findShortestPath();
+        bool buildGraph(const loaded_graph& graph);
+        static std::vector<loaded_graph> loadGraphs(const std::string& path);
+        void findShortestPath(int algorithm = SHORTEST_PATH_AUTO);
+        std::vector<int> findPath(int fromNode, int toNode) const;
+        std::vector<int> findPath(int fromNode, int toNode,
+                                  const std::function<int(int)>& heuristic) const;
 
         // Display operations
         void display(int fromNode, int toNode) const;
@@ -42,8 +72,20 @@ namespace dsa
     private:
         // Helper methods
         void initGraph();
+        void resizeGraph(int nodes);
+        void nameNode(int index, const std::string& name);
         void clearShortestPath();
-        int findNode(int fromNode) const;
+        void shortenPaths(int fromNode, int toNode);
+        void lengthenPaths(int fromNode, int toNode);
+        long long countEdges() const;
+        void findShortestPathDijkstra(thread_pool& pool);
+        void findShortestPathFloydWarshall(thread_pool& pool);
+        void dijkstra(int fromNode, const std::vector<std::size_t>& offsets,
+                      const std::vector<int>& targets,
+                      const std::vector<int>& costs);
+        std::vector<int> tracePath(int fromNode, int lastNode, int nextNode,
+                                   const std::vector<int>& forward,
+                                   const std::vector<int>& backward) const;
         void displayPath(int fromNode, int toNode) const;
         void displayPathDistance(int fromNode, int toNode) const;
 
@@ -55,15 +97,18 @@ namespace dsa
         {
             bool visited;   // whether node has been visited 
             int dist;       // currently known shortest distance from source 
-            int path;       // previous node in path of min dist 
+            int path;       // first node after the source in path of min
+                            // dist (-1 when the edge is direct)
         };
 
         // Data members
-        static const int MAXNODES = 100;    // max. number of graph nodes
-        NodeData data[MAXNODES];            // data for graph nodes information 
-        int C[MAXNODES][MAXNODES];          // Cost array, the adjacency matrix 
+        std::vector<NodeData> data;         // data for graph nodes information 
+        Matrix<int> C;                      // Cost array, the adjacency matrix 
         int size;                           // number of nodes in the graph 
-        TableType T[MAXNODES][MAXNODES];    // stores visited, distance, path
+        Matrix<TableType> T;                // stores visited, distance, path
+                                            // (allocated by findShortestPath)
         bool shortestPath;                  // whether shortest path was computed
+        vertex_dictionary<> names;          // ids of the node descriptions
+        std::vector<int> namedNode;         // node (1-based) of each id
     };
 }
@@ -0,0 +1,284 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <numeric>
+#include <type_traits>
+
+namespace dsa
+{
+    // Alignment (in bytes) of the matrix rows
+    const std::size_t MATRIX_ALIGNMENT = 64;
+
+    //---------------------------------------------------------------------------
+    // Matrix class: dynamically sized matrix of trivially copyable elements,
+    // stored contiguously in row-major order.
+    // Features:
+    //  --  every row starts on a cache line: rows are padded up to a multiple
+    //      of the cache line size, so that row scans can be vectorized
+    //  --  rows are accessed as plain arrays through operator[]
+    // Note: the contents are discarded when the matrix is resized.
+    //---------------------------------------------------------------------------
+    template <typename Type>
+    class Matrix
+    {
+        static_assert(std::is_trivially_copyable<Type>::value,
+                      "Matrix elements must be trivially copyable.");
+
+    public:
+        Matrix();                                       // constructor
+        Matrix(int rows, int columns, const Type& value = Type());
+        Matrix(const Matrix& source);                   // copy constructor
+        ~Matrix();                                      // destructor
+
+        Matrix& operator=(const Matrix& source);
+
+        // Accessors
+        bool isEmpty() const;
+        int getRows() const;
+        int getColumns() const;
+        int getStride() const;
+
+        // Row access
+        Type* operator[](int row);
+        const Type* operator[](int row) const;
+
+        // Matrix operations
+        void resize(int rows, int columns, const Type& value = Type());
+        void fill(const Type& value);
+        void clear();
+        void swap(Matrix& target);
+
+    private:
+        // Helper methods
+        static int computeStride(int columns);
+        static Type* allocate(std::size_t count);
+        static void deallocate(Type* elements);
+
+        // Data members
+        Type* data;         // elements (rows padded up to the stride)
+        int rowCount;       // number of rows
+        int columnCount;    // number of columns
+        int stride;         // distance (in elements) between two rows
+    };
+
+    // ---------------------------------------------------------------------------
+    // Default constructor for class Matrix; the matrix is empty.
+    template <typename Type>
+    Matrix<Type>::Matrix()
+        : data(nullptr),
+          rowCount(0),
+          columnCount(0),
+          stride(0)
+    {
+    }
+
+    // ---------------------------------------------------------------------------
+    // Constructor for class Matrix; all the elements are set to "value".
+    template <typename Type>
+    Matrix<Type>::Matrix(int rows, int columns, const Type& value)
+        : Matrix()
+    {
+        resize(rows, columns, value);
+    }
+
+    // ---------------------------------------------------------------------------
+    // Copy constructor for class Matrix
+    template <typename Type>
+    Matrix<Type>::Matrix(const Matrix& source)
+        : data(nullptr),
+          rowCount(source.rowCount),
+          columnCount(source.columnCount),
+          stride(source.stride)
+    {
+        std::size_t count = static_cast<std::size_t>(rowCount) * stride;
+
+        if (count > 0)
+        {
+            data = allocate(count);
+            std::copy(source.data, source.data + count, data);
+        }
+    }
+
+    // ---------------------------------------------------------------------------
+    // Destructor for class Matrix
+    template <typename Type>
+    Matrix<Type>::~Matrix()
+    {
+        deallocate(data);
+    }
+
+    // ---------------------------------------------------------------------------
+    // operator=
+    // Assignment operator: the matrix becomes a copy of "source".
+    template <typename Type>
+    Matrix<Type>& Matrix<Type>::operator=(const Matrix& source)
+    {
+        if (this != &source)
+        {
+            Matrix copy(source);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // ---------------------------------------------------------------------------
+    // isEmpty
+    // Checks whether the Matrix holds no element and returns true if it is.
+    template <typename Type>
+    bool Matrix<Type>::isEmpty() const
+    {
+        return (rowCount == 0) || (columnCount == 0);
+    }
+
+    // ---------------------------------------------------------------------------
+    // getRows
+    // Returns the number of rows of the Matrix.
+    template <typename Type>
+    int Matrix<Type>::getRows() const
+    {
+        return rowCount;
+    }
+
+    // ---------------------------------------------------------------------------
+    // getColumns
+    // Returns the number of columns of the Matrix.
+    template <typename Type>
+    int Matrix<Type>::getColumns() const
+    {
+        return columnCount;
+    }
+
+    // ---------------------------------------------------------------------------
+    // getStride
+    // Returns the distance (in elements) between the beginning of two rows.
+    template <typename Type>
+    int Matrix<Type>::getStride() const
+    {
+        return stride;
+    }
+
+    // ---------------------------------------------------------------------------
+    // operator[]
+    // Returns the (cache line aligned) elements of a row; no bounds checking.
+    template <typename Type>
+    Type* Matrix<Type>::operator[](int row)
+    {
+        return data + static_cast<std::size_t>(row) * stride;
+    }
+
+    // ---------------------------------------------------------------------------
+    // operator[]
+    // Returns the (cache line aligned) elements of a row; no bounds checking.
+    template <typename Type>
+    const Type* Matrix<Type>::operator[](int row) const
+    {
+        return data + static_cast<std::size_t>(row) * stride;
+    }
+
+    //---------------------------------------------------------------------------
+    // resize
+    // Changes the dimensions of the Matrix and sets all its elements to
+    // "value". The memory is only reallocated when the dimensions change.
+    template <typename Type>
+    void Matrix<Type>::resize(int rows, int columns, const Type& value)
+    {
+        if ((rows <= 0) || (columns <= 0))
+        {
+            clear();
+            return;
+        }
+
+        if ((rows != rowCount) || (columns != columnCount))
+        {
+            int rowStride = computeStride(columns);
+            Type* elements =
+                allocate(static_cast<std::size_t>(rows) * rowStride);
+
+            deallocate(data);
+            data = elements;
+            rowCount = rows;
+            columnCount = columns;
+            stride = rowStride;
+        }
+        fill(value);
+    }
+
+    //---------------------------------------------------------------------------
+    // fill
+    // Sets all the elements of the Matrix (including the padding) to "value".
+    template <typename Type>
+    void Matrix<Type>::fill(const Type& value)
+    {
+        std::fill(data, data + static_cast<std::size_t>(rowCount) * stride,
+                  value);
+    }
+
+    //---------------------------------------------------------------------------
+    // clear
+    // Releases the Matrix memory; the matrix becomes empty.
+    template <typename Type>
+    void Matrix<Type>::clear()
+    {
+        deallocate(data);
+        data = nullptr;
+        rowCount = 0;
+        columnCount = 0;
+        stride = 0;
+    }
+
+    //---------------------------------------------------------------------------
+    // swap
+    // Exchanges the contents of two matrices.
+    template <typename Type>
+    void Matrix<Type>::swap(Matrix& target)
+    {
+        std::swap(data, target.data);
+        std::swap(rowCount, target.rowCount);
+        std::swap(columnCount, target.columnCount);
+        std::swap(stride, target.stride);
+    }
+
+    //---------------------------------------------------------------------------
+    // computeStride
+    // Helper method that rounds a number of columns up so that the size of a
+    // row is a multiple of the row alignment.
+    template <typename Type>
+    int Matrix<Type>::computeStride(int columns)
+    {
+        int step = static_cast<int>(
+            MATRIX_ALIGNMENT / std::gcd(MATRIX_ALIGNMENT, sizeof(Type)));
+
+        return ((columns + step - 1) / step) * step;
+    }
+
+    //---------------------------------------------------------------------------
+    // allocate
+    // Helper method that allocates aligned storage for a number of elements.
+    template <typename Type>
+    Type* Matrix<Type>::allocate(std::size_t count)
+    {
+        return static_cast<Type*>(::operator new(
+            count * sizeof(Type),
+            std::align_val_t(std::max(MATRIX_ALIGNMENT, alignof(Type)))));
+    }
+
+    //---------------------------------------------------------------------------
+    // deallocate
+    // Helper method that releases storage obtained from allocate.
+    template <typename Type>
+    void Matrix<Type>::deallocate(Type* elements)
+    {
+        if (elements != nullptr)
+        {
+            ::operator delete(
+                elements,
+                std::align_val_t(std::max(MATRIX_ALIGNMENT, alignof(Type))));
+        }
+    }
+}
@@ -0,0 +1,238 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Minimum spanning forests of a csr_graph whose edges are taken as undirected
+ * (an edge listed both ways is the same edge twice); the edges of an unweighted
+ * graph weigh 1.
+ *
+ * - boruvka_minimum_spanning_forest() runs Boruvka's algorithm on a
+ *   thread_pool: every round, each component picks its lightest edge to another
+ *   component (a compare-and-swap per candidate), then all picked edges are
+ *   merged into a lock-free union_find. Edges are ranked by weight, then by
+ *   their endpoints, so the picked edges never close a cycle and every round at
+ *   least halves the number of components.
+ * - kruskal_minimum_spanning_forest() sorts the edges by weight with the radix
+ *   sort (see sorts/radix_sort.hpp) and merges them in that order, keeping
+ *   the ones that join two components.
+ */
+
+#pragma once
+
+#include "csr_graph.hpp"
+#include "union_find.hpp"
+#include "../concurrency/thread_pool.hpp"
+#include "../sorts/radix_sort.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace dsa
+{
+	template <
+		typename Vertex,
+		typename Weight >
+	struct spanning_forest
+	{
+		struct edge
+		{
+			Vertex source;
+			Vertex target;
+			Weight weight;
+		};
+
+		// Edges of the forest.
+		std::vector< edge > edges;
+
+		// Sum of their weights.
+		std::int64_t weight = 0;
+	};
+
+	namespace minimum_spanning_forest_detail
+	{
+		template <
+			typename Vertex,
+			typename Weight >
+		Weight
+		edge_weight(
+			const csr_graph< Vertex, Weight >& graph,
+			const std::size_t position ) noexcept
+		{
+			return graph.weighted() ? graph.weights()[ position ] : Weight { 1 };
+		}
+
+		/**
+		 * Returns the source of every edge position.
+		 */
+		template <
+			typename Vertex,
+			typename Weight >
+		std::vector< Vertex >
+		edge_sources(
+			const csr_graph< Vertex, Weight >& graph,
+			thread_pool& pool )
+		{
+			std::vector< Vertex > sources( graph.edge_count() );
+
+			pool.parallel_for( 0, graph.vertex_count(), [&]( const std::size_t vertex )
+			{
+				const auto& offsets = graph.offsets();
+
+				std::fill(
+					std::begin( sources ) + offsets[ vertex ],
+					std::begin( sources ) + offsets[ vertex + 1 ],
+					static_cast< Vertex >( vertex ) );
+			} );
+
+			return sources;
+		}
+	}
+
+	template <
+		typename Vertex,
+		typename Weight >
+	spanning_forest< Vertex, Weight >
+	boruvka_minimum_spanning_forest(
+		const csr_graph< Vertex, Weight >& graph,
+		thread_pool& pool )
+	{
+		using namespace minimum_spanning_forest_detail;
+
+		constexpr auto none = static_cast< std::size_t >( -1 );
+
+		const auto vertices = graph.vertex_count();
+		const auto& targets = graph.targets();
+		const auto sources = edge_sources( graph, pool );
+
+		const auto rank = [&]( const std::size_t position )
+		{
+			return std::make_tuple(
+				edge_weight( graph, position ),
+				std::min( sources[ position ], targets[ position ] ),
+				std::max( sources[ position ], targets[ position ] ) );
+		};
+
+		const auto offer = [&rank]( std::atomic< std::size_t >& lightest, const std::size_t position )
+		{
+			auto current = lightest.load( std::memory_order_relaxed );
+
+			while ( ( current == none || rank( position ) < rank( current ) ) &&
+				!lightest.compare_exchange_weak( current, position, std::memory_order_relaxed ) )
+			{
+			}
+		};
+
+		union_find< Vertex > sets( vertices );
+		std::vector< Vertex > roots( vertices );
+		std::vector< std::atomic< std::size_t > > lightest( vertices );
+		std::vector< std::size_t > picked( vertices );
+		std::atomic< std::size_t > picked_count { 0 };
+		std::size_t previous_count = 0;
+
+		do
+		{
+			previous_count = picked_count.load();
+
+			// The sets do not change until the picked edges are merged.
+			pool.parallel_for( 0, vertices, [&]( const std::size_t vertex )
+			{
+				roots[ vertex ] = sets.find( static_cast< Vertex >( vertex ) );
+				lightest[ vertex ].store( none, std::memory_order_relaxed );
+			} );
+
+			// Lightest edge leaving every component, offered by both endpoints.
+			pool.parallel_for( 0, vertices, [&]( const std::size_t vertex )
+			{
+				const auto root = roots[ vertex ];
+
+				for ( auto position = graph.offsets()[ vertex ]; position < graph.offsets()[ vertex + 1 ]; ++position )
+				{
+					const auto target_root = roots[ targets[ position ] ];
+
+					if ( target_root != root )
+					{
+						offer( lightest[ root ], position );
+						offer( lightest[ target_root ], position );
+					}
+				}
+			} );
+
+			// Two components picking the same edge merge once.
+			pool.parallel_for( 0, vertices, [&]( const std::size_t root )
+			{
+				const auto position = lightest[ root ].load( std::memory_order_relaxed );
+
+				if ( position != none && sets.unite( sources[ position ], targets[ position ] ) )
+				{
+					picked[ picked_count.fetch_add( 1, std::memory_order_relaxed ) ] = position;
+				}
+			} );
+		}
+		while ( picked_count.load() != previous_count );
+
+		picked.resize( picked_count.load() );
+		std::sort( std::begin( picked ), std::end( picked ) );
+
+		spanning_forest< Vertex, Weight > forest;
+
+		for ( const auto position : picked )
+		{
+			forest.edges.push_back( { sources[ position ], targets[ position ], edge_weight( graph, position ) } );
+			forest.weight += edge_weight( graph, position );
+		}
+
+		return forest;
+	}
+
+	template <
+		typename Vertex,
+		typename Weight >
+	spanning_forest< Vertex, Weight >
+	kruskal_minimum_spanning_forest( const csr_graph< Vertex, Weight >& graph )
+	{
+		using namespace minimum_spanning_forest_detail;
+
+		using edge_type = typename spanning_forest< Vertex, Weight >::edge;
+
+		const auto vertices = graph.vertex_count();
+
+		std::vector< edge_type > edges;
+		edges.reserve( graph.edge_count() );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			for ( auto position = graph.offsets()[ vertex ]; position < graph.offsets()[ vertex + 1 ]; ++position )
+			{
+				edges.push_back( { static_cast< Vertex >( vertex ), graph.targets()[ position ], edge_weight( graph, position ) } );
+			}
+		}
+
+		radix::sort( std::begin( edges ), std::end( edges ), []( const edge_type& edge )
+		{
+			return edge.weight;
+		} );
+
+		union_find< Vertex > sets( vertices );
+		spanning_forest< Vertex, Weight > forest;
+
+		for ( const auto& edge : edges )
+		{
+			if ( sets.unite( edge.source, edge.target ) )
+			{
+				forest.edges.push_back( edge );
+				forest.weight += edge.weight;
+
+				if ( forest.edges.size() + 1 == vertices )
+				{
+					break;
+				}
+			}
+		}
+
+		return forest;
+	}
+}
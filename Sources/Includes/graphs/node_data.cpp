@@ -1,5 +1,8 @@
 #include "node_data.hpp"
 
+#include <istream>
+#include <ostream>
+
 namespace dsa
 {
     //------------------- constructors/destructor  -------------------------------
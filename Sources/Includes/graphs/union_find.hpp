@@ -0,0 +1,122 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A lock-free disjoint-set forest over the vertices 0 .. count - 1
+ * (Anderson, Woll - "Wait-free Parallel Algorithms for the Union-Find Problem").
+ *
+ * Every set is a tree of parent links whose root is the smallest vertex of the
+ * set: unite() links the larger root under the smaller one with a
+ * compare-and-swap on its parent, and retries if another thread linked it
+ * first. find() halves the path it walks, redirecting each visited vertex to
+ * its grandparent; a failed redirect is harmless since parents only ever move
+ * up the tree. Any number of threads may call find() and unite() at once.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Vertex >
+	class union_find
+	{
+	public:
+		explicit union_find( const std::size_t count ) :
+			parents( count )
+		{
+			for ( std::size_t vertex = 0; vertex < count; ++vertex )
+			{
+				this->parents[ vertex ].store( static_cast< Vertex >( vertex ), std::memory_order_relaxed );
+			}
+		}
+
+		~union_find() noexcept = default;
+
+		union_find( const union_find& ) = delete;
+		union_find( union_find&& ) noexcept = default;
+
+		union_find& operator=( const union_find& ) = delete;
+		union_find& operator=( union_find&& ) noexcept = default;
+
+		std::size_t
+		size() const noexcept
+		{
+			return this->parents.size();
+		}
+
+		/**
+		 * Returns the root (smallest vertex) of the set of vertex.
+		 */
+		Vertex
+		find( Vertex vertex ) noexcept
+		{
+			while ( true )
+			{
+				auto parent = this->parents[ vertex ].load( std::memory_order_relaxed );
+
+				if ( parent == vertex )
+				{
+					return vertex;
+				}
+
+				const auto grandparent = this->parents[ parent ].load( std::memory_order_relaxed );
+
+				if ( grandparent != parent )
+				{
+					this->parents[ vertex ].compare_exchange_weak( parent, grandparent, std::memory_order_relaxed );
+				}
+
+				vertex = grandparent;
+			}
+		}
+
+		/**
+		 * Merges the sets of lhs and rhs. Returns false if they were already merged.
+		 */
+		bool
+		unite(
+			const Vertex lhs,
+			const Vertex rhs ) noexcept
+		{
+			while ( true )
+			{
+				auto lhs_root = this->find( lhs );
+				auto rhs_root = this->find( rhs );
+
+				if ( lhs_root == rhs_root )
+				{
+					return false;
+				}
+
+				if ( lhs_root < rhs_root )
+				{
+					std::swap( lhs_root, rhs_root );
+				}
+
+				// Only a root may be linked: the swap fails if lhs_root got a parent meanwhile.
+				auto expected = lhs_root;
+
+				if ( this->parents[ lhs_root ].compare_exchange_strong( expected, rhs_root, std::memory_order_relaxed ) )
+				{
+					return true;
+				}
+			}
+		}
+
+		bool
+		same(
+			const Vertex lhs,
+			const Vertex rhs ) noexcept
+		{
+			return this->find( lhs ) == this->find( rhs );
+		}
+
+	private:
+		std::vector< std::atomic< Vertex > > parents;
+	};
+}
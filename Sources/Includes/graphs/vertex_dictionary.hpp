@@ -0,0 +1,262 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A dictionary of vertex names, interning each distinct name once and giving it
+ * a dense id: the first name interned is 0, the next new one 1, and so on, so
+ * the ids index the vertices of a csr_graph directly and graph algorithms never
+ * touch the names.
+ *
+ * The names are stored back to back in a single character arena, name i
+ * spanning characters[ offsets[ i ] .. offsets[ i + 1 ] ). The index is an
+ * open-addressed hash table (linear probing, at most half full) whose slots
+ * pair an id with the hash of its name, so a probe reads the arena only on a
+ * hash match and growing the table never rehashes a name. Interning or finding a
+ * name is O(1) expected, which makes building a graph from a named edge list
+ * O(1) per edge.
+ */
+
+#pragma once
+
+#include "csr_graph.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace dsa
+{
+	template < typename Id = std::uint32_t >
+	class vertex_dictionary
+	{
+	public:
+		using id_type = Id;
+
+		// Id returned by find() for an unknown name.
+		static constexpr Id npos = std::numeric_limits< Id >::max();
+
+		vertex_dictionary() = default;
+		~vertex_dictionary() noexcept = default;
+
+		vertex_dictionary( const vertex_dictionary& other ) = default;
+		vertex_dictionary( vertex_dictionary&& other ) noexcept = default;
+
+		vertex_dictionary& operator=( const vertex_dictionary& rhs ) = default;
+		vertex_dictionary& operator=( vertex_dictionary&& rhs ) noexcept = default;
+
+		std::size_t
+		size() const noexcept
+		{
+			return this->hashes.size();
+		}
+
+		bool
+		empty() const noexcept
+		{
+			return this->hashes.empty();
+		}
+
+		/**
+		 * Reserves room for names (and their characters) to be interned without
+		 * growing the arena or the index.
+		 */
+		void
+		reserve(
+			const std::size_t names,
+			const std::size_t characters = 0 )
+		{
+			this->arena.reserve( characters );
+			this->offsets.reserve( names + 1 );
+			this->hashes.reserve( names );
+
+			if ( 2 * names > this->slots.size() )
+			{
+				this->rehash( 2 * names );
+			}
+		}
+
+		/**
+		 * Returns the id of name, interning it under the next id if it is new.
+		 * Throws std::length_error once every id below npos is taken.
+		 */
+		Id
+		intern( const std::string_view name )
+		{
+			const auto hash = std::hash< std::string_view >{}( name );
+			auto slot = this->locate( name, hash );
+
+			if ( slot != this->slots.size() && this->slots[ slot ].id != npos )
+			{
+				return this->slots[ slot ].id;
+			}
+
+			if ( this->size() == npos )
+			{
+				throw std::length_error( "vertex_dictionary: too many names" );
+			}
+
+			if ( 2 * ( this->size() + 1 ) > this->slots.size() )
+			{
+				this->rehash( 2 * ( this->size() + 1 ) );
+				slot = this->locate( name, hash );
+			}
+
+			const auto id = static_cast< Id >( this->size() );
+
+			this->arena.insert( std::end( this->arena ), std::begin( name ), std::end( name ) );
+			this->offsets.push_back( this->arena.size() );
+			this->hashes.push_back( hash );
+			this->slots[ slot ] = { hash, id };
+
+			return id;
+		}
+
+		/**
+		 * Returns the id of name, or npos if it was never interned.
+		 */
+		Id
+		find( const std::string_view name ) const noexcept
+		{
+			const auto slot = this->locate( name, std::hash< std::string_view >{}( name ) );
+
+			return slot == this->slots.size() ? npos : this->slots[ slot ].id;
+		}
+
+		bool
+		contains( const std::string_view name ) const noexcept
+		{
+			return this->find( name ) != npos;
+		}
+
+		/**
+		 * Returns the name of id, viewing the arena: interning may move it.
+		 */
+		std::string_view
+		name( const Id id ) const
+		{
+			if ( id >= this->size() )
+			{
+				throw std::out_of_range( "vertex_dictionary: unknown id" );
+			}
+
+			return std::string_view(
+				this->arena.data() + this->offsets[ id ],
+				this->offsets[ id + 1 ] - this->offsets[ id ] );
+		}
+
+	private:
+		struct slot_type
+		{
+			std::size_t hash;
+			Id id;
+		};
+
+		/**
+		 * Returns the slot holding name, else the empty slot ending its probe
+		 * sequence (the slot count when there are no slots yet).
+		 */
+		std::size_t
+		locate(
+			const std::string_view name,
+			const std::size_t hash ) const noexcept
+		{
+			if ( this->slots.empty() )
+			{
+				return 0;
+			}
+
+			const auto mask = this->slots.size() - 1;
+
+			for ( auto slot = hash & mask; ; slot = ( slot + 1 ) & mask )
+			{
+				const auto id = this->slots[ slot ].id;
+
+				// An empty name may sit in an empty arena, whose data() is null.
+				if ( id == npos ||
+					( this->slots[ slot ].hash == hash &&
+						this->offsets[ id + 1 ] - this->offsets[ id ] == name.size() &&
+						( name.empty() || std::memcmp( this->arena.data() + this->offsets[ id ], name.data(), name.size() ) == 0 ) ) )
+				{
+					return slot;
+				}
+			}
+		}
+
+		/**
+		 * Grows the index to the power of two at least minimum, reinserting the ids
+		 * by their kept hashes.
+		 */
+		void
+		rehash( const std::size_t minimum )
+		{
+			std::size_t capacity = 16;
+
+			while ( capacity < minimum )
+			{
+				capacity *= 2;
+			}
+
+			this->slots.assign( capacity, { 0, npos } );
+
+			const auto mask = capacity - 1;
+
+			for ( std::size_t id = 0; id < this->hashes.size(); ++id )
+			{
+				auto slot = this->hashes[ id ] & mask;
+
+				while ( this->slots[ slot ].id != npos )
+				{
+					slot = ( slot + 1 ) & mask;
+				}
+
+				this->slots[ slot ] = { this->hashes[ id ], static_cast< Id >( id ) };
+			}
+		}
+
+		std::vector< char > arena;
+		std::vector< std::size_t > offsets = { 0 };
+		std::vector< std::size_t > hashes;
+		std::vector< slot_type > slots;
+	};
+
+	/**
+	 * An edge between two named vertices.
+	 */
+	template < typename Weight = std::int32_t >
+	struct named_edge
+	{
+		std::string_view source;
+		std::string_view target;
+		Weight weight;
+	};
+
+	/**
+	 * Interns the endpoints of named edges, in edge order, and returns the edges
+	 * between their ids; dictionary.size() is then the vertex count of the graph.
+	 */
+	template <
+		typename Vertex,
+		typename Weight >
+	std::vector< typename csr_graph< Vertex, Weight >::edge >
+	intern_edges(
+		vertex_dictionary< Vertex >& dictionary,
+		const std::vector< named_edge< Weight > >& edges )
+	{
+		std::vector< typename csr_graph< Vertex, Weight >::edge > result;
+		result.reserve( edges.size() );
+
+		for ( const auto& edge : edges )
+		{
+			const auto source = dictionary.intern( edge.source );
+
+			result.push_back( { source, dictionary.intern( edge.target ), edge.weight } );
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,255 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Vertex reorderings that improve the memory locality of graph traversals.
+ *
+ * Input vertex ids usually follow the order of the input, so the neighbors of
+ * a vertex (and their data, such as distances or parents) lie anywhere in
+ * memory. An ordering returns the new label of every vertex, labels[ vertex ],
+ * and relabel() rebuilds a csr_graph under it:
+ *
+ * - degree_ordering() labels the vertices by decreasing degree, which packs
+ *   the hubs of skewed (power-law) graphs, touched by most traversals, into a
+ *   few cache lines.
+ * - reverse_cuthill_mckee_ordering() labels the vertices in breadth-first
+ *   order, visiting the neighbors by increasing degree, and reverses the
+ *   result (Cuthill, McKee - "Reducing the bandwidth of sparse symmetric
+ *   matrices"). Neighbors get close labels, which suits meshes and other
+ *   graphs of small bandwidth. The search follows the out-edges, so directed
+ *   graphs are best ordered through their symmetric closure.
+ *
+ * The graph exposes vertex_count() and neighbors( vertex ) (such as csr_graph).
+ */
+
+#pragma once
+
+#include "csr_graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	namespace vertex_ordering_detail
+	{
+		/**
+		 * Returns the vertices sorted by increasing degree, ties by vertex (a counting sort).
+		 */
+		template < typename Graph >
+		std::vector< typename Graph::vertex_type >
+		vertices_by_degree( const Graph& graph )
+		{
+			using vertex_type = typename Graph::vertex_type;
+
+			const auto vertices = graph.vertex_count();
+
+			std::size_t largest = 0;
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				largest = std::max( largest, graph.neighbors( static_cast< vertex_type >( vertex ) ).size() );
+			}
+
+			std::vector< std::size_t > counts( largest + 2, 0 );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				++counts[ graph.neighbors( static_cast< vertex_type >( vertex ) ).size() + 1 ];
+			}
+
+			std::partial_sum( std::begin( counts ), std::end( counts ), std::begin( counts ) );
+
+			std::vector< vertex_type > sorted( vertices );
+
+			for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+			{
+				sorted[ counts[ graph.neighbors( static_cast< vertex_type >( vertex ) ).size() ]++ ] = static_cast< vertex_type >( vertex );
+			}
+
+			return sorted;
+		}
+	}
+
+	/**
+	 * Labels the vertices by decreasing degree, ties by vertex.
+	 */
+	template < typename Graph >
+	std::vector< typename Graph::vertex_type >
+	degree_ordering( const Graph& graph )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		const auto sorted = vertex_ordering_detail::vertices_by_degree( graph );
+		const auto vertices = sorted.size();
+
+		std::vector< vertex_type > labels( vertices );
+		std::size_t label = 0;
+
+		// Walk the degree classes from the highest one, keeping the vertex order within a class.
+		for ( auto last = vertices; last > 0; )
+		{
+			const auto degree = graph.neighbors( sorted[ last - 1 ] ).size();
+			auto first = last;
+
+			while ( first > 0 && graph.neighbors( sorted[ first - 1 ] ).size() == degree )
+			{
+				--first;
+			}
+
+			for ( auto index = first; index < last; ++index )
+			{
+				labels[ sorted[ index ] ] = static_cast< vertex_type >( label++ );
+			}
+
+			last = first;
+		}
+
+		return labels;
+	}
+
+	/**
+	 * Labels the vertices in reverse Cuthill-McKee order. Each search starts from
+	 * the unvisited vertex of lowest degree.
+	 */
+	template < typename Graph >
+	std::vector< typename Graph::vertex_type >
+	reverse_cuthill_mckee_ordering( const Graph& graph )
+	{
+		using vertex_type = typename Graph::vertex_type;
+
+		const auto vertices = graph.vertex_count();
+		const auto sorted = vertex_ordering_detail::vertices_by_degree( graph );
+
+		const auto degree_less = [&graph]( const vertex_type lhs, const vertex_type rhs )
+		{
+			const auto lhs_degree = graph.neighbors( lhs ).size();
+			const auto rhs_degree = graph.neighbors( rhs ).size();
+
+			return lhs_degree < rhs_degree || ( lhs_degree == rhs_degree && lhs < rhs );
+		};
+
+		// The queue of the searches is the order itself.
+		std::vector< vertex_type > order;
+		std::vector< bool > visited( vertices, false );
+
+		order.reserve( vertices );
+
+		for ( const auto root : sorted )
+		{
+			if ( visited[ root ] )
+			{
+				continue;
+			}
+
+			visited[ root ] = true;
+			order.push_back( root );
+
+			for ( auto head = order.size() - 1; head < order.size(); ++head )
+			{
+				const auto first = order.size();
+
+				for ( const auto neighbor : graph.neighbors( order[ head ] ) )
+				{
+					if ( !visited[ neighbor ] )
+					{
+						visited[ neighbor ] = true;
+						order.push_back( neighbor );
+					}
+				}
+
+				std::sort( std::begin( order ) + first, std::end( order ), degree_less );
+			}
+		}
+
+		std::vector< vertex_type > labels( vertices );
+
+		for ( std::size_t index = 0; index < vertices; ++index )
+		{
+			labels[ order[ index ] ] = static_cast< vertex_type >( vertices - 1 - index );
+		}
+
+		return labels;
+	}
+
+	/**
+	 * Returns the graph with every vertex renamed to labels[ vertex ], which must
+	 * be a permutation of the vertices. The out-edges of each vertex are sorted by
+	 * target, so that a traversal reads their data in increasing address order.
+	 */
+	template <
+		typename Vertex,
+		typename Weight >
+	csr_graph< Vertex, Weight >
+	relabel(
+		const csr_graph< Vertex, Weight >& graph,
+		const std::vector< Vertex >& labels )
+	{
+		using offset_type = typename csr_graph< Vertex, Weight >::offset_type;
+
+		const auto vertices = graph.vertex_count();
+
+		if ( labels.size() != vertices )
+		{
+			throw std::invalid_argument( "relabel: wrong number of labels" );
+		}
+
+		std::vector< Vertex > originals( vertices );
+		std::vector< bool > used( vertices, false );
+
+		for ( std::size_t vertex = 0; vertex < vertices; ++vertex )
+		{
+			const auto label = labels[ vertex ];
+
+			if ( static_cast< std::size_t >( label ) >= vertices || used[ label ] )
+			{
+				throw std::invalid_argument( "relabel: labels are not a permutation" );
+			}
+
+			used[ label ] = true;
+			originals[ label ] = static_cast< Vertex >( vertex );
+		}
+
+		std::vector< offset_type > offsets( vertices + 1, 0 );
+
+		for ( std::size_t label = 0; label < vertices; ++label )
+		{
+			offsets[ label + 1 ] = offsets[ label ] + graph.degree( originals[ label ] );
+		}
+
+		std::vector< Vertex > targets( graph.edge_count() );
+		std::vector< Weight > weights( graph.weighted() ? graph.edge_count() : 0 );
+		std::vector< std::pair< Vertex, Weight > > edges;
+
+		for ( std::size_t label = 0; label < vertices; ++label )
+		{
+			const auto original = originals[ label ];
+			const auto neighbors = graph.neighbors( original );
+
+			edges.clear();
+
+			for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+			{
+				edges.emplace_back( labels[ neighbors[ edge ] ], graph.weighted() ? graph.neighbor_weights( original )[ edge ] : Weight {} );
+			}
+
+			std::sort( std::begin( edges ), std::end( edges ) );
+
+			for ( std::size_t edge = 0; edge < edges.size(); ++edge )
+			{
+				targets[ offsets[ label ] + edge ] = edges[ edge ].first;
+
+				if ( graph.weighted() )
+				{
+					weights[ offsets[ label ] + edge ] = edges[ edge ].second;
+				}
+			}
+		}
+
+		return csr_graph< Vertex, Weight >( std::move( offsets ), std::move( targets ), std::move( weights ) );
+	}
+}
@@ -0,0 +1,130 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Implementation of least significant digit radix sort.
+ *
+ * The items are sorted on an integral key, one byte at a time from the least
+ * significant one, each pass being a stable counting sort into a buffer. Signed
+ * keys have their sign bit flipped so that negative keys come first. Passes
+ * over a byte that is the same in every key are skipped.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	struct radix
+	{
+		template < typename RandomAccessIterator >
+		static void
+		sort(
+			RandomAccessIterator begin,
+			RandomAccessIterator end )
+		{
+			using value_type = typename std::iterator_traits< RandomAccessIterator >::value_type;
+
+			sort( begin, end, []( const value_type& value )
+			{
+				return value;
+			} );
+		}
+
+		/**
+		 * Sorts the items by key( item ), which must be integral; items of equal keys
+		 * keep their order.
+		 */
+		template <
+			typename RandomAccessIterator,
+			typename Key >
+		static void
+		sort(
+			RandomAccessIterator begin,
+			RandomAccessIterator end,
+			Key key )
+		{
+			using value_type = typename std::iterator_traits< RandomAccessIterator >::value_type;
+			using key_type = std::decay_t< decltype( key( *begin ) ) >;
+			using unsigned_type = std::make_unsigned_t< key_type >;
+
+			static_assert( std::is_integral< key_type >::value, "radix sort keys must be integral" );
+
+			constexpr std::size_t RADIX_BITS = 8;
+			constexpr std::size_t BUCKETS = std::size_t { 1 } << RADIX_BITS;
+			constexpr std::size_t DIGITS = sizeof( key_type );
+			constexpr auto SIGN_BIT = std::is_signed< key_type >::value ?
+				static_cast< unsigned_type >( unsigned_type { 1 } << ( std::numeric_limits< unsigned_type >::digits - 1 ) ) :
+				unsigned_type { 0 };
+
+			const auto size = static_cast< std::size_t >( std::distance( begin, end ) );
+
+			if ( size < 2 )
+			{
+				return;
+			}
+
+			std::vector< unsigned_type > keys( size );
+			std::vector< std::array< std::size_t, BUCKETS > > counts( DIGITS );
+
+			for ( auto& count : counts )
+			{
+				count.fill( 0 );
+			}
+
+			// Count every digit of every key in a single read of the items.
+			for ( std::size_t index = 0; index < size; ++index )
+			{
+				keys[ index ] = static_cast< unsigned_type >( key( begin[ index ] ) ) ^ SIGN_BIT;
+
+				for ( std::size_t digit = 0; digit < DIGITS; ++digit )
+				{
+					++counts[ digit ][ ( keys[ index ] >> ( digit * RADIX_BITS ) ) & ( BUCKETS - 1 ) ];
+				}
+			}
+
+			std::vector< value_type > items( std::make_move_iterator( begin ), std::make_move_iterator( end ) );
+			std::vector< value_type > sorted_items( size );
+			std::vector< unsigned_type > sorted_keys( size );
+
+			for ( std::size_t digit = 0; digit < DIGITS; ++digit )
+			{
+				auto& count = counts[ digit ];
+				const auto shift = digit * RADIX_BITS;
+
+				if ( count[ ( keys.front() >> shift ) & ( BUCKETS - 1 ) ] == size )
+				{
+					continue;
+				}
+
+				std::size_t offset = 0;
+
+				for ( auto& bucket : count )
+				{
+					offset += std::exchange( bucket, offset );
+				}
+
+				for ( std::size_t index = 0; index < size; ++index )
+				{
+					const auto position = count[ ( keys[ index ] >> shift ) & ( BUCKETS - 1 ) ]++;
+
+					sorted_items[ position ] = std::move( items[ index ] );
+					sorted_keys[ position ] = keys[ index ];
+				}
+
+				items.swap( sorted_items );
+				keys.swap( sorted_keys );
+			}
+
+			std::move( std::begin( items ), std::end( items ), begin );
+		}
+	};
+}
@@ -0,0 +1,476 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A binary search tree whose nodes are stored contiguously in an arena and
+ * linked through 32-bit indices (by default) instead of owning pointers.
+ *
+ * Since no node owns another, destruction and clear() release the whole arena
+ * at once instead of recursing through the tree (constant time when both the
+ * key and value are trivially destructible). Copying the tree copies the arena,
+ * which is a single memcpy when both the key and value are trivially copyable.
+ * Indices are relative to the arena, so the storage is relocatable and can be
+ * serialized as-is through storage() and root_index().
+ *
+ * Erased nodes are kept on a free list and reused by subsequent insertions.
+ * All operations are iterative, so deep (degenerate) trees cannot overflow the stack.
+ */
+
+#pragma once
+
+#include "arena_binary_search_tree_node.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template <
+		typename Key,
+		typename Value,
+		typename Index = std::uint32_t >
+	class arena_binary_search_tree
+	{
+
+	public:
+		using node_type = arena_binary_search_tree_node< Key, Value, Index >;
+		using index_type = Index;
+
+		static constexpr Index null_index = node_type::null_index;
+
+		arena_binary_search_tree() = default;
+		~arena_binary_search_tree() noexcept = default;
+
+		arena_binary_search_tree( const arena_binary_search_tree& other ) = default;
+		arena_binary_search_tree( arena_binary_search_tree&& other ) noexcept = default;
+
+		arena_binary_search_tree& operator=( const arena_binary_search_tree& rhs ) = default;
+		arena_binary_search_tree& operator=( arena_binary_search_tree&& rhs ) noexcept = default;
+
+		bool
+		operator==( const arena_binary_search_tree& other ) const
+		{
+			return ( this != &other && this->are_equal( other ) );
+		}
+
+		bool
+		operator!=( const arena_binary_search_tree& other ) const
+		{
+			return !( *this == other );
+		}
+
+		void
+		insert(
+			const Key key,
+			const Value value )
+		{
+			auto parent = null_index;
+			auto current = this->root;
+
+			while ( current != null_index )
+			{
+				const auto& node = this->arena[ current ];
+
+				if ( key > node.key )
+				{
+					parent = current;
+					current = node.right;
+				}
+				else if ( key < node.key )
+				{
+					parent = current;
+					current = node.left;
+				}
+				else
+				{
+					return;
+				}
+			}
+
+			// The arena may grow here, so the parent is only accessed afterwards.
+			const auto created = this->create_node( key, value );
+
+			if ( parent == null_index )
+			{
+				this->root = created;
+			}
+			else if ( key > this->arena[ parent ].key )
+			{
+				this->arena[ parent ].right = created;
+			}
+			else
+			{
+				this->arena[ parent ].left = created;
+			}
+
+			++( this->nodes );
+		}
+
+		void
+		erase( const Key key )
+		{
+			auto* link = &this->root;
+
+			while ( *link != null_index )
+			{
+				auto& node = this->arena[ *link ];
+
+				if ( key > node.key )
+				{
+					link = &node.right;
+				}
+				else if ( key < node.key )
+				{
+					link = &node.left;
+				}
+				else
+				{
+					this->erase_node( *link );
+					--( this->nodes );
+
+					return;
+				}
+			}
+		}
+
+		bool
+		contains( const Key key ) const
+		{
+			auto current = this->root;
+
+			while ( current != null_index )
+			{
+				const auto& node = this->arena[ current ];
+
+				if ( key == node.key )
+				{
+					return true;
+				}
+
+				current = ( key > node.key ) ? node.right : node.left;
+			}
+
+			return false;
+		}
+
+		std::size_t
+		calculated_size() const
+		{
+			std::size_t calculated_nodes = 0;
+
+			this->preorder( [&calculated_nodes](const auto&)
+			{
+				++calculated_nodes;
+			});
+
+			return calculated_nodes;
+		}
+
+		std::size_t
+		height() const
+		{
+			const auto heights = this->subtree_heights();
+			const auto height = ( this->root == null_index ) ? 0 : heights[ this->root ];
+
+			return ( height == 0 ) ? height : height - 1;
+		}
+
+		bool
+		balanced() const
+		{
+			const auto heights = this->subtree_heights();
+			const auto height_of = [&heights]( const Index index )
+			{
+				return static_cast< int >( ( index == null_index ) ? 0 : heights[ index ] );
+			};
+
+			bool balanced = true;
+
+			this->preorder( [&]( const node_type& node )
+			{
+				balanced = balanced && ( std::abs( height_of( node.left ) - height_of( node.right ) ) <= 1 );
+			});
+
+			return balanced;
+		}
+
+		bool
+		empty() const
+		{
+			return ( this->root == null_index && !this->nodes );
+		}
+
+		auto
+		size() const
+		{
+			return this->nodes;
+		}
+
+		/**
+		 * Releases every node at once. The arena capacity is retained for reuse.
+		 */
+		void
+		clear() noexcept
+		{
+			this->arena.clear();
+			this->root = null_index;
+			this->free_list = null_index;
+			this->nodes = 0;
+		}
+
+		/**
+		 * The raw arena, including free slots. Together with root_index(),
+		 * this fully describes the tree.
+		 */
+		const std::vector< node_type >&
+		storage() const noexcept
+		{
+			return this->arena;
+		}
+
+		Index
+		root_index() const noexcept
+		{
+			return this->root;
+		}
+
+		void
+		preorder( std::function< void( node_type const & ) >&& callback ) const
+		{
+			std::vector< Index > pending;
+
+			if ( this->root != null_index )
+			{
+				pending.push_back( this->root );
+			}
+
+			while ( !pending.empty() )
+			{
+				const auto& node = this->arena[ pending.back() ];
+				pending.pop_back();
+
+				callback( node );
+
+				if ( node.right != null_index )
+				{
+					pending.push_back( node.right );
+				}
+
+				if ( node.left != null_index )
+				{
+					pending.push_back( node.left );
+				}
+			}
+		}
+
+		void
+		inorder( std::function< void( node_type const & ) >&& callback ) const
+		{
+			std::vector< Index > pending;
+			auto current = this->root;
+
+			while ( current != null_index || !pending.empty() )
+			{
+				while ( current != null_index )
+				{
+					pending.push_back( current );
+					current = this->arena[ current ].left;
+				}
+
+				const auto& node = this->arena[ pending.back() ];
+				pending.pop_back();
+
+				callback( node );
+
+				current = node.right;
+			}
+		}
+
+		void
+		postorder( std::function< void( node_type const & ) >&& callback ) const
+		{
+			this->postorder_indices( [this, &callback]( const Index index )
+			{
+				callback( this->arena[ index ] );
+			});
+		}
+
+	private:
+
+		Index
+		create_node(
+			const Key key,
+			const Value value )
+		{
+			if ( this->free_list != null_index )
+			{
+				const auto reused = this->free_list;
+				auto& node = this->arena[ reused ];
+
+				this->free_list = node.left;
+				node = node_type( key, value );
+
+				return reused;
+			}
+
+			if ( this->arena.size() >= static_cast< std::size_t >( null_index ) )
+			{
+				throw std::length_error( "arena_binary_search_tree: index space exhausted" );
+			}
+
+			this->arena.emplace_back( key, value );
+
+			return static_cast< Index >( this->arena.size() - 1 );
+		}
+
+		void
+		release_node( const Index index )
+		{
+			auto& node = this->arena[ index ];
+
+			node = node_type();
+			node.left = this->free_list;
+
+			this->free_list = index;
+		}
+
+		void
+		erase_node( Index& link )
+		{
+			const auto target = link;
+			auto& node = this->arena[ target ];
+
+			if ( node.left == null_index || node.right == null_index )
+			{
+				link = ( node.left != null_index ) ? node.left : node.right;
+
+				this->release_node( target );
+			}
+			else
+			{
+				// Replace the key with the in-order predecessor and unlink the predecessor,
+				// which cannot have a right child.
+				auto* max_link = &node.left;
+
+				while ( this->arena[ *max_link ].right != null_index )
+				{
+					max_link = &this->arena[ *max_link ].right;
+				}
+
+				const auto max = *max_link;
+
+				node.key = this->arena[ max ].key;
+				node.value = this->arena[ max ].value;
+
+				*max_link = this->arena[ max ].left;
+
+				this->release_node( max );
+			}
+		}
+
+		template < typename Callback >
+		void
+		postorder_indices( Callback&& callback ) const
+		{
+			std::vector< std::pair< Index, bool > > pending;
+
+			if ( this->root != null_index )
+			{
+				pending.emplace_back( this->root, false );
+			}
+
+			while ( !pending.empty() )
+			{
+				auto& top = pending.back();
+
+				if ( top.second )
+				{
+					const auto index = top.first;
+					pending.pop_back();
+
+					callback( index );
+				}
+				else
+				{
+					top.second = true;
+
+					const auto& node = this->arena[ top.first ];
+
+					if ( node.right != null_index )
+					{
+						pending.emplace_back( node.right, false );
+					}
+
+					if ( node.left != null_index )
+					{
+						pending.emplace_back( node.left, false );
+					}
+				}
+			}
+		}
+
+		/**
+		 * Computes the height (in nodes) of every subtree, indexed like the arena.
+		 */
+		std::vector< std::size_t >
+		subtree_heights() const
+		{
+			std::vector< std::size_t > heights( this->arena.size(), 0 );
+
+			this->postorder_indices( [this, &heights]( const Index index )
+			{
+				const auto& node = this->arena[ index ];
+				const auto left = ( node.left == null_index ) ? 0 : heights[ node.left ];
+				const auto right = ( node.right == null_index ) ? 0 : heights[ node.right ];
+
+				heights[ index ] = 1 + std::max( left, right );
+			});
+
+			return heights;
+		}
+
+		bool
+		are_equal( const arena_binary_search_tree& other ) const
+		{
+			std::vector< std::pair< Index, Index > > pending { { this->root, other.root } };
+
+			while ( !pending.empty() )
+			{
+				const auto current = pending.back();
+				pending.pop_back();
+
+				if ( current.first == null_index || current.second == null_index )
+				{
+					if ( current.first != current.second )
+					{
+						return false;
+					}
+				}
+				else
+				{
+					const auto& lhs = this->arena[ current.first ];
+					const auto& rhs = other.arena[ current.second ];
+
+					if ( lhs.key != rhs.key || lhs != rhs )
+					{
+						return false;
+					}
+
+					pending.emplace_back( lhs.left, rhs.left );
+					pending.emplace_back( lhs.right, rhs.right );
+				}
+			}
+
+			return true;
+		}
+
+		std::vector< node_type > arena;
+		Index root = null_index;
+		Index free_list = null_index;
+		std::size_t nodes = 0;
+	};
+}
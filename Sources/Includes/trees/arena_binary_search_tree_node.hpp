@@ -0,0 +1,61 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace dsa
+{
+	/**
+	 * A binary search tree node which links to its children through indices
+	 * into the owning arena rather than through owning pointers.
+	 */
+	template <
+		typename Key,
+		typename Value,
+		typename Index = std::uint32_t >
+	struct arena_binary_search_tree_node
+	{
+		static constexpr Index null_index = std::numeric_limits< Index >::max();
+
+		arena_binary_search_tree_node() = default;
+
+		arena_binary_search_tree_node(
+			Key input_key,
+			Value input_value ) :
+			key( input_key ),
+			value( input_value )
+		{
+		}
+
+		~arena_binary_search_tree_node() = default;
+
+		arena_binary_search_tree_node( const arena_binary_search_tree_node& ) = default;
+		arena_binary_search_tree_node( arena_binary_search_tree_node&& ) noexcept = default;
+
+		arena_binary_search_tree_node& operator=( const arena_binary_search_tree_node& ) = default;
+		arena_binary_search_tree_node& operator=( arena_binary_search_tree_node&& ) noexcept = default;
+
+		bool
+		operator==( const arena_binary_search_tree_node& rhs ) const
+		{
+			return ( this->value == rhs.value );
+		}
+
+		bool
+		operator!=( const arena_binary_search_tree_node& rhs ) const
+		{
+			return !( *this == rhs );
+		}
+
+		Key key = Key();
+		Value value = Value();
+
+		Index left = null_index;
+		Index right = null_index;
+	};
+}
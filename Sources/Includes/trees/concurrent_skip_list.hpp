@@ -0,0 +1,853 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A concurrent ordered map implemented as a lazy skip list
+ * (Herlihy, Lev, Luchangco, Shavit - "A Simple Optimistic Skiplist Algorithm").
+ *
+ * contains() and find() never lock. insert() and erase() search without locks,
+ * then lock and validate only the predecessors of the modified node, so writers
+ * on different parts of the key space proceed in parallel. A node is logically
+ * present once it is fully linked and not marked; insert() linearizes when it
+ * sets the fully-linked flag and erase() when it marks the node.
+ *
+ * range() is linearizable: it scans optimistically and validates that no write
+ * linearized within the scanned span. Every write bumps a version on the node it
+ * changes (the level 0 predecessor of an insertion, the node being erased), so
+ * the scan re-checks the versions of the nodes it visited and writers elsewhere
+ * never touch a shared counter. It retries a bounded number of times before
+ * briefly holding back new writes to guarantee progress.
+ *
+ * Each node is allocated with only the levels it is linked at, its tower of
+ * next links following it in the same allocation.
+ *
+ * Erased nodes may still be traversed by concurrent operations, so they are
+ * reclaimed by epochs (Fraser - "Practical Lock-Freedom"): every operation
+ * announces the global epoch in a slot for its duration, an erased node is
+ * retired with the epoch current at the time, and the epoch only advances once
+ * every announced epoch has caught up with it. A node retired at epoch e is
+ * thus unreachable, and freed, once the epoch reaches e + 2. Reclamation is
+ * attempted every few retirements by whichever writer gets to it first, so the
+ * retired nodes stay bounded under any churn of inserts and erases.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template <
+		typename Key,
+		typename Value,
+		std::size_t MaxLevel = 24 >
+	class concurrent_skip_list
+	{
+		static_assert( MaxLevel > 0, "A skip list requires at least one level." );
+
+	public:
+		concurrent_skip_list() :
+			head( node::create( Key(), Value(), MaxLevel - 1 ) )
+		{
+		}
+
+		~concurrent_skip_list() noexcept
+		{
+			auto* current = this->head;
+
+			while ( current )
+			{
+				auto* next = current->next( 0 ).load( std::memory_order_relaxed );
+				node::destroy( current );
+				current = next;
+			}
+
+			current = this->retired.load( std::memory_order_relaxed );
+
+			while ( current )
+			{
+				auto* next = current->retired_next;
+				node::destroy( current );
+				current = next;
+			}
+		}
+
+		concurrent_skip_list( const concurrent_skip_list& ) = delete;
+		concurrent_skip_list( concurrent_skip_list&& ) = delete;
+
+		concurrent_skip_list& operator=( const concurrent_skip_list& ) = delete;
+		concurrent_skip_list& operator=( concurrent_skip_list&& ) = delete;
+
+		/**
+		 * Inserts the key if it is absent. Returns false if the key was already present.
+		 */
+		bool
+		insert(
+			const Key key,
+			const Value value )
+		{
+			const epoch_guard guard( *this );
+			const auto top_level = random_level();
+
+			std::array< node*, MaxLevel > predecessors;
+			std::array< node*, MaxLevel > successors;
+
+			while ( true )
+			{
+				const auto found = this->find_links( key, predecessors, successors );
+
+				if ( found >= 0 )
+				{
+					const auto* existing = successors[ found ];
+
+					if ( !existing->marked.load( std::memory_order_acquire ) )
+					{
+						// Wait for a concurrent insertion of the same key to linearize.
+						while ( !existing->fully_linked.load( std::memory_order_acquire ) )
+						{
+							std::this_thread::yield();
+						}
+
+						return false;
+					}
+
+					// The existing node is being erased; retry once it is unlinked.
+					continue;
+				}
+
+				predecessor_locks locks;
+
+				if ( !locks.acquire(
+					top_level,
+					predecessors,
+					[&successors]( const node* predecessor, const std::size_t level )
+					{
+						const auto* successor = successors[ level ];
+
+						return !predecessor->marked.load( std::memory_order_acquire ) &&
+							( !successor || !successor->marked.load( std::memory_order_acquire ) ) &&
+							( predecessor->next( level ).load( std::memory_order_acquire ) == successor );
+					} ) )
+				{
+					continue;
+				}
+
+				auto* created = node::create( key, value, top_level );
+
+				for ( std::size_t level = 0; level <= top_level; ++level )
+				{
+					created->next( level ).store( successors[ level ], std::memory_order_relaxed );
+				}
+
+				for ( std::size_t level = 0; level <= top_level; ++level )
+				{
+					predecessors[ level ]->next( level ).store( created, std::memory_order_release );
+				}
+
+				this->begin_write( *predecessors[ 0 ] );
+				created->fully_linked.store( true, std::memory_order_release );
+				this->end_write( *predecessors[ 0 ] );
+
+				this->count.fetch_add( 1, std::memory_order_relaxed );
+
+				return true;
+			}
+		}
+
+		/**
+		 * Erases the key if it is present. Returns false if the key was absent.
+		 */
+		bool
+		erase( const Key key )
+		{
+			const epoch_guard guard( *this );
+
+			std::array< node*, MaxLevel > predecessors;
+			std::array< node*, MaxLevel > successors;
+
+			node* victim = nullptr;
+			std::unique_lock< std::mutex > victim_lock;
+
+			while ( true )
+			{
+				const auto found = this->find_links( key, predecessors, successors );
+
+				if ( !victim_lock.owns_lock() )
+				{
+					if ( found < 0 )
+					{
+						return false;
+					}
+
+					victim = successors[ found ];
+
+					// Only a fully linked node found at its top level can be erased;
+					// anything else is still being inserted or already being erased.
+					if ( !victim->fully_linked.load( std::memory_order_acquire ) ||
+						victim->top_level != static_cast< std::size_t >( found ) ||
+						victim->marked.load( std::memory_order_acquire ) )
+					{
+						return false;
+					}
+
+					victim_lock = std::unique_lock< std::mutex >( victim->lock );
+
+					if ( victim->marked.load( std::memory_order_relaxed ) )
+					{
+						return false;
+					}
+
+					this->begin_write( *victim );
+					victim->marked.store( true, std::memory_order_release );
+					this->end_write( *victim );
+				}
+
+				predecessor_locks locks;
+
+				if ( !locks.acquire(
+					victim->top_level,
+					predecessors,
+					[victim]( const node* predecessor, const std::size_t level )
+					{
+						return !predecessor->marked.load( std::memory_order_acquire ) &&
+							( predecessor->next( level ).load( std::memory_order_acquire ) == victim );
+					} ) )
+				{
+					continue;
+				}
+
+				for ( auto level = victim->top_level + 1; level-- > 0; )
+				{
+					predecessors[ level ]->next( level ).store(
+						victim->next( level ).load( std::memory_order_relaxed ),
+						std::memory_order_release );
+				}
+
+				victim_lock.unlock();
+				this->retire( victim );
+
+				this->count.fetch_sub( 1, std::memory_order_relaxed );
+
+				return true;
+			}
+		}
+
+		bool
+		contains( const Key key ) const
+		{
+			const epoch_guard guard( *this );
+
+			return this->find_present( key ) != nullptr;
+		}
+
+		/**
+		 * Copies the value mapped to the key into the output. Returns false if the key is absent.
+		 */
+		bool
+		find(
+			const Key key,
+			Value& value ) const
+		{
+			const epoch_guard guard( *this );
+			const auto* present = this->find_present( key );
+
+			if ( present )
+			{
+				value = present->value;
+			}
+
+			return present != nullptr;
+		}
+
+		/**
+		 * Invokes the callback, in key order, on every item whose key lies in [lower, upper).
+		 * The items form a consistent snapshot taken at a single point in time.
+		 */
+		void
+		range(
+			const Key lower,
+			const Key upper,
+			std::function< void( const Key&, const Value& ) >&& callback ) const
+		{
+			const epoch_guard guard( *this );
+
+			std::vector< std::pair< Key, Value > > items;
+			std::vector< std::pair< const node*, std::uint64_t > > visited;
+
+			for ( std::size_t attempt = 0; attempt < OPTIMISTIC_SCAN_ATTEMPTS; ++attempt )
+			{
+				if ( this->collect( lower, upper, items, visited ) && validate( visited ) )
+				{
+					this->emit( items, callback );
+					return;
+				}
+
+				std::this_thread::yield();
+			}
+
+			// Hold back new writes; the in-flight ones drain and the scan then succeeds.
+			this->blocking_scans.fetch_add( 1 );
+
+			while ( !this->collect( lower, upper, items, visited ) || !validate( visited ) )
+			{
+				std::this_thread::yield();
+			}
+
+			this->blocking_scans.fetch_sub( 1 );
+
+			this->emit( items, callback );
+		}
+
+		bool
+		empty() const
+		{
+			return this->size() == 0;
+		}
+
+		/**
+		 * The number of keys, which is only exact in the absence of concurrent writers.
+		 */
+		std::size_t
+		size() const
+		{
+			return this->count.load( std::memory_order_relaxed );
+		}
+
+		/**
+		 * The number of erased nodes not freed yet.
+		 */
+		std::size_t
+		retired_size() const
+		{
+			return this->retired_count.load( std::memory_order_relaxed );
+		}
+
+	private:
+		static constexpr std::size_t OPTIMISTIC_SCAN_ATTEMPTS = 8;
+		static constexpr std::size_t EPOCH_SLOTS = 64;
+		static constexpr std::size_t RECLAIM_INTERVAL = 64;
+		static constexpr std::uint64_t QUIESCENT = std::numeric_limits< std::uint64_t >::max();
+
+		/**
+		 * A node is followed in its allocation by its tower of top_level + 1 next links.
+		 */
+		struct node
+		{
+			using link = std::atomic< node* >;
+
+			node(
+				Key input_key,
+				Value input_value,
+				const std::size_t input_top_level ) :
+				value( std::move( input_value ) ),
+				top_level( input_top_level ),
+				key( std::move( input_key ) )
+			{
+			}
+
+			static node*
+			create(
+				Key key,
+				Value value,
+				const std::size_t top_level )
+			{
+				static_assert( alignof( link ) <= alignof( node ), "The tower must be aligned after the node." );
+
+				auto* storage = ::operator new( sizeof( node ) + ( top_level + 1 ) * sizeof( link ) );
+				node* created = nullptr;
+
+				try
+				{
+					created = new ( storage ) node( std::move( key ), std::move( value ), top_level );
+				}
+				catch ( ... )
+				{
+					::operator delete( storage );
+					throw;
+				}
+
+				for ( std::size_t level = 0; level <= top_level; ++level )
+				{
+					new ( &created->tower()[ level ] ) link( nullptr );
+				}
+
+				return created;
+			}
+
+			static void
+			destroy( node* destroyed ) noexcept
+			{
+				destroyed->~node();
+				::operator delete( destroyed );
+			}
+
+			link&
+			next( const std::size_t level )
+			{
+				return this->tower()[ level ];
+			}
+
+			const link&
+			next( const std::size_t level ) const
+			{
+				return const_cast< node* >( this )->tower()[ level ];
+			}
+
+			std::mutex lock;
+			node* retired_next = nullptr;
+			std::uint64_t retired_epoch = 0;
+
+			// Odd while a write linearizes at this node (see begin_write).
+			std::atomic< std::uint64_t > version { 0 };
+
+			Value value;
+			const std::size_t top_level;
+			std::atomic< bool > marked { false };
+			std::atomic< bool > fully_linked { false };
+
+			// Last, so that a search reads the key and the lower links from the same cache line.
+			Key key;
+
+		private:
+			link*
+			tower()
+			{
+				return reinterpret_cast< link* >( reinterpret_cast< unsigned char* >( this ) + sizeof( node ) );
+			}
+		};
+
+		/**
+		 * Epoch announced by an operation in progress, QUIESCENT when the slot is idle.
+		 */
+		struct alignas( 64 ) epoch_slot
+		{
+			std::atomic< bool > taken { false };
+			std::atomic< std::uint64_t > epoch { QUIESCENT };
+		};
+
+		/**
+		 * Announces the current epoch for the lifetime of an operation.
+		 */
+		class epoch_guard
+		{
+		public:
+			explicit epoch_guard( const concurrent_skip_list& list ) :
+				slot( list.enter_epoch() )
+			{
+			}
+
+			~epoch_guard() noexcept
+			{
+				this->slot.epoch.store( QUIESCENT, std::memory_order_release );
+				this->slot.taken.store( false, std::memory_order_release );
+			}
+
+			epoch_guard( const epoch_guard& ) = delete;
+			epoch_guard& operator=( const epoch_guard& ) = delete;
+
+		private:
+			epoch_slot& slot;
+		};
+
+		/**
+		 * Locks the distinct predecessors from the bottom level up (i.e. in
+		 * decreasing key order, which every writer shares) and validates each level.
+		 */
+		class predecessor_locks
+		{
+		public:
+			template < typename Validator >
+			bool
+			acquire(
+				const std::size_t top_level,
+				const std::array< node*, MaxLevel >& predecessors,
+				Validator&& valid )
+			{
+				const node* previous = nullptr;
+
+				for ( std::size_t level = 0; level <= top_level; ++level )
+				{
+					auto* predecessor = predecessors[ level ];
+
+					if ( predecessor != previous )
+					{
+						this->locks[ this->held++ ] = std::unique_lock< std::mutex >( predecessor->lock );
+						previous = predecessor;
+					}
+
+					if ( !valid( predecessor, level ) )
+					{
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+		private:
+			std::array< std::unique_lock< std::mutex >, MaxLevel > locks;
+			std::size_t held = 0;
+		};
+
+		static std::size_t
+		random_level()
+		{
+			thread_local std::uint64_t state =
+				0x9E3779B97F4A7C15ULL ^ std::hash< std::thread::id >()( std::this_thread::get_id() );
+
+			// xorshift64; each level is promoted with probability 1/2.
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+
+			std::size_t level = 0;
+			auto bits = state;
+
+			while ( ( bits & 1 ) && ( level < MaxLevel - 1 ) )
+			{
+				++level;
+				bits >>= 1;
+			}
+
+			return level;
+		}
+
+		/**
+		 * Records the predecessor and successor of the key at every level and
+		 * returns the highest level at which the key was found (or -1).
+		 */
+		int
+		find_links(
+			const Key& key,
+			std::array< node*, MaxLevel >& predecessors,
+			std::array< node*, MaxLevel >& successors ) const
+		{
+			int found = -1;
+			auto* predecessor = this->head;
+
+			for ( auto level = MaxLevel; level-- > 0; )
+			{
+				auto* current = predecessor->next( level ).load( std::memory_order_acquire );
+
+				while ( current && current->key < key )
+				{
+					predecessor = current;
+					current = predecessor->next( level ).load( std::memory_order_acquire );
+				}
+
+				if ( found < 0 && current && current->key == key )
+				{
+					found = static_cast< int >( level );
+				}
+
+				predecessors[ level ] = predecessor;
+				successors[ level ] = current;
+			}
+
+			return found;
+		}
+
+		const node*
+		find_present( const Key& key ) const
+		{
+			const node* predecessor = this->head;
+
+			for ( auto level = MaxLevel; level-- > 0; )
+			{
+				const auto* current = predecessor->next( level ).load( std::memory_order_acquire );
+
+				while ( current && current->key < key )
+				{
+					predecessor = current;
+					current = predecessor->next( level ).load( std::memory_order_acquire );
+				}
+
+				if ( current && current->key == key )
+				{
+					const bool present =
+						current->fully_linked.load( std::memory_order_acquire ) &&
+						!current->marked.load( std::memory_order_acquire );
+
+					return present ? current : nullptr;
+				}
+			}
+
+			return nullptr;
+		}
+
+		/**
+		 * Collects the items in [lower, upper) along with the versions of the nodes
+		 * visited, walking level 0 from the last node before lower that was not
+		 * being erased (an insertion after an erased node may go through another
+		 * node, which the scan would miss). Returns false if a write is linearizing
+		 * at one of the visited nodes or the start is erased in the meantime.
+		 */
+		bool
+		collect(
+			const Key& lower,
+			const Key& upper,
+			std::vector< std::pair< Key, Value > >& items,
+			std::vector< std::pair< const node*, std::uint64_t > >& visited ) const
+		{
+			items.clear();
+			visited.clear();
+
+			const node* predecessor = this->head;
+			const node* start = this->head;
+
+			for ( auto level = MaxLevel; level-- > 0; )
+			{
+				const auto* current = predecessor->next( level ).load( std::memory_order_acquire );
+
+				while ( current && current->key < lower )
+				{
+					predecessor = current;
+					start = current->marked.load( std::memory_order_acquire ) ? start : current;
+					current = predecessor->next( level ).load( std::memory_order_acquire );
+				}
+			}
+
+			const auto version = start->version.load();
+
+			if ( ( version & 1 ) || start->marked.load() )
+			{
+				return false;
+			}
+
+			visited.emplace_back( start, version );
+
+			for ( auto* current = start->next( 0 ).load( std::memory_order_acquire );
+				current && current->key < upper;
+				current = current->next( 0 ).load( std::memory_order_acquire ) )
+			{
+				const auto current_version = current->version.load();
+
+				if ( current_version & 1 )
+				{
+					return false;
+				}
+
+				visited.emplace_back( current, current_version );
+
+				if ( !( current->key < lower ) &&
+					current->fully_linked.load( std::memory_order_acquire ) &&
+					!current->marked.load( std::memory_order_acquire ) )
+				{
+					items.emplace_back( current->key, current->value );
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * Whether no write linearized at the visited nodes since they were collected.
+		 */
+		static bool
+		validate( const std::vector< std::pair< const node*, std::uint64_t > >& visited )
+		{
+			for ( const auto& entry : visited )
+			{
+				if ( entry.first->version.load() != entry.second )
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		static void
+		emit(
+			const std::vector< std::pair< Key, Value > >& items,
+			const std::function< void( const Key&, const Value& ) >& callback )
+		{
+			for ( const auto& item : items )
+			{
+				callback( item.first, item.second );
+			}
+		}
+
+		/**
+		 * Brackets the linearization point of a write by making the version of the
+		 * changed node odd, so range scans that visited it can detect the write.
+		 * The changed node is locked by the writer.
+		 */
+		void
+		begin_write( node& changed ) const
+		{
+			while ( true )
+			{
+				changed.version.fetch_add( 1 );
+
+				if ( this->blocking_scans.load() == 0 )
+				{
+					return;
+				}
+
+				changed.version.fetch_add( 1 );
+
+				while ( this->blocking_scans.load() != 0 )
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		static void
+		end_write( node& changed )
+		{
+			changed.version.fetch_add( 1 );
+		}
+
+		/**
+		 * Takes an idle slot (the one this thread used last if possible) and
+		 * announces the current epoch in it. Waits if every slot is taken.
+		 */
+		epoch_slot&
+		enter_epoch() const
+		{
+			thread_local std::size_t hint = std::hash< std::thread::id >()( std::this_thread::get_id() );
+
+			for ( auto index = hint; ; ++index )
+			{
+				auto& slot = this->slots[ index % EPOCH_SLOTS ];
+				bool idle = false;
+
+				if ( !slot.taken.load( std::memory_order_relaxed ) &&
+					slot.taken.compare_exchange_strong( idle, true, std::memory_order_acquire ) )
+				{
+					hint = index % EPOCH_SLOTS;
+
+					// Retry if the epoch advanced before the announcement was visible.
+					while ( true )
+					{
+						const auto current = this->epoch.load();
+
+						slot.epoch.store( current );
+
+						if ( this->epoch.load() == current )
+						{
+							return slot;
+						}
+					}
+				}
+
+				if ( ( index + 1 - hint ) % EPOCH_SLOTS == 0 )
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		void
+		retire( node* victim )
+		{
+			victim->retired_epoch = this->epoch.load();
+			victim->retired_next = this->retired.load( std::memory_order_relaxed );
+
+			while ( !this->retired.compare_exchange_weak(
+				victim->retired_next,
+				victim,
+				std::memory_order_release,
+				std::memory_order_relaxed ) )
+			{
+			}
+
+			this->retired_count.fetch_add( 1, std::memory_order_relaxed );
+
+			if ( ( this->retirements.fetch_add( 1, std::memory_order_relaxed ) + 1 ) % RECLAIM_INTERVAL == 0 )
+			{
+				this->reclaim();
+			}
+		}
+
+		/**
+		 * Advances the epoch if every operation in progress has announced the current
+		 * one, then frees the nodes retired two epochs ago or earlier.
+		 */
+		void
+		reclaim()
+		{
+			std::unique_lock< std::mutex > lock( this->reclaim_lock, std::try_to_lock );
+
+			if ( !lock.owns_lock() )
+			{
+				return;
+			}
+
+			auto current = this->epoch.load();
+			bool caught_up = true;
+
+			for ( const auto& slot : this->slots )
+			{
+				const auto announced = slot.epoch.load();
+
+				caught_up = caught_up && ( announced == QUIESCENT || announced == current );
+			}
+
+			if ( caught_up )
+			{
+				current = this->epoch.fetch_add( 1 ) + 1;
+			}
+
+			auto* pending = this->retired.exchange( nullptr, std::memory_order_acquire );
+			node* kept = nullptr;
+			node* kept_last = nullptr;
+
+			while ( pending )
+			{
+				auto* next = pending->retired_next;
+
+				if ( pending->retired_epoch + 2 <= current )
+				{
+					node::destroy( pending );
+					this->retired_count.fetch_sub( 1, std::memory_order_relaxed );
+				}
+				else
+				{
+					pending->retired_next = kept;
+					kept_last = kept ? kept_last : pending;
+					kept = pending;
+				}
+
+				pending = next;
+			}
+
+			if ( kept )
+			{
+				kept_last->retired_next = this->retired.load( std::memory_order_relaxed );
+
+				while ( !this->retired.compare_exchange_weak(
+					kept_last->retired_next,
+					kept,
+					std::memory_order_release,
+					std::memory_order_relaxed ) )
+				{
+				}
+			}
+		}
+
+		node* const head;
+
+		std::atomic< std::size_t > count { 0 };
+		std::atomic< node* > retired { nullptr };
+		std::atomic< std::size_t > retired_count { 0 };
+		std::atomic< std::size_t > retirements { 0 };
+
+		mutable std::array< epoch_slot, EPOCH_SLOTS > slots;
+		mutable std::atomic< std::uint64_t > epoch { 0 };
+		std::mutex reclaim_lock;
+
+		mutable std::atomic< std::uint32_t > blocking_scans { 0 };
+	};
+}
@@ -17,13 +17,17 @@ namespace dsa
      * Default constructor
      */
     Node::Node()
-        : id(0),
+        :
+#ifndef DSA_TBST_COMPACT_NODE
+        id(0),
         depth(0),
         parentNode(nullptr),
+#endif
         leftNode(nullptr),
         rightNode(nullptr),
         leftNodeType(THREAD),
-        rightNodeType(THREAD)
+        rightNodeType(THREAD),
+        balanceFactor(0)
     {
     }
 
@@ -34,34 +38,70 @@ namespace dsa
      * @param source Node to copy
      */
     Node::Node(const Node& source)
-        : id(0),
+        :
+#ifndef DSA_TBST_COMPACT_NODE
+        id(0),
         depth(0),
+#endif
         data(source.data),
+#ifndef DSA_TBST_COMPACT_NODE
         parentNode(nullptr),
+#endif
         leftNode(nullptr),
         rightNode(nullptr),
         leftNodeType(THREAD),
-        rightNodeType(THREAD)
+        rightNodeType(THREAD),
+        balanceFactor(0)
     {
     }
 
     /**
-     * Node(const string& token)
+     * Node(const Node& source, TokenArena& arena)
+     *
+     * Constructor copying a node into another tree
+     * @param source Node to copy
+     * @param arena Arena interning the token of the copy
+     */
+    Node::Node(const Node& source, TokenArena& arena)
+        :
+#ifndef DSA_TBST_COMPACT_NODE
+        id(0),
+        depth(0),
+#endif
+        data(source.data, arena),
+#ifndef DSA_TBST_COMPACT_NODE
+        parentNode(nullptr),
+#endif
+        leftNode(nullptr),
+        rightNode(nullptr),
+        leftNodeType(THREAD),
+        rightNodeType(THREAD),
+        balanceFactor(0)
+    {
+    }
+
+    /**
+     * Node(const string& token, TokenArena& arena)
      *
      * Constructor
      *
      * @param token Input token to copy & store.
+     * @param arena Arena interning the token.
      */
-    Node::Node(const std::string& token)
-        : id(0),
+    Node::Node(const std::string& token, TokenArena& arena)
+        :
+#ifndef DSA_TBST_COMPACT_NODE
+        id(0),
         depth(0),
         parentNode(nullptr),
+#endif
         leftNode(nullptr),
         rightNode(nullptr),
         leftNodeType(THREAD),
-        rightNodeType(THREAD)
+        rightNodeType(THREAD),
+        balanceFactor(0)
     {
-        data.setToken(token);
+        data.setToken(token, arena);
     }
 
     /**
@@ -77,9 +117,11 @@ namespace dsa
     bool Node::operator==(const Node& target) const
     {
         return
+#ifndef DSA_TBST_COMPACT_NODE
             (id == target.id) &&
             (depth == target.depth) &&
-            (data == target.data.getToken()) &&
+#endif
+            (data.compare(target.data) == 0) &&
             (data.getFrequency() == target.data.getFrequency());
     }
 
@@ -96,9 +138,11 @@ namespace dsa
     bool Node::operator!=(const Node& target) const
     {
         return
+#ifndef DSA_TBST_COMPACT_NODE
             (id != target.id) ||
             (depth != target.depth) ||
-            (data != target.data.getToken()) ||
+#endif
+            (data.compare(target.data) != 0) ||
             (data.getFrequency() != target.data.getFrequency());
     }
 
@@ -116,6 +160,7 @@ namespace dsa
     {
         if (details)
         {
+#ifndef DSA_TBST_COMPACT_NODE
             output << "\tId: " << id << "\t";
             data.show(output, true);
             output << ", Depth: " << depth;
@@ -123,6 +168,10 @@ namespace dsa
             {
                 output << ", Parent: " << parentNode->data.getToken().c_str();
             }
+#else
+            output << "\t";
+            data.show(output, true);
+#endif
             if (leftNode != nullptr)
             {
                 output << ", Left: " << leftNode->data.getToken().c_str();
@@ -6,6 +6,9 @@
 
 #include "tbst_node_data.hpp"
 
+// Define DSA_TBST_COMPACT_NODE to drop the debugging fields of the nodes
+// (id, depth and parentNode), so that more nodes fit in the cache.
+
 namespace dsa
 {
     // Node link types
@@ -21,7 +24,8 @@ namespace dsa
     {
         Node();
         Node(const Node& source);
-        Node(const std::string& token);
+        Node(const Node& source, TokenArena& arena);
+        Node(const std::string& token, TokenArena& arena);
 
         // Operators
         bool operator==(const Node& target) const;
@@ -31,13 +35,19 @@ namespace dsa
         void show(std::ostream& output, bool details) const;
 
         // Node data
+#ifndef DSA_TBST_COMPACT_NODE
         int id;                     // Node ID (indicating insertion order)
-        int depth;                  // Node depth
+        int depth;                  // Node depth (not kept when self-balancing)
+#endif
         nodeData data;              // Node data
-        struct Node* parentNode;    // Parent node (used only for debugging)
+#ifndef DSA_TBST_COMPACT_NODE
+        struct Node* parentNode;    // Parent node (used only for debugging;
+                                    // not kept when self-balancing)
+#endif
         struct Node* leftNode;      // Left child/thread
         struct Node* rightNode;     // Right child/thread
         bool leftNodeType;          // Left node type: Thread vs. Child
         bool rightNodeType;         // Right node type: Thread vs. Child
+        signed char balanceFactor;  // Right minus left subtree height (AVL)
     };
 }
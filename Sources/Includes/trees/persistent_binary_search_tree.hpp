@@ -0,0 +1,333 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * A persistent (path-copying) binary search tree.
+ *
+ * Every version of the tree is immutable. insert() and erase() leave the current
+ * version untouched and return a new version which copies only the nodes on the
+ * path to the modified key; every other subtree is shared through reference
+ * counting. Taking a snapshot is therefore a constant-time copy, and an update
+ * allocates as many nodes as the depth of the modified key.
+ *
+ * Snapshots can be handed to other threads: nodes are never modified once
+ * published and their reference counts are atomic.
+ */
+
+#pragma once
+
+#include "persistent_binary_search_tree_node.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	template <
+		typename Key,
+		typename Value >
+	class persistent_binary_search_tree
+	{
+
+	public:
+		using node_type = typename persistent_binary_search_tree_node< Key, Value >::link_type;
+
+		persistent_binary_search_tree() = default;
+		~persistent_binary_search_tree() noexcept = default;
+
+		persistent_binary_search_tree( const persistent_binary_search_tree& other ) = default;
+		persistent_binary_search_tree( persistent_binary_search_tree&& other ) noexcept = default;
+
+		persistent_binary_search_tree& operator=( const persistent_binary_search_tree& rhs ) = default;
+		persistent_binary_search_tree& operator=( persistent_binary_search_tree&& rhs ) noexcept = default;
+
+		/**
+		 * Two versions are equal when they hold the same keys and values.
+		 */
+		bool
+		operator==( const persistent_binary_search_tree& other ) const
+		{
+			if ( this->root == other.root )
+			{
+				return true;
+			}
+
+			if ( this->nodes != other.nodes )
+			{
+				return false;
+			}
+
+			std::vector< std::pair< Key, Value > > items;
+			items.reserve( this->nodes );
+
+			this->inorder( [&items]( node_type const & node )
+			{
+				items.emplace_back( node->key, node->value );
+			});
+
+			auto item = std::cbegin( items );
+			bool equal = true;
+
+			other.inorder( [&item, &equal]( node_type const & node )
+			{
+				equal = equal && ( item->first == node->key ) && ( item->second == node->value );
+				++item;
+			});
+
+			return equal;
+		}
+
+		bool
+		operator!=( const persistent_binary_search_tree& other ) const
+		{
+			return !( *this == other );
+		}
+
+		/**
+		 * Returns a new version holding the key. The current version is returned
+		 * as-is if the key is already present.
+		 */
+		persistent_binary_search_tree
+		insert(
+			const Key key,
+			const Value value ) const
+		{
+			std::vector< step > path;
+			auto current = this->root;
+
+			while ( current )
+			{
+				if ( key > current->key )
+				{
+					path.push_back( { current, true } );
+					current = current->right;
+				}
+				else if ( key < current->key )
+				{
+					path.push_back( { current, false } );
+					current = current->left;
+				}
+				else
+				{
+					return *this;
+				}
+			}
+
+			auto created = create_node( key, value, nullptr, nullptr );
+
+			return persistent_binary_search_tree( copy_path( path, std::move( created ) ), this->nodes + 1 );
+		}
+
+		/**
+		 * Returns a new version without the key. The current version is returned
+		 * as-is if the key is absent.
+		 */
+		persistent_binary_search_tree
+		erase( const Key key ) const
+		{
+			std::vector< step > path;
+			auto current = this->root;
+
+			while ( current && key != current->key )
+			{
+				const bool right = ( key > current->key );
+
+				path.push_back( { current, right } );
+				current = right ? current->right : current->left;
+			}
+
+			if ( !current )
+			{
+				return *this;
+			}
+
+			node_type replacement;
+
+			if ( !current->left || !current->right )
+			{
+				replacement = current->left ? current->left : current->right;
+			}
+			else
+			{
+				// Replace the key with the in-order predecessor, copying the right
+				// spine of the left subtree down to the predecessor.
+				std::vector< step > spine;
+				auto max = current->left;
+
+				while ( max->right )
+				{
+					spine.push_back( { max, true } );
+					max = max->right;
+				}
+
+				replacement = create_node(
+					max->key,
+					max->value,
+					copy_path( spine, max->left ),
+					current->right );
+			}
+
+			return persistent_binary_search_tree( copy_path( path, std::move( replacement ) ), this->nodes - 1 );
+		}
+
+		bool
+		contains( const Key key ) const
+		{
+			return this->find( key ) != nullptr;
+		}
+
+		/**
+		 * Returns the value mapped to the key, or nullptr if the key is absent.
+		 * The pointer remains valid for as long as this version is alive.
+		 */
+		const Value*
+		find( const Key key ) const
+		{
+			const auto* current = this->root.get();
+
+			while ( current )
+			{
+				if ( key == current->key )
+				{
+					return &current->value;
+				}
+
+				current = ( key > current->key ) ? current->right.get() : current->left.get();
+			}
+
+			return nullptr;
+		}
+
+		std::size_t
+		height() const
+		{
+			std::size_t height = 0;
+			std::vector< std::pair< const typename node_type::element_type*, std::size_t > > pending;
+
+			if ( this->root )
+			{
+				pending.emplace_back( this->root.get(), 0 );
+			}
+
+			while ( !pending.empty() )
+			{
+				const auto current = pending.back();
+				pending.pop_back();
+
+				height = std::max( height, current.second );
+
+				if ( current.first->left )
+				{
+					pending.emplace_back( current.first->left.get(), current.second + 1 );
+				}
+
+				if ( current.first->right )
+				{
+					pending.emplace_back( current.first->right.get(), current.second + 1 );
+				}
+			}
+
+			return height;
+		}
+
+		bool
+		empty() const
+		{
+			return ( !this->root && !this->nodes );
+		}
+
+		auto
+		size() const
+		{
+			return this->nodes;
+		}
+
+		/**
+		 * The root of this version; exposed so callers can observe structural sharing.
+		 */
+		node_type const &
+		root_node() const noexcept
+		{
+			return this->root;
+		}
+
+		void
+		inorder( std::function< void( node_type const & ) >&& callback ) const
+		{
+			std::vector< const node_type* > pending;
+			const auto* current = &this->root;
+
+			while ( *current || !pending.empty() )
+			{
+				while ( *current )
+				{
+					pending.push_back( current );
+					current = &( *current )->left;
+				}
+
+				const auto* node = pending.back();
+				pending.pop_back();
+
+				callback( *node );
+
+				current = &( *node )->right;
+			}
+		}
+
+	private:
+
+		struct step
+		{
+			node_type node;
+			bool right;
+		};
+
+		persistent_binary_search_tree(
+			node_type input_root,
+			const std::size_t input_nodes ) :
+			root( std::move( input_root ) ),
+			nodes( input_nodes )
+		{
+		}
+
+		static node_type
+		create_node(
+			const Key key,
+			const Value value,
+			node_type left,
+			node_type right )
+		{
+			return std::make_shared< persistent_binary_search_tree_node< Key, Value > >(
+				key,
+				value,
+				std::move( left ),
+				std::move( right ) );
+		}
+
+		/**
+		 * Rebuilds the recorded path bottom-up on top of a new subtree, sharing
+		 * every sibling subtree that is not on the path.
+		 */
+		static node_type
+		copy_path(
+			const std::vector< step >& path,
+			node_type subtree )
+		{
+			for ( auto it = path.crbegin(); it != path.crend(); ++it )
+			{
+				const auto& original = it->node;
+
+				subtree = it->right ?
+					create_node( original->key, original->value, original->left, std::move( subtree ) ) :
+					create_node( original->key, original->value, std::move( subtree ), original->right );
+			}
+
+			return subtree;
+		}
+
+		node_type root;
+		std::size_t nodes = 0;
+	};
+}
@@ -0,0 +1,117 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dsa
+{
+	/**
+	 * An immutable, reference-counted binary search tree node. Subtrees are
+	 * shared between every version of the tree that did not modify them.
+	 */
+	template <
+		typename Key,
+		typename Value >
+	struct persistent_binary_search_tree_node
+	{
+		using link_type = std::shared_ptr< const persistent_binary_search_tree_node >;
+
+		persistent_binary_search_tree_node(
+			Key input_key,
+			Value input_value,
+			link_type input_left,
+			link_type input_right ) :
+			key( std::move( input_key ) ),
+			value( std::move( input_value ) ),
+			left( std::move( input_left ) ),
+			right( std::move( input_right ) )
+		{
+		}
+
+		/**
+		 * Releasing the last reference to a long chain of nodes would otherwise
+		 * recurse once per node. Uniquely owned descendants are detached and
+		 * released iteratively instead.
+		 */
+		~persistent_binary_search_tree_node()
+		{
+			if ( !this->owns_descendants() )
+			{
+				return;
+			}
+
+			std::vector< link_type > pending;
+
+			detach( this->left, pending );
+			detach( this->right, pending );
+
+			while ( !pending.empty() )
+			{
+				auto node = std::move( pending.back() );
+				pending.pop_back();
+
+				// Nodes are never created const, so detaching the children of a
+				// node that is about to be released is well-defined.
+				auto& releasing = const_cast< persistent_binary_search_tree_node& >( *node );
+
+				detach( releasing.left, pending );
+				detach( releasing.right, pending );
+			}
+		}
+
+		persistent_binary_search_tree_node( const persistent_binary_search_tree_node& ) = delete;
+		persistent_binary_search_tree_node( persistent_binary_search_tree_node&& ) = delete;
+
+		persistent_binary_search_tree_node& operator=( const persistent_binary_search_tree_node& ) = delete;
+		persistent_binary_search_tree_node& operator=( persistent_binary_search_tree_node&& ) = delete;
+
+		bool
+		operator==( const persistent_binary_search_tree_node& rhs ) const
+		{
+			return ( this->value == rhs.value );
+		}
+
+		bool
+		operator!=( const persistent_binary_search_tree_node& rhs ) const
+		{
+			return !( *this == rhs );
+		}
+
+		const Key key;
+		const Value value;
+
+		link_type left;
+		link_type right;
+
+	private:
+		bool
+		owns_descendants() const noexcept
+		{
+			const auto unique_parent = []( const link_type& link )
+			{
+				return link && link.use_count() == 1 && ( link->left || link->right );
+			};
+
+			return unique_parent( this->left ) || unique_parent( this->right );
+		}
+
+		static void
+		detach(
+			link_type& link,
+			std::vector< link_type >& pending )
+		{
+			if ( link && link.use_count() == 1 )
+			{
+				pending.push_back( std::move( link ) );
+			}
+
+			link.reset();
+		}
+	};
+}
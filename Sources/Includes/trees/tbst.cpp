@@ -4,22 +4,133 @@
  * This file contains the methods associated with the following classes:
  *      ThreadedBinarySearchTree    : class implementing the actual TBST
  *      TreeIterator                : class implementing the TBST iterator
+ *      TraversalIterator           : class implementing the traversal iterator
+ *      TraversalRange              : class implementing the traversal range
+ *      MatchIterator               : class implementing the search iterator
+ *      MatchRange                  : class implementing the search range
  */
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DSA_TBST_HAS_MMAP
+#endif
 
 #include "tbst.hpp"
 
 namespace dsa
 {
-    // Minimum number of nodes required for compressing the tree
-    const int COMPRESSION_MIN_NODES = 3;
+    // Maximum height of a self-balancing tree (AVL trees of 2^31 nodes are
+    // less than 45 levels high)
+    const int AVL_MAX_HEIGHT = 64;
+
+    // Snapshot format: magic, version and tokens count, followed by the
+    // tokens in order, each one front-coded against the previous one:
+    // shared prefix length, suffix length, suffix, frequency.
+    // Integers are stored as LEB128 varints.
+    const char SNAPSHOT_MAGIC[] = { 'T', 'B', 'S', 'T' };
+    const int SNAPSHOT_VERSION = 1;
+    const int SNAPSHOT_MIN_ENTRY_SIZE = 3;          // bytes per token, at least
+    const size_t SNAPSHOT_BUFFER_SIZE = 1 << 16;    // bytes per write
 
     using namespace std;
 
+    namespace
+    {
+        /**
+         * MappedFile
+         *
+         * Read-only view of a whole file: memory-mapped where supported,
+         * otherwise read into memory with a single bulk read.
+         */
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const string& path);
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool isOpen() const { return opened; }
+            const char* data() const { return bytes; }
+            size_t size() const { return length; }
+
+        private:
+            const char* bytes = nullptr;
+            size_t length = 0;
+            bool opened = false;
+#ifdef DSA_TBST_HAS_MMAP
+            bool mapped = false;
+#else
+            vector<char> buffer;
+#endif
+        };
+
+        /**
+         * TokenCount
+         *
+         * Occurrences of a token and the offset of its first occurrence.
+         */
+        struct TokenCount
+        {
+            int frequency = 0;
+            size_t firstOffset = 0;
+        };
+
+        using TokenCounts = unordered_map<string_view, TokenCount>;
+
+        /**
+         * SnapshotLoader
+         *
+         * Decoder rebuilding a balanced threaded tree from a snapshot. Tokens
+         * are decoded in order while the tree is built in order, so no token
+         * is ever compared.
+         */
+        class SnapshotLoader
+        {
+        public:
+            SnapshotLoader(
+                const char* data, size_t size, bool trackParents, NodePool& pool);
+
+            bool readHeader(int& count);
+            Node* build(int count, int depth, int& height);
+            bool isComplete() const { return valid && (position == end); }
+
+        private:
+            bool readVarint(uint64_t& value);
+            Node* readNode();
+
+            const char* position;
+            const char* end;
+            bool valid;
+            bool parents;       // whether depths and parents are tracked
+            NodePool& nodes;    // storage of the nodes
+            Node* previous;     // previous node (in order)
+            int nextId;
+            string token;       // previous token, then the current one
+        };
+    }
+
     // Function prototypes
     static bool isTokenChar(char ch);
+    static Node*& childLink(Node* node, bool right);
+    static bool& linkType(Node* node, bool right);
+    static Node* rotate(Node* node, bool right);
+    static void countTokens(
+        const char* data, size_t first, size_t last, TokenCounts& counts);
+    static void appendVarint(string& buffer, uint64_t value);
 
     /**
      * ThreadedBinarySearchTree()
@@ -29,7 +140,25 @@ namespace dsa
     ThreadedBinarySearchTree::ThreadedBinarySearchTree()
         : rootNode(nullptr),
           treeSize(0),
-          treeHeight(0)
+          treeHeight(0),
+          selfBalancing(false),
+          frequencyIndexValid(false)
+    {
+    }
+
+    /**
+     * ThreadedBinarySearchTree(bool balancing)
+     *
+     * Constructor
+     * @param balancing Whether the tree keeps itself balanced (AVL) on every
+     *                  insertion and removal
+     */
+    ThreadedBinarySearchTree::ThreadedBinarySearchTree(bool balancing)
+        : rootNode(nullptr),
+          treeSize(0),
+          treeHeight(0),
+          selfBalancing(balancing),
+          frequencyIndexValid(false)
     {
     }
 
@@ -43,25 +172,15 @@ namespace dsa
         const ThreadedBinarySearchTree& source)
         : rootNode(nullptr),
           treeSize(0),
-          treeHeight(0)
+          treeHeight(0),
+          selfBalancing(source.selfBalancing),
+          frequencyIndexValid(false)
     {
-        Node** nodesList = source.preorderTraverse();
-
-        if (nodesList != nullptr)
+        // Inserting in pre-order reproduces the shape of the source tree
+        for (Node* node : source.traverse(PREORDER))
         {
-            // We sort the node by ID to ensure that we insert data in the
-            // same order as in the source tree
-
-            // Sort::quickSort(BY_ID, nodesList, source.getNodesCount());
-
-            for (int i = 0; i < source.getNodesCount(); i++)
-            {
-                const Node* list = nodesList[i];
-                insert(*list);
-            }
+            insert(*node);
         }
-
-        delete [] nodesList;
     }
 
 
@@ -72,7 +191,7 @@ namespace dsa
      */
     ThreadedBinarySearchTree::~ThreadedBinarySearchTree()
     {
-        destroy(rootNode);
+        nodePool.clear();
     }
 
     /**
@@ -105,6 +224,20 @@ namespace dsa
         return (treeSize > 0) && (treeSize == treeHeight);
     }
 
+    /**
+     * isSelfBalancing() const
+     *
+     * Method checking whether the tree keeps itself balanced.
+     *
+     * @pre None
+     * @post Checks the balancing mode of the tree
+     * @return True if the tree is self-balancing (AVL); false otherwise
+     */
+    bool ThreadedBinarySearchTree::isSelfBalancing() const
+    {
+        return selfBalancing;
+    }
+
     /**
      * getNodesCount() const
      *
@@ -136,14 +269,17 @@ namespace dsa
     /**
      * clear()
      *
-     * Method destroying all the nodes in the tree and initializing its properties
+     * Method destroying all the nodes in the tree and initializing its properties.
+     * The nodes are released all at once by the node pool.
      *
      * @pre None
      * @post Tree is left empty
      */
     void ThreadedBinarySearchTree::clear()
     {
-        destroy(rootNode);
+        frequencyIndex.clear();
+        frequencyIndexValid = false;
+        nodePool.clear();
         rootNode = nullptr;
         treeSize = 0;
         treeHeight = 0;
@@ -156,14 +292,18 @@ namespace dsa
      * 1. Tree is transformed into a vine (i.e. a linear structure resembling a
      * linked list) by use of rotations. 
      * 2. Vine is transformed back into a balanced tree.
+     * A self-balancing tree is always balanced and is left untouched.
      *
      * @pre Tree is not empty
      * @post Tree is balanced
      */
     void ThreadedBinarySearchTree::balance()
     {
-        treeToVine();
-        vineToTree();
+        if (!selfBalancing)
+        {
+            treeToVine();
+            vineToTree();
+        }
     }
 
     /**
@@ -172,13 +312,14 @@ namespace dsa
      * Method for transforming the tree into a vine by use of rotations.
      * Vine is a degenerate binary tree resembling a linked list, in which
      * each node has at most one child.
+     * A self-balancing tree cannot be degenerated and is left untouched.
      *
      * @pre Tree is not empty
      * @post Tree is transformed into a Vine
      */
     void ThreadedBinarySearchTree::treeToVine()
     {
-        if (!isEmpty())
+        if (!isEmpty() && !selfBalancing)
         {
             Node* current = getFirst();
 		    bool run = (current != nullptr);
@@ -205,7 +346,7 @@ namespace dsa
             rootNode = current;
 
             // Reset the nodes depths and parents
-            init(nullptr);
+            init();
         }
     }
 
@@ -223,7 +364,7 @@ namespace dsa
      */
     void ThreadedBinarySearchTree::vineToTree()
     {
-        if (isVine())
+        if (isVine() && !selfBalancing)
         {
             int leaves = treeSize + 1;  // Nodes in incomplete bottom level (if any)
 		    bool run = true;
@@ -273,7 +414,7 @@ namespace dsa
             }
 
             // Reset the nodes depths and parents
-            init(nullptr);
+            init();
         }
     }
 
@@ -335,11 +476,91 @@ namespace dsa
         return nullptr;
     }
 
+    /**
+     * lowerBound(const string& token) const
+     *
+     * Method searching for the node holding the first token that is not
+     * lower than the input token.
+     *
+     * @param token Data to search for
+     * @pre None
+     * @post Returns the lower bound node
+     * @return Node on success; NULL if every token is lower
+     */
+    Node* ThreadedBinarySearchTree::lowerBound(const string& token) const
+    {
+        Node* bound = nullptr;
+        Node* current = rootNode;
+
+        while (current != nullptr)
+        {
+            if (current->data.compare(token) >= 0)
+            {
+                // Candidate found; look for a lower one on the left branch
+                bound = current;
+                current = (current->leftNodeType == CHILD) ?
+                    current->leftNode : nullptr;
+            }
+            else
+            {
+                current = (current->rightNodeType == CHILD) ?
+                    current->rightNode : nullptr;
+            }
+        }
+
+        return bound;
+    }
+
+    /**
+     * prefix(const string& token, int limit) const
+     *
+     * Method searching for the nodes holding the tokens that start with the
+     * input token, in order. The first match is located in O(log n) (on a
+     * balanced tree); the others are reached through the threads as the
+     * range is iterated.
+     *
+     * @param token Prefix to search for
+     * @param limit Maximum number of matches (NO_LIMIT for all)
+     * @pre None
+     * @post Returns the matches
+     * @return Lazy range of matching nodes
+     */
+    MatchRange ThreadedBinarySearchTree::prefix(
+        const string& token,
+        int limit) const
+    {
+        return MatchRange(this, lowerBound(token), token, true, limit);
+    }
+
+    /**
+     * range(const string& low, const string& high, int limit) const
+     *
+     * Method searching for the nodes holding the tokens in [low, high), in
+     * order. The first match is located in O(log n) (on a balanced tree);
+     * the others are reached through the threads as the range is iterated.
+     *
+     * @param low Lowest token to match
+     * @param high Token bounding the matches (not matched)
+     * @param limit Maximum number of matches (NO_LIMIT for all)
+     * @pre None
+     * @post Returns the matches
+     * @return Lazy range of matching nodes
+     */
+    MatchRange ThreadedBinarySearchTree::range(
+        const string& low,
+        const string& high,
+        int limit) const
+    {
+        return MatchRange(this, lowerBound(low), high, false, limit);
+    }
+
     /**
      * insert(const string& token)
      *
      * Method inserting a new token into the tree.
-     * If the token exists, then it only increments its frequency.
+     * If the token exists, then it only increments its frequency; the token
+     * is looked up first so that a node (and its interned token) is only
+     * created for a new token.
      *
      * @param token Data to insert
      * @pre token is valid (not empty)
@@ -348,18 +569,40 @@ namespace dsa
      */
     bool ThreadedBinarySearchTree::insert(const string& token)
     {
-        bool success = !token.empty();
+        return insert(token, 1);
+    }
+
+    /**
+     * insert(const string& token, int frequency)
+     *
+     * Method inserting a token that occurred a given number of times.
+     * If the token exists, then its frequency is increased by that number.
+     *
+     * @param token Data to insert
+     * @param frequency Number of occurrences of the token
+     * @pre token is valid (not empty); frequency is positive
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ThreadedBinarySearchTree::insert(const string& token, int frequency)
+    {
+        bool success = !token.empty() && (frequency > 0);
 
         if (success)
         {
-            Node* newNode = new Node(token);
+            Node* existing = find(token);
 
-            // If insertHelper returns false, it means that we found
-            // a duplicate whose frequency was incremented.
-            // The operation is still a success
-            if (!insertHelper(newNode))
+            if (existing != nullptr)
+            {
+                existing->data.increaseFrequency(frequency);
+                frequencyIndexValid = false;
+            }
+            else
             {
-                delete newNode;
+                Node* newNode = nodePool.create(token);
+
+                newNode->data.increaseFrequency(frequency - 1);
+                insertHelper(newNode);
             }
         }
 
@@ -379,18 +622,15 @@ namespace dsa
      */
     bool ThreadedBinarySearchTree::insert(const Node& node)
     {
-        Node* newNode = new Node(node);
+        Node* newNode = nodePool.create(node);
         bool success = newNode->data.isValid();
 
-        if (success)
+        // If insertHelper returns false, it means that we found
+        // a duplicate whose frequency was incremented.
+        // The operation is still a success
+        if (!success || !insertHelper(newNode))
         {
-            // If insertHelper returns false, it means that we found
-            // a duplicate whose frequency was incremented.
-            // The operation is still a success
-            if (!insertHelper(newNode))
-            {
-                delete newNode;
-            }
+            nodePool.release(newNode);
         }
 
         return success;
@@ -408,6 +648,13 @@ namespace dsa
      */
     bool ThreadedBinarySearchTree::remove(const string& token)
     {
+        frequencyIndexValid = false;
+
+        if (selfBalancing)
+        {
+            return removeBalanced(token);
+        }
+
         bool rightLink = false;    // navigation direction: false/true => left/right
         Node* current = nullptr;   // node to remove
         Node* parent = nullptr;    // parent of node to remove
@@ -619,6 +866,7 @@ namespace dsa
             {
                 // Delete node to remove, decrement size and reset parent links
                 treeSize--;
+#ifndef DSA_TBST_COMPACT_NODE
                 if (current->leftNodeType == CHILD)
                 {
                     current->leftNode->parentNode = nullptr;
@@ -627,11 +875,12 @@ namespace dsa
                 {
                     current->rightNode->parentNode = nullptr;
                 }
+#endif
 
-                delete current;
+                nodePool.release(current);
 
                 // Reset the nodes depths and parents
-                init(nullptr);
+                init();
             }
         }
 
@@ -749,7 +998,7 @@ namespace dsa
     }
 
     /**
-     * begin()
+     * begin() const
      *
      * Method returning a tree iterator initialized for incremental navigation.
      *
@@ -757,7 +1006,7 @@ namespace dsa
      * @post Constructs and initialize iterator for forward navigation.
      * @return Initialized iterator
      */
-    TreeIterator ThreadedBinarySearchTree::begin()
+    TreeIterator ThreadedBinarySearchTree::begin() const
     {
         TreeIterator iter(this);
         iter.currentNode = getFirst();
@@ -765,7 +1014,7 @@ namespace dsa
     }
 
     /**
-     * rbegin()
+     * rbegin() const
      *
      * Method returning a tree iterator initialized for decremental navigation.
      *
@@ -773,7 +1022,7 @@ namespace dsa
      * @post Constructs and initialize iterator for backward navigation.
      * @return Initialized iterator
      */
-    TreeIterator ThreadedBinarySearchTree::rbegin()
+    TreeIterator ThreadedBinarySearchTree::rbegin() const
     {
         TreeIterator iter(this);
         iter.currentNode = getLast();
@@ -781,7 +1030,7 @@ namespace dsa
     }
 
     /**
-     * end()
+     * end() const
      *
      * Method returning a tree iterator initialized for incremental navigation
      * and having the position moved beyond the last node.
@@ -790,7 +1039,7 @@ namespace dsa
      * @post Constructs and initialize iterator.
      * @return Initialized iterator
      */
-    TreeIterator ThreadedBinarySearchTree::end()
+    TreeIterator ThreadedBinarySearchTree::end() const
     {
         TreeIterator iter(this);
         iter.currentNode = getNext(getLast());
@@ -798,7 +1047,7 @@ namespace dsa
     }
 
     /**
-     * rend()
+     * rend() const
      *
      * Method returning a tree iterator initialized for decremental navigation
      * and having the position moved beyond the first node.
@@ -807,13 +1056,31 @@ namespace dsa
      * @post Constructs and initialize iterator.
      * @return Initialized iterator
      */
-    TreeIterator ThreadedBinarySearchTree::rend()
+    TreeIterator ThreadedBinarySearchTree::rend() const
     {
         TreeIterator iter(this);
         iter.currentNode = getPrevious(getFirst());
         return iter;
     }
 
+    /**
+     * traverse(int traverseType) const
+     *
+     * Method returning a lazy range over the nodes in the given order.
+     * Pre-order and in-order ranges follow the threads; the post-order range
+     * keeps at most one ancestor per tree level.
+     *
+     * @param traverseType Type of traversal (ITERATIVE, PREORDER, INORDER,
+     *                     POSTORDER)
+     * @pre None
+     * @post Returns range over the tree nodes
+     * @return Traversal range; valid until the tree is modified
+     */
+    TraversalRange ThreadedBinarySearchTree::traverse(int traverseType) const
+    {
+        return TraversalRange(traverseType, rootNode, treeHeight);
+    }
+
     /**
      * inorderIterativeTraverse() const
      *
@@ -826,28 +1093,13 @@ namespace dsa
      */
     Node** ThreadedBinarySearchTree::inorderIterativeTraverse() const
     {
-        Node** nodesList = createNodesList();
-
-        if (nodesList != nullptr)
-        {
-            Node* current = getNext(nullptr);
-            int count = 0;
-
-            while (current != nullptr)
-            {
-                nodesList[count++] = current;
-                current = getNext(current);
-            }
-        }
-
-        return nodesList;
+        return traverseToList(ITERATIVE);
     }
 
     /**
      * preorderTraverse() const
      *
      * Method returning the pre-order traversal list of nodes.
-     * It employs an recursive approach.
      *
      * @pre None
      * @post Returns list of pre-order traversal nodes
@@ -855,22 +1107,13 @@ namespace dsa
      */
     Node** ThreadedBinarySearchTree::preorderTraverse() const
     {
-        Node** nodesList = createNodesList();
-
-        if (nodesList != nullptr)
-        {
-            int count = 0;
-            traverseHelper(PREORDER, rootNode, nodesList, count);
-        }
-
-        return nodesList;
+        return traverseToList(PREORDER);
     }
 
     /**
      * inorderTraverse() const
      *
      * Method returning the in-order traversal list of nodes.
-     * It employs an recursive approach.
      *
      * @pre None
      * @post Returns list of in-order traversal nodes
@@ -878,22 +1121,13 @@ namespace dsa
      */
     Node** ThreadedBinarySearchTree::inorderTraverse() const
     {
-        Node** nodesList = createNodesList();
-
-        if (nodesList != nullptr)
-        {
-            int count = 0;
-            traverseHelper(INORDER, rootNode, nodesList, count);
-        }
-
-        return nodesList;
+        return traverseToList(INORDER);
     }
 
     /**
      * postorderTraverse() const
      *
      * Method returning the post-order traversal list of nodes.
-     * It employs an recursive approach.h.
      *
      * @pre None
      * @post Returns list of post-order traversal nodes
@@ -901,695 +1135,2344 @@ namespace dsa
      */
     Node** ThreadedBinarySearchTree::postorderTraverse() const
     {
-        Node** nodesList = createNodesList();
-
-        if (nodesList != nullptr)
-        {
-            int count = 0;
-            traverseHelper(POSTORDER, rootNode, nodesList, count);
-        }
-
-        return nodesList;
+        return traverseToList(POSTORDER);
     }
 
     /**
-     * operator>>(istream& is, ThreadedBinarySearchTree& tbst)
+     * topK(int k) const
      *
-     * Overloaded operator for populating the tree from an input stream.
+     * Method retrieving the nodes holding the most frequent tokens, by
+     * decreasing frequency (tokens of equal frequency in order). Answered
+     * from the frequency index in O(k) when it is up to date; otherwise the
+     * nodes are streamed through a bounded heap in O(n log k).
      *
-     * @param is Input stream sourcing the data
-     * @param tbst Tree to populate
+     * @param k Maximum number of nodes to retrieve
      * @pre None
-     * @post Tree is filled up with data supplied by input stream.
-     * @return Reference to input stream
+     * @post Returns the most frequent nodes
+     * @return List of at most k nodes
      */
-    istream& operator>>(istream& is, ThreadedBinarySearchTree& tbst)
+    vector<Node*> ThreadedBinarySearchTree::topK(int k) const
     {
-        bool error = false;
-        string data;
+        vector<Node*> nodes;
 
-        while (!error && is.good())
+        if (k <= 0)
         {
-            char ch = static_cast<char>(is.get());
+            return nodes;
+        }
 
-            if (isTokenChar(ch))
+        if (frequencyIndexValid)
+        {
+            size_t count = min(static_cast<size_t>(k), frequencyIndex.size());
+            nodes.assign(frequencyIndex.begin(), frequencyIndex.begin() + count);
+            return nodes;
+        }
+
+        // Heap candidates are ranked by frequency, then by in-order position;
+        // the heap top is the weakest candidate.
+        typedef pair<Node*, int> Candidate;
+        vector<Candidate> heap;
+        auto stronger = [](const Candidate& left, const Candidate& right)
+        {
+            int leftFrequency = left.first->data.getFrequency();
+            int rightFrequency = right.first->data.getFrequency();
+
+            return (leftFrequency > rightFrequency) ||
+                   ((leftFrequency == rightFrequency) &&
+                    (left.second < right.second));
+        };
+        int position = 0;
+
+        heap.reserve(min(k, treeSize));
+
+        for (Node* node : traverse(INORDER))
+        {
+            Candidate candidate(node, position++);
+
+            if (static_cast<int>(heap.size()) < k)
             {
-                // alphanumeric - build the token
-                data.push_back(ch);
+                heap.push_back(candidate);
+                push_heap(heap.begin(), heap.end(), stronger);
             }
-            else
+            else if (stronger(candidate, heap.front()))
             {
-                // We reached a word boundary; insert the token built so far.
-                if (!data.empty())
-                {
-                    // Insert the current token (if any)
-                    if (tbst.insert(data))
-                    {
-                        data.clear();
-                    }
-                    else
-                    {
-                        error = true;
-                    }
-                }
+                pop_heap(heap.begin(), heap.end(), stronger);
+                heap.back() = candidate;
+                push_heap(heap.begin(), heap.end(), stronger);
+            }
+        }
 
-                if (!error &&
-                    (isprint(ch) != 0) &&
-                    (isspace(ch) == 0) &&
-                    (isgraph(ch) == 0))
-                {
-                    // Non white-space delimiter - inserted as a single char
-                    data.push_back(ch);
-                    if (tbst.insert(data))
-                    {
-                        data.clear();
-                    }
-                    else
-                    {
-                        error = true;
-                    }
-                }
+        sort_heap(heap.begin(), heap.end(), stronger);
 
-                if (error)
-                {
-                    cerr << "Failed to insert ";
-                    cerr << data.c_str() << "\r\n";
-                }
-            }
+        nodes.reserve(heap.size());
+        for (const Candidate& candidate : heap)
+        {
+            nodes.push_back(candidate.first);
         }
-        is.clear();
 
-        return is;
+        return nodes;
     }
 
     /**
-     * show(std::ostream& output,  bool details) const
+     * buildFrequencyIndex()
      *
-     * Helper method for pushing the tree information into an output stream.
+     * Method building the frequency index, which lets topK() answer in O(k)
+     * until the tree is modified again. Changes made directly to the data of
+     * returned nodes are not tracked.
      *
-     * @param output Output stream
-     * @param details Whether to display extended info
      * @pre None
-     * @post data is pushed into the stream.
+     * @post The frequency index is up to date
      */
-    void ThreadedBinarySearchTree::show(std::ostream& output,  bool details) const
+    void ThreadedBinarySearchTree::buildFrequencyIndex()
     {
-        output << "Threaded Binary Search Tree: ";
-        output << "size = " << treeSize;
-        output << ", height = " << treeHeight;
-        output << "\r\n";
+        frequencyIndex.clear();
+        frequencyIndex.reserve(treeSize);
 
-        if (details)
+        for (Node* node : traverse(INORDER))
         {
-            Node* current = getNext(nullptr);
+            frequencyIndex.push_back(node);
+        }
 
-            while (current != nullptr)
+        stable_sort(
+            frequencyIndex.begin(),
+            frequencyIndex.end(),
+            [](const Node* left, const Node* right)
             {
-                current->show(output, true);
-                current = getNext(current);
-            }
-            output << "\r\n";
-        }
+                return left->data.getFrequency() > right->data.getFrequency();
+            });
+
+        frequencyIndexValid = true;
     }
 
     /**
-     * show(std::ostream& output, Node** nodesList, bool details) const
+     * hasFrequencyIndex() const
      *
-     * Helper method for pushing the nodes information into an output stream.
+     * Method checking whether the frequency index is up to date.
      *
-     * @param output Output stream
-     * @param nodesList List of nodes to display
-     * @param details Whether to display extended info
-     * @pre List is not NULL or empty
-     * @post data is pushed into the stream.
+     * @pre None
+     * @post Checks the frequency index state
+     * @return True if the index reflects the tree; false otherwise
      */
-    void ThreadedBinarySearchTree::show(
-        std::ostream& output,
-        Node** nodesList,
-        bool details) const
+    bool ThreadedBinarySearchTree::hasFrequencyIndex() const
     {
-        if ((treeSize > 0) && (nodesList != nullptr))
-        {
-            for (int i = 0; i < treeSize; i++)
-            {
-			    if (details)
-			    {
-				    nodesList[i]->show(output, true);
-			    }
-			    else
-			    {
-				    if ((i % NODES_PER_LINE) == 0)
-				    {
-					    if (i > 0)
-					    {
-						    output << "\r\n";
-					    }
-					    output << "\t";
-				    }
-				    nodesList[i]->show(output, false);
-				    output << " ";
-			    }
-            }
-        }
+        return frequencyIndexValid;
     }
 
     /**
-     * showPartial(std::ostream& output, Node** nodesList, bool top) const
-     *
-     * Helper method for pushing the nodes information into an output stream.
-     * Only top of the list is displayed.
-     * @param output Output stream
-     * @param nodesList List of nodes to display
-     * @param top Whether to show the bottom of the top of the list
-     * @pre List is not NULL or empty
-     * @post data is pushed into the stream.
+     * ingest(const string& path, int threadsCount)
+     *
+     * Method populating the tree with the tokens of a file, using the same
+     * tokenization as operator>>.
+     * The file is mapped into memory and split on token boundaries; each chunk
+     * is counted by its own thread into a local table. The tables are merged and
+     * every distinct token is inserted once with its total frequency, in order of
+     * first occurrence, so the resulting tree is identical to the one built by
+     * operator>>.
+     *
+     * @param path Path of the file to read
+     * @param threadsCount Number of counting threads (0 uses all hardware threads)
+     * @pre None
+     * @post Tree is filled up with data supplied by the file.
+     * @return true on success; false if the file could not be read
      */
-    void ThreadedBinarySearchTree::showPartial(
-        std::ostream& output,
-        Node** nodesList,
-        bool top) const
+    bool ThreadedBinarySearchTree::ingest(const string& path, int threadsCount)
     {
-        if ((treeSize > 0) && (nodesList != nullptr))
+        MappedFile file(path);
+
+        if (!file.isOpen())
         {
-            if (treeSize <= NODES_DISPLAYED)
-            {
-                ThreadedBinarySearchTree::show(
-                    output, nodesList, 0, treeSize - 1);
-            }
-            else if (top)
-            {
-                ThreadedBinarySearchTree::show(
-                    output, nodesList, treeSize - NODES_DISPLAYED, treeSize - 1);
-            }
-            else
+            return false;
+        }
+
+        const char* data = file.data();
+        size_t size = file.size();
+
+        if (threadsCount <= 0)
+        {
+            threadsCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+        }
+
+        // Split the file into chunks whose boundaries never fall within a token
+        size_t chunks = max<size_t>(1, min<size_t>(threadsCount, size));
+        vector<size_t> boundaries(chunks + 1, size);
+
+        boundaries[0] = 0;
+        for (size_t i = 1; i < chunks; i++)
+        {
+            size_t boundary = max(boundaries[i - 1], size / chunks * i);
+
+            while ((boundary < size) && isTokenChar(data[boundary]))
             {
-                ThreadedBinarySearchTree::show(
-                    output, nodesList, 0, NODES_DISPLAYED - 1);
+                boundary++;
             }
+            boundaries[i] = boundary;
         }
-    }
 
-    /**
-     * show(std::ostream& output, Node** nodesList, int first, int last) const
-     *
-     * Helper method for pushing the nodes information into an output stream.
-     *
-     * @param output Output stream
-     * @param nodesList List of nodes to display
-     * @param first Index of of first node to display
-     * @param last Index of of last node to display
-     * @pre List is not NULL or empty; first & last parameters are valid.
-     * @post data is pushed into the stream.
-     */
-    void ThreadedBinarySearchTree::show(
-        std::ostream& output,
-        Node** nodesList,
-        int first,
-        int last)
-    {
-        if ((nodesList != nullptr) && (first >= 0) && (first <= last))
+        // Count the tokens of each chunk in parallel
+        vector<TokenCounts> counts(chunks);
+        vector<thread> workers;
+
+        for (size_t i = 1; i < chunks; i++)
         {
-            output << "\t";
-            for (int i = first, nodes = 0; i <= last; i++, nodes++)
+            workers.emplace_back(
+                countTokens, data, boundaries[i], boundaries[i + 1], ref(counts[i]));
+        }
+        countTokens(data, boundaries[0], boundaries[1], counts[0]);
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i].join();
+        }
+
+        // Merge the local tables; chunks are in file order, so the first
+        // occurrence of a token is the one recorded by the earliest chunk.
+        TokenCounts& merged = counts[0];
+
+        for (size_t i = 1; i < chunks; i++)
+        {
+            for (const auto& entry : counts[i])
             {
-                if ((nodes > 0) && ((nodes % NODES_PER_LINE) == 0))
+                TokenCount& total = merged[entry.first];
+
+                if (total.frequency == 0)
                 {
-                    output << "\r\n";
-                    output << "\t";
+                    total.firstOffset = entry.second.firstOffset;
                 }
-                nodesList[i]->show(output, false);
-                output << " ";
+                total.frequency += entry.second.frequency;
             }
-            output << "\r\n";
+            counts[i].clear();
+        }
+
+        vector<pair<size_t, string_view>> tokens;
+
+        tokens.reserve(merged.size());
+        for (const auto& entry : merged)
+        {
+            tokens.emplace_back(entry.second.firstOffset, entry.first);
+        }
+        sort(tokens.begin(), tokens.end());
+
+        bool success = true;
+
+        for (size_t i = 0; success && (i < tokens.size()); i++)
+        {
+            success = insert(
+                string(tokens[i].second), merged[tokens[i].second].frequency);
         }
+
+        return success;
     }
 
     /**
-     * createNodesList() const
+     * save(const string& path) const
      *
-     * Helper method for creating a array to hold all the nodes in the tree.
-     * The array will be further filled with traversal nodes.
+     * Method writing a snapshot of the tree to a file. Tokens are written in
+     * order and front-coded; frequencies are written as varints.
      *
-     * @pre The tree is not empty
-     * @post Returns array that can hold all the nodes
-     * @return Array of Node pointers
+     * @param path Path of the file to write
+     * @pre None
+     * @post The file holds the tokens and frequencies of the tree.
+     * @return true on success; false on failure
      */
-    Node** ThreadedBinarySearchTree::createNodesList() const
+    bool ThreadedBinarySearchTree::save(const string& path) const
     {
-        Node** nodesList = nullptr;
+        ofstream output(path, ios::out | ios::binary | ios::trunc);
+        bool success = output.is_open();
 
-        if (treeSize > 0)
+        if (success)
         {
-            nodesList = new Node*[treeSize];
-            for (int i = 0; i < treeSize; i++)
+            string buffer;
+            string previous;
+
+            buffer.reserve(2 * SNAPSHOT_BUFFER_SIZE);
+            buffer.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+            appendVarint(buffer, SNAPSHOT_VERSION);
+            appendVarint(buffer, treeSize);
+
+            for (Node* node : traverse(INORDER))
             {
-                nodesList[i] = nullptr;
+                string token = node->data.getToken();
+                size_t limit = min(token.size(), previous.size());
+                size_t shared = 0;
+
+                while ((shared < limit) && (token[shared] == previous[shared]))
+                {
+                    shared++;
+                }
+
+                appendVarint(buffer, shared);
+                appendVarint(buffer, token.size() - shared);
+                buffer.append(token, shared, string::npos);
+                appendVarint(buffer, node->data.getFrequency());
+
+                if (buffer.size() >= SNAPSHOT_BUFFER_SIZE)
+                {
+                    output.write(buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+
+                previous.swap(token);
             }
+
+            output.write(buffer.data(), buffer.size());
+            output.flush();
+            success = !output.fail();
         }
 
-        return nodesList;
+        return success;
     }
 
     /**
-     * init(Node* node)
+     * load(const string& path)
      *
-     * Helper method for re-setting the depth and parent for each node
-     * (starting from a reference node)
+     * Method replacing the content of the tree with a snapshot written by
+     * save(). The tree is rebuilt balanced in O(n), directly from the sorted
+     * tokens. The tree is left unchanged if the snapshot is not valid.
      *
-     * @param Node Initial node to start with
+     * @param path Path of the file to read
      * @pre None
-     * @post Depth and parent are set for each node
+     * @post The tree holds the tokens and frequencies of the snapshot.
+     * @return true on success; false on failure
      */
-    void ThreadedBinarySearchTree::init(Node* node)
+    bool ThreadedBinarySearchTree::load(const string& path)
     {
-        if (node == nullptr)
-        {
-            if (rootNode != nullptr)
-            {
-                rootNode->depth = 0;
-                rootNode->parentNode = nullptr;
-                treeHeight = 0;
-                init(rootNode);
-            }
-        }
-        else
+        MappedFile file(path);
+        bool success = file.isOpen();
+
+        if (success)
         {
-            treeHeight = std::max(treeHeight, node->depth + 1);
+            // Nodes are built in a separate pool, dropped as a whole if the
+            // snapshot turns out to be invalid
+            NodePool pool;
+            SnapshotLoader loader(file.data(), file.size(), !selfBalancing, pool);
+            int count = 0;
 
-            if (node->leftNodeType == CHILD)
-            {
-                node->leftNode->depth = node->depth + 1;
-                node->leftNode->parentNode = node;
-                init(node->leftNode);
-            }
+            success = loader.readHeader(count);
 
-            if (node->rightNodeType == CHILD)
+            if (success)
             {
-                node->rightNode->depth = node->depth + 1;
-                node->rightNode->parentNode = node;
-                init(node->rightNode);
+                int height = 0;
+                Node* root = loader.build(count, 0, height);
+
+                success = loader.isComplete();
+
+                if (success)
+                {
+                    clear();
+                    nodePool.swap(pool);
+                    rootNode = root;
+                    treeSize = count;
+                    treeHeight = height;
+                }
             }
         }
+
+        return success;
     }
 
     /**
-     * insertHelper(Node* newNode)
+     * operator>>(istream& is, ThreadedBinarySearchTree& tbst)
      *
-     * Helpert method for inserting a new node into the tree.
+     * Overloaded operator for populating the tree from an input stream.
      *
-     * @param node Node to insert
-     * @pre Node is valid
-     * @post Returns the outcome of the operation
-     * @return true on success; false on failure
+     * @param is Input stream sourcing the data
+     * @param tbst Tree to populate
+     * @pre None
+     * @post Tree is filled up with data supplied by input stream.
+     * @return Reference to input stream
      */
-    bool ThreadedBinarySearchTree::insertHelper(Node* newNode)
+    istream& operator>>(istream& is, ThreadedBinarySearchTree& tbst)
     {
-        Node* current = rootNode;       // current reference node
-        bool success = false;
+        bool error = false;
+        string data;
 
-        if ((newNode != nullptr) && newNode->data.isValid())
+        while (!error && is.good())
         {
-            if (rootNode == nullptr)
+            char ch = static_cast<char>(is.get());
+
+            if (isTokenChar(ch))
             {
-                rootNode = newNode;
-                success = true;
+                // alphanumeric - build the token
+                data.push_back(ch);
             }
             else
             {
-                // Search for the insertion position
-			    int result = -1;
-
-			    while (!success && (result != 0))
+                // We reached a word boundary; insert the token built so far.
+                if (!data.empty())
                 {
-                    result = current->data.compare(newNode->data.getToken());
-
-                    if (result == 0)
+                    // Insert the current token (if any)
+                    if (tbst.insert(data))
                     {
-                        // duplicate found
-                        current->data.increaseFrequency();
+                        data.clear();
                     }
-                    else if (result > 0)
+                    else
                     {
-                        // Navigate the left branch
-                        if (current->leftNodeType == CHILD)
-                        {
-                            current = current->leftNode;
-                        }
-                        else
-                        {
-                            // Insertion point found on left branch
-                            newNode->leftNode = current->leftNode;
-                            newNode->rightNode = current;
-                            current->leftNode = newNode;
-                            current->leftNodeType = CHILD;
-                            success = true;
-                        }
+                        error = true;
+                    }
+                }
+
+                if (!error &&
+                    (isprint(ch) != 0) &&
+                    (isspace(ch) == 0) &&
+                    (isgraph(ch) == 0))
+                {
+                    // Non white-space delimiter - inserted as a single char
+                    data.push_back(ch);
+                    if (tbst.insert(data))
+                    {
+                        data.clear();
                     }
                     else
                     {
-                        // Navigate the right branch
-                        if (current->rightNodeType == CHILD)
-                        {
-                            current = current->rightNode;
-                        }
-                        else
-                        {
-                            // Insertion point found on right branch
-                            newNode->leftNode = current;
-                            newNode->rightNode = current->rightNode;
-                            current->rightNode = newNode;
-                            current->rightNodeType = CHILD;
-                            success = true;
-                        }
+                        error = true;
                     }
                 }
+
+                if (error)
+                {
+                    cerr << "Failed to insert ";
+                    cerr << data.c_str() << "\r\n";
+                }
             }
         }
+        is.clear();
 
-        if (success)
+        return is;
+    }
+
+    /**
+     * show(std::ostream& output,  bool details) const
+     *
+     * Helper method for pushing the tree information into an output stream.
+     *
+     * @param output Output stream
+     * @param details Whether to display extended info
+     * @pre None
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::show(std::ostream& output,  bool details) const
+    {
+        output << "Threaded Binary Search Tree: ";
+        output << "size = " << treeSize;
+        output << ", height = " << treeHeight;
+        output << "\r\n";
+
+        if (details)
         {
-            treeSize++;
-            newNode->id = treeSize;
-            newNode->parentNode = current;
-            newNode->depth = (current == nullptr) ? 0 : (current->depth + 1);
-            treeHeight = std::max(treeHeight, newNode->depth + 1);
+            for (Node* node : traverse(INORDER))
+            {
+                node->show(output, true);
+            }
+            output << "\r\n";
         }
+    }
 
-        return success;
+    /**
+     * show(std::ostream& output, Node** nodesList, bool details) const
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     *
+     * @param output Output stream
+     * @param nodesList List of nodes to display
+     * @param details Whether to display extended info
+     * @pre List is not NULL or empty
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::show(
+        std::ostream& output,
+        Node** nodesList,
+        bool details) const
+    {
+        if ((treeSize > 0) && (nodesList != nullptr))
+        {
+            for (int i = 0; i < treeSize; i++)
+            {
+			    if (details)
+			    {
+				    nodesList[i]->show(output, true);
+			    }
+			    else
+			    {
+				    if ((i % NODES_PER_LINE) == 0)
+				    {
+					    if (i > 0)
+					    {
+						    output << "\r\n";
+					    }
+					    output << "\t";
+				    }
+				    nodesList[i]->show(output, false);
+				    output << " ";
+			    }
+            }
+        }
+    }
+
+    /**
+     * showPartial(std::ostream& output, Node** nodesList, bool top) const
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     * Only top of the list is displayed.
+     * @param output Output stream
+     * @param nodesList List of nodes to display
+     * @param top Whether to show the bottom of the top of the list
+     * @pre List is not NULL or empty
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::showPartial(
+        std::ostream& output,
+        Node** nodesList,
+        bool top) const
+    {
+        if ((treeSize > 0) && (nodesList != nullptr))
+        {
+            if (treeSize <= NODES_DISPLAYED)
+            {
+                ThreadedBinarySearchTree::show(
+                    output, nodesList, 0, treeSize - 1);
+            }
+            else if (top)
+            {
+                ThreadedBinarySearchTree::show(
+                    output, nodesList, treeSize - NODES_DISPLAYED, treeSize - 1);
+            }
+            else
+            {
+                ThreadedBinarySearchTree::show(
+                    output, nodesList, 0, NODES_DISPLAYED - 1);
+            }
+        }
+    }
+
+    /**
+     * show(std::ostream& output, const TraversalRange& nodes, bool details) const
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     *
+     * @param output Output stream
+     * @param nodes Range of nodes to display
+     * @param details Whether to display extended info
+     * @pre None
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::show(
+        std::ostream& output,
+        const TraversalRange& nodes,
+        bool details) const
+    {
+        int i = 0;
+
+        for (Node* node : nodes)
+        {
+            if (details)
+            {
+                node->show(output, true);
+            }
+            else
+            {
+                if ((i % NODES_PER_LINE) == 0)
+                {
+                    if (i > 0)
+                    {
+                        output << "\r\n";
+                    }
+                    output << "\t";
+                }
+                node->show(output, false);
+                output << " ";
+            }
+            i++;
+        }
+    }
+
+    /**
+     * showPartial(std::ostream& output, const TraversalRange& nodes, bool top) const
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     * Only top of the range is displayed.
+     * @param output Output stream
+     * @param nodes Range of nodes to display
+     * @param top Whether to show the bottom of the top of the range
+     * @pre None
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::showPartial(
+        std::ostream& output,
+        const TraversalRange& nodes,
+        bool top) const
+    {
+        if (treeSize > 0)
+        {
+            TraversalIterator first = nodes.begin();
+            int count = min(treeSize, NODES_DISPLAYED);
+
+            if (top)
+            {
+                for (int i = 0; i < treeSize - count; i++)
+                {
+                    ++first;
+                }
+            }
+
+            ThreadedBinarySearchTree::show(output, first, count);
+        }
+    }
+
+    /**
+     * show(std::ostream& output, Node** nodesList, int first, int last) const
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     *
+     * @param output Output stream
+     * @param nodesList List of nodes to display
+     * @param first Index of of first node to display
+     * @param last Index of of last node to display
+     * @pre List is not NULL or empty; first & last parameters are valid.
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::show(
+        std::ostream& output,
+        Node** nodesList,
+        int first,
+        int last)
+    {
+        if ((nodesList != nullptr) && (first >= 0) && (first <= last))
+        {
+            output << "\t";
+            for (int i = first, nodes = 0; i <= last; i++, nodes++)
+            {
+                if ((nodes > 0) && ((nodes % NODES_PER_LINE) == 0))
+                {
+                    output << "\r\n";
+                    output << "\t";
+                }
+                nodesList[i]->show(output, false);
+                output << " ";
+            }
+            output << "\r\n";
+        }
+    }
+
+    /**
+     * show(std::ostream& output, TraversalIterator first, int count)
+     *
+     * Helper method for pushing the nodes information into an output stream.
+     *
+     * @param output Output stream
+     * @param first Iterator positioned on the first node to display
+     * @param count Number of nodes to display
+     * @pre The range holds at least count nodes past first.
+     * @post data is pushed into the stream.
+     */
+    void ThreadedBinarySearchTree::show(
+        std::ostream& output,
+        TraversalIterator first,
+        int count)
+    {
+        if (count > 0)
+        {
+            output << "\t";
+            for (int nodes = 0; nodes < count; nodes++, ++first)
+            {
+                if ((nodes > 0) && ((nodes % NODES_PER_LINE) == 0))
+                {
+                    output << "\r\n";
+                    output << "\t";
+                }
+                (*first)->show(output, false);
+                output << " ";
+            }
+            output << "\r\n";
+        }
+    }
+
+    /**
+     * createNodesList() const
+     *
+     * Helper method for creating a array to hold all the nodes in the tree.
+     * The array will be further filled with traversal nodes.
+     *
+     * @pre The tree is not empty
+     * @post Returns array that can hold all the nodes
+     * @return Array of Node pointers
+     */
+    Node** ThreadedBinarySearchTree::createNodesList() const
+    {
+        Node** nodesList = nullptr;
+
+        if (treeSize > 0)
+        {
+            nodesList = new Node*[treeSize];
+            for (int i = 0; i < treeSize; i++)
+            {
+                nodesList[i] = nullptr;
+            }
+        }
+
+        return nodesList;
+    }
+
+    /**
+     * traverseToList(int traverseType) const
+     *
+     * Helper method for filling a newly created nodes list in traversal order.
+     *
+     * @param traverseType Type of traversal (ITERATIVE, PREORDER, INORDER,
+     *                     POSTORDER)
+     * @pre None
+     * @post Returns list of traversal nodes
+     * @return List of nodes on success; NULL on failure
+     */
+    Node** ThreadedBinarySearchTree::traverseToList(int traverseType) const
+    {
+        Node** nodesList = createNodesList();
+
+        if (nodesList != nullptr)
+        {
+            int count = 0;
+
+            for (Node* node : traverse(traverseType))
+            {
+                nodesList[count++] = node;
+            }
+        }
+
+        return nodesList;
+    }
+
+    /**
+     * init()
+     *
+     * Helper method for re-computing the tree height and re-setting the
+     * depth and parent for each node (unless nodes are compact).
+     *
+     * @pre None
+     * @post Tree height, depth and parent are set for each node
+     */
+    void ThreadedBinarySearchTree::init()
+    {
+        vector<pair<Node*, int>> pending;  // nodes left to visit, and depths
+
+        treeHeight = 0;
+
+        if (rootNode != nullptr)
+        {
+#ifndef DSA_TBST_COMPACT_NODE
+            rootNode->parentNode = nullptr;
+#endif
+            pending.emplace_back(rootNode, 0);
+        }
+
+        while (!pending.empty())
+        {
+            Node* node = pending.back().first;
+            int depth = pending.back().second;
+
+            pending.pop_back();
+
+#ifndef DSA_TBST_COMPACT_NODE
+            node->depth = depth;
+#endif
+            treeHeight = std::max(treeHeight, depth + 1);
+
+            if (node->leftNodeType == CHILD)
+            {
+#ifndef DSA_TBST_COMPACT_NODE
+                node->leftNode->parentNode = node;
+#endif
+                pending.emplace_back(node->leftNode, depth + 1);
+            }
+
+            if (node->rightNodeType == CHILD)
+            {
+#ifndef DSA_TBST_COMPACT_NODE
+                node->rightNode->parentNode = node;
+#endif
+                pending.emplace_back(node->rightNode, depth + 1);
+            }
+        }
+    }
+
+    /**
+     * insertHelper(Node* newNode)
+     *
+     * Helpert method for inserting a new node into the tree.
+     *
+     * @param node Node to insert
+     * @pre Node is valid
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ThreadedBinarySearchTree::insertHelper(Node* newNode)
+    {
+        frequencyIndexValid = false;
+
+        if (selfBalancing)
+        {
+            return insertBalanced(newNode);
+        }
+
+        Node* current = rootNode;       // current reference node
+        int depth = 0;                  // depth of the new node
+        bool success = false;
+
+        if ((newNode != nullptr) && newNode->data.isValid())
+        {
+            if (rootNode == nullptr)
+            {
+                rootNode = newNode;
+                success = true;
+            }
+            else
+            {
+                // Search for the insertion position
+			    int result = -1;
+
+			    while (!success && (result != 0))
+                {
+                    result = current->data.compare(newNode->data);
+
+                    if (result == 0)
+                    {
+                        // duplicate found
+                        current->data.increaseFrequency();
+                    }
+                    else if (result > 0)
+                    {
+                        // Navigate the left branch
+                        if (current->leftNodeType == CHILD)
+                        {
+                            current = current->leftNode;
+                            depth++;
+                        }
+                        else
+                        {
+                            // Insertion point found on left branch
+                            newNode->leftNode = current->leftNode;
+                            newNode->rightNode = current;
+                            current->leftNode = newNode;
+                            current->leftNodeType = CHILD;
+                            depth++;
+                            success = true;
+                        }
+                    }
+                    else
+                    {
+                        // Navigate the right branch
+                        if (current->rightNodeType == CHILD)
+                        {
+                            current = current->rightNode;
+                            depth++;
+                        }
+                        else
+                        {
+                            // Insertion point found on right branch
+                            newNode->leftNode = current;
+                            newNode->rightNode = current->rightNode;
+                            current->rightNode = newNode;
+                            current->rightNodeType = CHILD;
+                            depth++;
+                            success = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (success)
+        {
+            treeSize++;
+#ifndef DSA_TBST_COMPACT_NODE
+            newNode->id = treeSize;
+            newNode->parentNode = current;
+            newNode->depth = depth;
+#endif
+            treeHeight = std::max(treeHeight, depth + 1);
+        }
+
+        return success;
+    }
+
+    /**
+     * insertBalanced(Node* newNode)
+     *
+     * Helper method for inserting a new node into a self-balancing tree.
+     * The path from the root is recorded so that the balance factors can be
+     * retraced bottom-up; at most one (single or double) rotation restores
+     * the AVL property.
+     *
+     * @param newNode Node to insert
+     * @pre Node is valid; the tree is self-balancing
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure (or duplicate)
+     */
+    bool ThreadedBinarySearchTree::insertBalanced(Node* newNode)
+    {
+        Node* path[AVL_MAX_HEIGHT];     // ancestors of the new node
+        bool links[AVL_MAX_HEIGHT];     // direction taken from each ancestor
+        int count = 0;
+        bool success = (newNode != nullptr) && newNode->data.isValid();
+
+        if (success && (rootNode == nullptr))
+        {
+            rootNode = newNode;
+        }
+        else if (success)
+        {
+            // Search for the insertion position
+            Node* current = rootNode;
+            bool run = true;
+
+            while (run)
+            {
+                int result = current->data.compare(newNode->data);
+
+                if (result == 0)
+                {
+                    // duplicate found
+                    current->data.increaseFrequency();
+                    success = false;
+                    run = false;
+                }
+                else
+                {
+                    bool right = (result < 0);
+
+                    path[count] = current;
+                    links[count++] = right;
+
+                    if (linkType(current, right) == CHILD)
+                    {
+                        current = childLink(current, right);
+                    }
+                    else
+                    {
+                        run = false;
+                    }
+                }
+            }
+
+            if (success)
+            {
+                // The new leaf takes over the thread of its parent and
+                // threads back to the parent on the other side
+                bool right = links[count - 1];
+
+                childLink(newNode, right) = childLink(current, right);
+                childLink(newNode, !right) = current;
+                childLink(current, right) = newNode;
+                linkType(current, right) = CHILD;
+
+                // Retrace until a subtree height is unchanged
+                bool retrace = true;
+
+                for (int i = count - 1; retrace && (i >= 0); i--)
+                {
+                    Node* node = path[i];
+
+                    node->balanceFactor += links[i] ? 1 : -1;
+
+                    if (node->balanceFactor == 0)
+                    {
+                        retrace = false;
+                    }
+                    else if ((node->balanceFactor == 2) ||
+                             (node->balanceFactor == -2))
+                    {
+                        setSubtree(path, links, i, rebalance(node));
+                        retrace = false;
+                    }
+                }
+            }
+        }
+
+        if (success)
+        {
+            treeSize++;
+#ifndef DSA_TBST_COMPACT_NODE
+            newNode->id = treeSize;
+#endif
+            treeHeight = balancedHeight();
+        }
+
+        return success;
+    }
+
+    /**
+     * removeBalanced(const string& token)
+     *
+     * Helper method for removing a token from a self-balancing tree.
+     * The node is replaced by its in-order successor when it has a right
+     * child; balance factors are then retraced bottom-up, rotating wherever
+     * the AVL property is broken.
+     *
+     * @param token Data to remove
+     * @pre token is valid (not empty); the tree is self-balancing
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ThreadedBinarySearchTree::removeBalanced(const string& token)
+    {
+        Node* path[AVL_MAX_HEIGHT];     // ancestors of the retrace start
+        bool links[AVL_MAX_HEIGHT];     // direction taken from each ancestor
+        int count = 0;
+        Node* current = rootNode;       // node to remove
+        bool success = false;
+        bool run = !token.empty() && (current != nullptr);
+
+        // Find node to remove
+        while (run)
+        {
+            int result = current->data.compare(token);
+
+            if (result == 0)
+            {
+                // Match found!
+                success = true;
+                run = false;
+            }
+            else
+            {
+                bool right = (result < 0);
+
+                if (linkType(current, right) == CHILD)
+                {
+                    path[count] = current;
+                    links[count++] = right;
+                    current = childLink(current, right);
+                }
+                else
+                {
+                    // No match found; end search.
+                    run = false;
+                }
+            }
+        }
+
+        if (success && (treeSize == 1))
+        {
+            // We are about to remove the last node in the tree
+            clear();
+        }
+        else if (success)
+        {
+            int index = count;  // position of the removed node on the path
+
+            if (current->rightNodeType == THREAD)
+            {
+                if (current->leftNodeType == CHILD)
+                {
+                    // The left child takes over; the previous node threads
+                    // to the next node of the removed one
+                    Node* previous = current->leftNode;
+                    while (previous->rightNodeType == CHILD)
+                    {
+                        previous = previous->rightNode;
+                    }
+                    previous->rightNode = current->rightNode;
+
+                    setSubtree(path, links, index, current->leftNode);
+                }
+                else
+                {
+                    // Leaf (not the root, since the tree has other nodes):
+                    // the parent inherits its thread
+                    Node* parent = path[index - 1];
+                    bool right = links[index - 1];
+
+                    childLink(parent, right) = childLink(current, right);
+                    linkType(parent, right) = THREAD;
+                }
+            }
+            else
+            {
+                // The next node (in order) takes over
+                Node* successor = current->rightNode;
+
+                count++;
+
+                if (successor->leftNodeType == CHILD)
+                {
+                    // Detach the next node from the bottom of the left
+                    // branch of the right subtree
+                    Node* parent = successor;
+
+                    path[count] = parent;
+                    links[count++] = false;
+                    successor = parent->leftNode;
+
+                    while (successor->leftNodeType == CHILD)
+                    {
+                        parent = successor;
+                        path[count] = parent;
+                        links[count++] = false;
+                        successor = parent->leftNode;
+                    }
+
+                    if (successor->rightNodeType == CHILD)
+                    {
+                        parent->leftNode = successor->rightNode;
+                    }
+                    else
+                    {
+                        parent->leftNode = successor;
+                        parent->leftNodeType = THREAD;
+                    }
+
+                    successor->rightNode = current->rightNode;
+                    successor->rightNodeType = CHILD;
+                }
+
+                successor->leftNode = current->leftNode;
+                successor->leftNodeType = current->leftNodeType;
+                if (successor->leftNodeType == CHILD)
+                {
+                    Node* previous = successor->leftNode;
+                    while (previous->rightNodeType == CHILD)
+                    {
+                        previous = previous->rightNode;
+                    }
+                    previous->rightNode = successor;
+                }
+
+                successor->balanceFactor = current->balanceFactor;
+                path[index] = successor;
+                links[index] = true;
+                setSubtree(path, links, index, successor);
+            }
+
+            // Retrace until a subtree height is unchanged
+            bool retrace = true;
+
+            for (int i = count - 1; retrace && (i >= 0); i--)
+            {
+                Node* node = path[i];
+
+                node->balanceFactor += links[i] ? -1 : 1;
+
+                if ((node->balanceFactor == 1) || (node->balanceFactor == -1))
+                {
+                    retrace = false;
+                }
+                else if (node->balanceFactor != 0)
+                {
+                    Node* subtree = rebalance(node);
+
+                    setSubtree(path, links, i, subtree);
+                    retrace = (subtree->balanceFactor == 0);
+                }
+            }
+
+            treeSize--;
+            nodePool.release(current);
+            treeHeight = balancedHeight();
+        }
+
+        return success;
+    }
+
+    /**
+     * setSubtree(Node** path, const bool* links, int index, Node* subtree)
+     *
+     * Helper method attaching a subtree in place of the node at a given
+     * position on a recorded path.
+     *
+     * @param path Recorded path from the root
+     * @param links Direction taken from each node on the path
+     * @param index Position on the path of the node to replace
+     * @param subtree Subtree to attach
+     * @pre The node at the given position has a parent unless it is the root
+     * @post The subtree is linked to the parent (or becomes the root)
+     */
+    void ThreadedBinarySearchTree::setSubtree(
+        Node** path,
+        const bool* links,
+        int index,
+        Node* subtree)
+    {
+        if (index == 0)
+        {
+            rootNode = subtree;
+        }
+        else
+        {
+            childLink(path[index - 1], links[index - 1]) = subtree;
+        }
+    }
+
+    /**
+     * balancedHeight() const
+     *
+     * Helper method computing the height of a self-balancing tree by
+     * following the balance factors down its taller branches, in O(log n).
+     *
+     * @pre The tree is self-balancing
+     * @post Returns the tree height
+     * @return tree height
+     */
+    int ThreadedBinarySearchTree::balancedHeight() const
+    {
+        Node* current = rootNode;
+        int height = 0;
+
+        while (current != nullptr)
+        {
+            bool right = (current->balanceFactor > 0);
+
+            height++;
+            current = (linkType(current, right) == CHILD) ?
+                childLink(current, right) : nullptr;
+        }
+
+        return height;
+    }
+
+    /**
+     * rebalance(Node* node)
+     *
+     * Helper method restoring the AVL property of a subtree whose root
+     * balance factor reached 2 or -2, by a single or a double rotation.
+     *
+     * @param node Root of the unbalanced subtree
+     * @pre Both subtrees of the node are AVL trees
+     * @post Balance factors are updated and threads are preserved
+     * @return New root of the subtree
+     */
+    Node* ThreadedBinarySearchTree::rebalance(Node* node)
+    {
+        bool right = (node->balanceFactor > 0);     // taller side
+        int sign = right ? 1 : -1;
+        Node* child = childLink(node, right);
+        Node* root;
+
+        if (child->balanceFactor * sign >= 0)
+        {
+            // Single rotation
+            root = rotate(node, right);
+
+            if (child->balanceFactor == 0)
+            {
+                // Only on removal: the subtree height is unchanged
+                node->balanceFactor = sign;
+                child->balanceFactor = -sign;
+            }
+            else
+            {
+                node->balanceFactor = 0;
+                child->balanceFactor = 0;
+            }
+        }
+        else
+        {
+            // Double rotation
+            root = childLink(child, !right);
+            childLink(node, right) = rotate(child, !right);
+            rotate(node, right);
+
+            if (root->balanceFactor == sign)
+            {
+                node->balanceFactor = -sign;
+                child->balanceFactor = 0;
+            }
+            else if (root->balanceFactor == -sign)
+            {
+                node->balanceFactor = 0;
+                child->balanceFactor = sign;
+            }
+            else
+            {
+                node->balanceFactor = 0;
+                child->balanceFactor = 0;
+            }
+
+            root->balanceFactor = 0;
+        }
+
+        return root;
+    }
+
+    /**
+     * compress(int nonThreadCount, int threadCount)
+     *
+     * Helper method for compressing a tree:
+     * 1. Performs a non-threaded compression operation nonThreadCount times.
+     * 2. Performs a threaded compression operation threadCount times.
+     * As in the reference, the compressions start from a pseudo-root whose
+     * left link stands for the tree root, so the root is compressed as well.
+     * Reference:
+     * http://adtinfo.org/libavl.html/Transforming-a-Vine-into-a-Balanced-TBST.html
+     *
+     * @pre The left links hold enough nodes for the compressions
+     * @post Tree is compressed
+     */
+    void ThreadedBinarySearchTree::compress(int nonThreadCount, int threadCount)
+    {
+        Node pseudoRoot;
+        Node* root = &pseudoRoot;
+
+        pseudoRoot.leftNode = rootNode;
+
+        while (nonThreadCount-- > 0)
+        {
+            Node* red = root->leftNode;
+            Node* black = red->leftNode;
+
+            root->leftNode = black;
+            red->leftNode = black->rightNode;
+            black->rightNode = red;
+            root = black;
+        }
+
+        while (threadCount-- > 0)
+        {
+            Node* red = root->leftNode;
+            Node* black = red->leftNode;
+
+            root->leftNode = black;
+            red->leftNode = black;
+            red->leftNodeType = THREAD;
+            black->rightNodeType = CHILD;
+            root = black;
+        }
+
+        rootNode = pseudoRoot.leftNode;
+    }
+
+    /**
+     * TreeIterator(const ThreadedBinarySearchTree* tbst)
+     *
+     * Constructor
+     * @param tbst TBS tree to iterate over
+     */
+    TreeIterator::TreeIterator(const ThreadedBinarySearchTree* tbst)
+        : tbsTree(tbst),
+        currentNode(nullptr)
+    {
+    }
+
+    /**
+     * TreeIterator(ThreadedBinarySearchTree* tbst)
+     *
+     * Copy constructor
+     * @param treeIter Source iterator
+     */
+    TreeIterator::TreeIterator(const TreeIterator& treeIter)
+        : tbsTree(treeIter.tbsTree),
+          currentNode(treeIter.currentNode)
+    {
+    }
+
+    /**
+     * operator*()
+     *
+     * De-reference operator
+     *
+     * @pre None
+     * @post Retrieves the current iteration node
+     * @return current node
+     */
+    Node*& TreeIterator::operator*()
+    {
+        return currentNode;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - prefix form
+     *
+     * @pre None
+     * @post The iterator is advanced forward.
+     * @return A reference to current iterator
+     */
+    TreeIterator& TreeIterator::operator++()
+    {
+        currentNode = tbsTree->getNext(currentNode);
+        return *this;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - postfix form
+     *
+     * @pre None
+     * @post The iterator is advanced forward.
+     * @return A reference to current iterator
+     */
+    TreeIterator TreeIterator::operator++(int)
+    {
+        TreeIterator iter(*this);
+        operator++();
+        return iter;
+    }
+
+    /**
+     * operator--()
+     *
+     * Decrement operator - prefix form
+     *
+     * @pre None
+     * @post The iterator is advanced backward.
+     * @return A reference to current iterator
+     */
+    TreeIterator& TreeIterator::operator--()
+    {
+        currentNode = tbsTree->getPrevious(currentNode);
+        return *this;
+    }
+
+    /**
+     * operator--()
+     *
+     * Decrement operator - postfix form
+     *
+     * @pre None
+     * @post The iterator is advanced backward.
+     * @return A reference to current iterator
+     */
+    TreeIterator TreeIterator::operator--(int)
+    {
+        TreeIterator iter(*this);
+        operator--();
+        return iter;
+    }
+
+    /**
+     * operator==(const TreeIterator& treeIter)
+     *
+     * Equality operator
+     *
+     * @param treeIter The iterator used as comparison target.
+     * @pre None
+     * @post The local data is compared against the target data.
+     * @return True if the data are matching; false otherwise.
+     */
+    bool TreeIterator::operator==(const TreeIterator& treeIter) const
+    {
+        return (tbsTree == treeIter.tbsTree) &&
+               (currentNode == treeIter.currentNode);
+    }
+
+    /**
+     * operator!=(const TreeIterator& treeIter)
+     *
+     * Equality operator
+     *
+     * @param treeIter The iterator used as comparison target.
+     * @pre None
+     * @post The local data is compared against the target data.
+     * @return True if the data are matching; false otherwise.
+     */
+    bool TreeIterator::operator!=(const TreeIterator& treeIter) const
+    {
+        return (tbsTree != treeIter.tbsTree) ||
+               (currentNode != treeIter.currentNode);
+    }
+
+    /**
+     * TraversalIterator()
+     *
+     * Default constructor; the iterator is positioned past the end.
+     */
+    TraversalIterator::TraversalIterator()
+        : traversal(INORDER),
+          currentNode(nullptr)
+    {
+    }
+
+    /**
+     * TraversalIterator(int traverseType, Node* root, int height)
+     *
+     * Constructor; the iterator is positioned on the first node of the
+     * traversal.
+     * @param traverseType Type of traversal (ITERATIVE, PREORDER, INORDER,
+     *                     POSTORDER)
+     * @param root Root of the tree to traverse
+     * @param height Height of the tree to traverse
+     */
+    TraversalIterator::TraversalIterator(int traverseType, Node* root, int height)
+        : traversal(traverseType),
+          currentNode(root)
+    {
+        switch (traversal)
+        {
+            case PREORDER:
+                break;
+
+            case POSTORDER:
+                ancestors.reserve(max(height, 0));
+                descend(root);
+                break;
+
+            default:
+                while ((currentNode != nullptr) &&
+                       (currentNode->leftNodeType == CHILD))
+                {
+                    currentNode = currentNode->leftNode;
+                }
+                break;
+        }
+    }
+
+    /**
+     * operator*()
+     *
+     * De-reference operator
+     *
+     * @pre The iterator is not past the end.
+     * @post Retrieves the current traversal node
+     * @return current node
+     */
+    Node* TraversalIterator::operator*() const
+    {
+        return currentNode;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - prefix form
+     *
+     * @pre The iterator is not past the end.
+     * @post The iterator is advanced to the next node in traversal order.
+     * @return A reference to current iterator
+     */
+    TraversalIterator& TraversalIterator::operator++()
+    {
+        switch (traversal)
+        {
+            case PREORDER:
+                if (currentNode->leftNodeType == CHILD)
+                {
+                    currentNode = currentNode->leftNode;
+                }
+                else if (currentNode->rightNodeType == CHILD)
+                {
+                    currentNode = currentNode->rightNode;
+                }
+                else
+                {
+                    // A leaf was reached: the right threads lead to the
+                    // ancestors whose left subtree is now exhausted; the first
+                    // of them having a right child continues the traversal.
+                    while ((currentNode != nullptr) &&
+                           (currentNode->rightNodeType == THREAD))
+                    {
+                        currentNode = currentNode->rightNode;
+                    }
+
+                    if (currentNode != nullptr)
+                    {
+                        currentNode = currentNode->rightNode;
+                    }
+                }
+                break;
+
+            case POSTORDER:
+                if (ancestors.empty())
+                {
+                    currentNode = nullptr;
+                }
+                else
+                {
+                    Node* parent = ancestors.back();
+
+                    if ((parent->leftNodeType == CHILD) &&
+                        (parent->leftNode == currentNode) &&
+                        (parent->rightNodeType == CHILD))
+                    {
+                        descend(parent->rightNode);
+                    }
+                    else
+                    {
+                        currentNode = parent;
+                        ancestors.pop_back();
+                    }
+                }
+                break;
+
+            default:
+                if (currentNode->rightNodeType == THREAD)
+                {
+                    currentNode = currentNode->rightNode;
+                }
+                else
+                {
+                    currentNode = currentNode->rightNode;
+                    while (currentNode->leftNodeType == CHILD)
+                    {
+                        currentNode = currentNode->leftNode;
+                    }
+                }
+                break;
+        }
+
+        return *this;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - postfix form
+     *
+     * @pre The iterator is not past the end.
+     * @post The iterator is advanced to the next node in traversal order.
+     * @return A copy of the iterator before the increment
+     */
+    TraversalIterator TraversalIterator::operator++(int)
+    {
+        TraversalIterator iter(*this);
+        operator++();
+        return iter;
+    }
+
+    /**
+     * operator==(const TraversalIterator& traversalIter)
+     *
+     * Equality operator
+     *
+     * @param traversalIter The iterator used as comparison target.
+     * @pre Both iterators traverse the same tree.
+     * @post The current nodes are compared.
+     * @return True if both iterators are on the same node; false otherwise.
+     */
+    bool TraversalIterator::operator==(
+        const TraversalIterator& traversalIter) const
+    {
+        return (currentNode == traversalIter.currentNode);
+    }
+
+    /**
+     * operator!=(const TraversalIterator& traversalIter)
+     *
+     * Inequality operator
+     *
+     * @param traversalIter The iterator used as comparison target.
+     * @pre Both iterators traverse the same tree.
+     * @post The current nodes are compared.
+     * @return True if the iterators are on different nodes; false otherwise.
+     */
+    bool TraversalIterator::operator!=(
+        const TraversalIterator& traversalIter) const
+    {
+        return (currentNode != traversalIter.currentNode);
+    }
+
+    /**
+     * descend(Node* node)
+     *
+     * Helper method moving to the first post-order node of a subtree,
+     * recording the path taken.
+     *
+     * @param node Root of the subtree
+     * @pre None
+     * @post The current node is the first post-order node of the subtree.
+     */
+    void TraversalIterator::descend(Node* node)
+    {
+        currentNode = node;
+
+        while (currentNode != nullptr)
+        {
+            if (currentNode->leftNodeType == CHILD)
+            {
+                ancestors.push_back(currentNode);
+                currentNode = currentNode->leftNode;
+            }
+            else if (currentNode->rightNodeType == CHILD)
+            {
+                ancestors.push_back(currentNode);
+                currentNode = currentNode->rightNode;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    /**
+     * TraversalRange(int traverseType, Node* root, int height)
+     *
+     * Constructor
+     * @param traverseType Type of traversal (ITERATIVE, PREORDER, INORDER,
+     *                     POSTORDER)
+     * @param root Root of the tree to traverse
+     * @param height Height of the tree to traverse
+     */
+    TraversalRange::TraversalRange(int traverseType, Node* root, int height)
+        : traversal(traverseType),
+          rootNode(root),
+          treeHeight(height)
+    {
+    }
+
+    /**
+     * begin() const
+     *
+     * Method returning an iterator positioned on the first traversal node.
+     *
+     * @pre None
+     * @post Constructs and initialize iterator.
+     * @return Initialized iterator
+     */
+    TraversalIterator TraversalRange::begin() const
+    {
+        return TraversalIterator(traversal, rootNode, treeHeight);
+    }
+
+    /**
+     * end() const
+     *
+     * Method returning an iterator positioned past the last traversal node.
+     *
+     * @pre None
+     * @post Constructs and initialize iterator.
+     * @return Initialized iterator
+     */
+    TraversalIterator TraversalRange::end() const
+    {
+        return TraversalIterator();
+    }
+
+    /**
+     * MatchIterator()
+     *
+     * Default constructor; the iterator is positioned past the end.
+     */
+    MatchIterator::MatchIterator()
+        : matchRange(nullptr),
+          currentNode(nullptr),
+          remaining(0)
+    {
+    }
+
+    /**
+     * MatchIterator(const MatchRange* range, Node* first)
+     *
+     * Constructor; the iterator is positioned on the first candidate if it
+     * matches, past the end otherwise.
+     * @param range Search to iterate
+     * @param first First candidate node
+     */
+    MatchIterator::MatchIterator(const MatchRange* range, Node* first)
+        : matchRange(range),
+          currentNode(first),
+          remaining(range->matchLimit)
+    {
+        if ((remaining == 0) || !matchRange->matches(currentNode))
+        {
+            currentNode = nullptr;
+        }
+    }
+
+    /**
+     * operator*()
+     *
+     * De-reference operator
+     *
+     * @pre The iterator is not past the end.
+     * @post Retrieves the current match
+     * @return current node
+     */
+    Node* MatchIterator::operator*() const
+    {
+        return currentNode;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - prefix form
+     *
+     * @pre The iterator is not past the end.
+     * @post The iterator is advanced to the next match.
+     * @return A reference to current iterator
+     */
+    MatchIterator& MatchIterator::operator++()
+    {
+        if (remaining > 0)
+        {
+            remaining--;
+        }
+
+        if (remaining == 0)
+        {
+            currentNode = nullptr;
+        }
+        else
+        {
+            currentNode = matchRange->tbsTree->getNext(currentNode);
+
+            if (!matchRange->matches(currentNode))
+            {
+                currentNode = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * operator++()
+     *
+     * Increment operator - postfix form
+     *
+     * @pre The iterator is not past the end.
+     * @post The iterator is advanced to the next match.
+     * @return A copy of the iterator before the increment
+     */
+    MatchIterator MatchIterator::operator++(int)
+    {
+        MatchIterator iter(*this);
+        operator++();
+        return iter;
+    }
+
+    /**
+     * operator==(const MatchIterator& matchIter)
+     *
+     * Equality operator
+     *
+     * @param matchIter The iterator used as comparison target.
+     * @pre Both iterators belong to the same search.
+     * @post The current nodes are compared.
+     * @return True if both iterators are on the same node; false otherwise.
+     */
+    bool MatchIterator::operator==(const MatchIterator& matchIter) const
+    {
+        return (currentNode == matchIter.currentNode);
+    }
+
+    /**
+     * operator!=(const MatchIterator& matchIter)
+     *
+     * Inequality operator
+     *
+     * @param matchIter The iterator used as comparison target.
+     * @pre Both iterators belong to the same search.
+     * @post The current nodes are compared.
+     * @return True if the iterators are on different nodes; false otherwise.
+     */
+    bool MatchIterator::operator!=(const MatchIterator& matchIter) const
+    {
+        return (currentNode != matchIter.currentNode);
+    }
+
+    /**
+     * MatchRange(const ThreadedBinarySearchTree* tbst, Node* first,
+     *            const string& bound, bool prefixMatch, int limit)
+     *
+     * Constructor
+     * @param tbst Searched tree
+     * @param first First candidate node (the lower bound)
+     * @param bound Prefix (prefix search) or upper bound (range search)
+     * @param prefixMatch Whether this is a prefix search
+     * @param limit Maximum number of matches (NO_LIMIT for all)
+     */
+    MatchRange::MatchRange(
+        const ThreadedBinarySearchTree* tbst,
+        Node* first,
+        const string& bound,
+        bool prefixMatch,
+        int limit)
+        : tbsTree(tbst),
+          firstNode(first),
+          matchBound(bound),
+          isPrefix(prefixMatch),
+          matchLimit(limit)
+    {
+    }
+
+    /**
+     * begin() const
+     *
+     * Method returning an iterator positioned on the first match.
+     *
+     * @pre None
+     * @post Constructs and initialize iterator.
+     * @return Initialized iterator
+     */
+    MatchIterator MatchRange::begin() const
+    {
+        return MatchIterator(this, firstNode);
+    }
+
+    /**
+     * end() const
+     *
+     * Method returning an iterator positioned past the last match.
+     *
+     * @pre None
+     * @post Constructs and initialize iterator.
+     * @return Initialized iterator
+     */
+    MatchIterator MatchRange::end() const
+    {
+        return MatchIterator();
     }
 
     /**
-     * compress(int nonThreadCount, int threadCount)
+     * matches(const Node* node) const
      *
-     * Helper method for compressing a tree:
-     * 1. Performs a non-threaded compression operation nonThreadCount times.
-     * 2. Performs a threaded compression operation threadCount times.
-     * Reference:
-     * http://adtinfo.org/libavl.html/Transforming-a-Vine-into-a-Balanced-TBST.html
+     * Helper method checking whether a candidate node matches the search.
      *
-     * @pre Tree has at least 3 nodes
-     * @post Tree is compressed
+     * @param node Candidate node (not lower than the lower bound)
+     * @pre None
+     * @post The node is checked against the prefix or the upper bound.
+     * @return True if the node matches; false otherwise (or if NULL).
      */
-    void ThreadedBinarySearchTree::compress(int nonThreadCount, int threadCount) const
+    bool MatchRange::matches(const Node* node) const
     {
-        if (treeSize >= COMPRESSION_MIN_NODES)
-        {
-            Node* root = rootNode;
-
-            while ((root != nullptr) && (nonThreadCount-- > 0))
-            {
-                Node* red = root->leftNode;
-                Node* black = red->leftNode;
-
-                root->leftNode = black;
-                red->leftNode = black->rightNode;
-                black->rightNode = red;
-                root = black;
-            }
-
-            while ((root != nullptr) && (threadCount-- > 0))
-            {
-                Node* red = root->leftNode;
-                Node* black = red->leftNode;
-
-                root->leftNode = black;
-                red->leftNode = black;
-                red->leftNodeType = THREAD;
-                black->rightNodeType = CHILD;
-                root = black;
-            }
-        }
+        return (node != nullptr) &&
+               (isPrefix ?
+                   node->data.startsWith(matchBound) :
+                   (node->data.compare(matchBound) < 0));
     }
 
     /**
-     * destroy(Node* node)
+     * childLink(Node* node, bool right)
      *
-     * Helper method destroying all the nodes (starting from a reference node)
+     * Function accessing the left or right link of a node.
      *
-     * @param Node Initial node to start with
-     * @pre None
-     * @post All nodes (including the reference) are deleted
+     * @param node Node to access
+     * @param right Which link: false/true => left/right
+     * @pre Node is not NULL
+     * @return Reference to the link
      */
-    void ThreadedBinarySearchTree::destroy(Node* node)
+    Node*& childLink(Node* node, bool right)
     {
-        if (node != nullptr)
-        {
-            if (node->leftNodeType == CHILD)
-            {
-                destroy(node->leftNode);
-            }
-
-            if (node->rightNodeType == CHILD)
-            {
-                destroy(node->rightNode);
-            }
+        return right ? node->rightNode : node->leftNode;
+    }
 
-            delete node;
-        }
+    /**
+     * linkType(Node* node, bool right)
+     *
+     * Function accessing the type of the left or right link of a node.
+     *
+     * @param node Node to access
+     * @param right Which link: false/true => left/right
+     * @pre Node is not NULL
+     * @return Reference to the link type (THREAD or CHILD)
+     */
+    bool& linkType(Node* node, bool right)
+    {
+        return right ? node->rightNodeType : node->leftNodeType;
     }
 
     /**
-     * traverseHelper(int traverseType, Node* node, StackNode** nodesList,
-     *                int& currentPosition);
+     * rotate(Node* node, bool right)
      *
-     * Helpert method for recursive traversal starting from a reference node.
+     * Function rotating a subtree so that the child of its root on the given
+     * side becomes the new root. A link left without a child turns into a
+     * thread to the new root.
      *
-     * @param traverseType Type of traversal (PREORDER, INORDER, POSTORDER)
-     * @param node Reference node to start with
-     * @param nodesList Traversal list
-     * @param currentPosition Current position within traversal list
-     * @pre Reference node and traversal list are not NULL
+     * @param node Root of the subtree
+     * @param right Side of the child to promote: false/true => left/right
+     * @pre The node has a child on the given side
+     * @post The subtree is rotated; balance factors are not updated
+     * @return New root of the subtree
      */
-    void ThreadedBinarySearchTree::traverseHelper(
-        int traverseType,
-        Node* node,
-        Node** nodesList,
-        int& currentPosition)
+    Node* rotate(Node* node, bool right)
     {
-        if ((node != nullptr) && (nodesList != nullptr) && (currentPosition >= 0))
+        Node* child = childLink(node, right);
+
+        if (linkType(child, !right) == CHILD)
         {
-            switch (traverseType)
-            {
-                case PREORDER:
-                    nodesList[currentPosition++] = node;
-                    if (node->leftNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->leftNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    if (node->rightNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->rightNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    break;
+            childLink(node, right) = childLink(child, !right);
+        }
+        else
+        {
+            childLink(node, right) = child;
+            linkType(node, right) = THREAD;
+        }
 
-                case INORDER:
-                    if (node->leftNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->leftNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    nodesList[currentPosition++] = node;
-                    if (node->rightNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->rightNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    break;
+        childLink(child, !right) = node;
+        linkType(child, !right) = CHILD;
 
-                case POSTORDER:
-                    if (node->leftNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->leftNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    if (node->rightNodeType == CHILD)
-                    {
-                        traverseHelper(
-                            traverseType,
-                            node->rightNode,
-                            nodesList,
-                            currentPosition);
-                    }
-                    nodesList[currentPosition++] = node;
-                    break;
-            }
-        }
+        return child;
     }
 
-
     /**
-     * TreeIterator(ThreadedBinarySearchTree* tbst)
+     * isTokenChar(char ch)
      *
-     * Constructor
-     * @param tbst TBS tree to iterate over
+     * Function checking whether input character is part of word token.
+     *
+     * @param ch Character to check.
+     * @pre None
+     * @post Character is compared against our definition of token data.
+     * @return True of char belongs to a token; false otherwise.
      */
-    TreeIterator::TreeIterator(ThreadedBinarySearchTree* tbst)
-        : tbsTree(tbst),
-        currentNode(nullptr)
+    bool isTokenChar(char ch)
     {
+        switch (ch)
+        {
+            case '\'':
+            case '\"':
+            case '-':
+            case '_':
+                return true;
+
+            default:
+                break;
+        }
+
+        return (isalnum(ch) != 0);
     }
 
     /**
-     * TreeIterator(ThreadedBinarySearchTree* tbst)
+     * countTokens(const char* data, size_t first, size_t last,
+     *             TokenCounts& counts)
      *
-     * Copy constructor
-     * @param treeIter Source iterator
+     * Function counting the tokens within a range of characters.
+     *
+     * @param data Characters to tokenize.
+     * @param first Offset of the first character of the range.
+     * @param last Offset past the last character of the range.
+     * @param counts Table receiving the token frequencies.
+     * @pre The range does not start or end within a token.
+     * @post Each token of the range is counted in the table.
      */
-    TreeIterator::TreeIterator(const TreeIterator& treeIter)
-        : tbsTree(treeIter.tbsTree),
-          currentNode(treeIter.currentNode)
+    void countTokens(
+        const char* data, size_t first, size_t last, TokenCounts& counts)
     {
+        size_t position = first;
+
+        while (position < last)
+        {
+            while ((position < last) && !isTokenChar(data[position]))
+            {
+                position++;
+            }
+
+            size_t start = position;
+
+            while ((position < last) && isTokenChar(data[position]))
+            {
+                position++;
+            }
+
+            if (position > start)
+            {
+                TokenCount& count =
+                    counts[string_view(data + start, position - start)];
+
+                if (count.frequency++ == 0)
+                {
+                    count.firstOffset = start;
+                }
+            }
+        }
     }
 
     /**
-     * operator*()
+     * appendVarint(string& buffer, uint64_t value)
      *
-     * De-reference operator
+     * Function appending an integer encoded as a LEB128 varint.
      *
+     * @param buffer Buffer receiving the encoded integer.
+     * @param value Integer to encode.
      * @pre None
-     * @post Retrieves the current iteration node
-     * @return current node
+     * @post The encoded integer is appended to the buffer.
      */
-    Node*& TreeIterator::operator*()
+    void appendVarint(string& buffer, uint64_t value)
     {
-        return currentNode;
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
     }
 
     /**
-     * operator++()
+     * SnapshotLoader(const char* data, size_t size, bool trackParents,
+     *                NodePool& pool)
      *
-     * Increment operator - prefix form
+     * Constructor
      *
-     * @pre None
-     * @post The iterator is advanced forward.
-     * @return A reference to current iterator
+     * @param data Snapshot bytes.
+     * @param size Number of snapshot bytes.
+     * @param trackParents Whether to set the nodes depths and parents.
+     * @param pool Pool creating the nodes.
      */
-    TreeIterator& TreeIterator::operator++()
+    SnapshotLoader::SnapshotLoader(
+        const char* data, size_t size, bool trackParents, NodePool& pool)
+        : position(data),
+          end(data + size),
+          valid(data != nullptr),
+          parents(trackParents),
+          nodes(pool),
+          previous(nullptr),
+          nextId(0)
     {
-        currentNode = tbsTree->getNext(currentNode);
-        return *this;
     }
 
     /**
-     * operator++()
+     * readHeader(int& count)
      *
-     * Increment operator - postfix form
+     * Method validating the snapshot header.
      *
+     * @param count Number of tokens in the snapshot.
      * @pre None
-     * @post The iterator is advanced forward.
-     * @return A reference to current iterator
+     * @post The position is moved to the first token.
+     * @return true if the header is valid; false otherwise.
      */
-    TreeIterator TreeIterator::operator++(int)
+    bool SnapshotLoader::readHeader(int& count)
     {
-        TreeIterator iter(*this);
-        operator++();
-        return iter;
+        uint64_t version = 0;
+        uint64_t tokens = 0;
+
+        valid = valid &&
+            (static_cast<size_t>(end - position) >= sizeof(SNAPSHOT_MAGIC)) &&
+            equal(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC), position);
+
+        if (valid)
+        {
+            position += sizeof(SNAPSHOT_MAGIC);
+        }
+
+        // Every token takes a few bytes, which bounds the count before
+        // any node is allocated
+        valid = readVarint(version) &&
+            (version == SNAPSHOT_VERSION) &&
+            readVarint(tokens) &&
+            (tokens <= static_cast<uint64_t>(end - position) / SNAPSHOT_MIN_ENTRY_SIZE);
+
+        count = valid ? static_cast<int>(tokens) : 0;
+
+        return valid;
     }
 
     /**
-     * operator--()
+     * build(int count, int depth, int& height)
      *
-     * Decrement operator - prefix form
+     * Method building a balanced subtree from the next tokens. The left
+     * subtree is built first, then the root, then the right subtree, so
+     * nodes are created in order and threaded to their neighbours.
      *
+     * @param count Number of tokens in the subtree.
+     * @param depth Depth of the subtree root.
+     * @param height Height of the built subtree.
      * @pre None
-     * @post The iterator is advanced backward.
-     * @return A reference to current iterator
+     * @post Returns the subtree root (NULL for an empty subtree).
+     * @return Subtree root
      */
-    TreeIterator& TreeIterator::operator--()
+    Node* SnapshotLoader::build(int count, int depth, int& height)
     {
-        currentNode = tbsTree->getPrevious(currentNode);
-        return *this;
+        Node* node = nullptr;
+
+        height = 0;
+
+        if (count > 0)
+        {
+            int leftCount = (count - 1) / 2;
+            int leftHeight = 0;
+            int rightHeight = 0;
+            Node* left = build(leftCount, depth + 1, leftHeight);
+
+            node = readNode();
+
+            if (left != nullptr)
+            {
+                node->leftNode = left;
+                node->leftNodeType = CHILD;
+            }
+            else
+            {
+                node->leftNode = previous;
+            }
+
+            // Provisional thread, replaced by a child link if the previous
+            // node turns out to have a right subtree
+            if (previous != nullptr)
+            {
+                previous->rightNode = node;
+            }
+            previous = node;
+
+            Node* right = build(count - 1 - leftCount, depth + 1, rightHeight);
+
+            if (right != nullptr)
+            {
+                node->rightNode = right;
+                node->rightNodeType = CHILD;
+            }
+
+#ifndef DSA_TBST_COMPACT_NODE
+            if (parents)
+            {
+                node->depth = depth;
+                if (left != nullptr)
+                {
+                    left->parentNode = node;
+                }
+                if (right != nullptr)
+                {
+                    right->parentNode = node;
+                }
+            }
+#endif
+
+            node->balanceFactor = rightHeight - leftHeight;
+            height = max(leftHeight, rightHeight) + 1;
+        }
+
+        return node;
     }
 
     /**
-     * operator--()
+     * readVarint(uint64_t& value)
      *
-     * Decrement operator - postfix form
+     * Method decoding a LEB128 varint.
      *
+     * @param value Decoded integer.
      * @pre None
-     * @post The iterator is advanced backward.
-     * @return A reference to current iterator
+     * @post The position is moved past the integer.
+     * @return true on success; false on failure.
      */
-    TreeIterator TreeIterator::operator--(int)
+    bool SnapshotLoader::readVarint(uint64_t& value)
     {
-        TreeIterator iter(*this);
-        operator--();
-        return iter;
+        int shift = 0;
+        bool run = valid;
+
+        value = 0;
+
+        while (run)
+        {
+            if ((position == end) || (shift > 63))
+            {
+                valid = false;
+                run = false;
+            }
+            else
+            {
+                unsigned char byte = static_cast<unsigned char>(*position++);
+
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+                run = (byte & 0x80) != 0;
+            }
+        }
+
+        return valid;
     }
 
     /**
-     * operator==(const TreeIterator& treeIter)
+     * readNode()
      *
-     * Equality operator
+     * Method decoding the next token into a new node. Once the snapshot
+     * turns out to be invalid, empty nodes are returned so that the tree
+     * being built can still be destroyed as a whole.
      *
-     * @param treeIter The iterator used as comparison target.
      * @pre None
-     * @post The local data is compared against the target data.
-     * @return True if the data are matching; false otherwise.
+     * @post The position is moved past the token.
+     * @return New node
      */
-    bool TreeIterator::operator==(const TreeIterator& treeIter) const
+    Node* SnapshotLoader::readNode()
     {
-        return (tbsTree == treeIter.tbsTree) &&
-               (currentNode == treeIter.currentNode);
+        uint64_t shared = 0;
+        uint64_t suffix = 0;
+        uint64_t frequency = 0;
+
+        valid = readVarint(shared) &&
+            (shared <= token.size()) &&
+            readVarint(suffix) &&
+            (suffix <= static_cast<uint64_t>(end - position)) &&
+            (shared + suffix > 0);
+
+        if (valid)
+        {
+            token.resize(shared);
+            token.append(position, suffix);
+            position += suffix;
+
+            valid = readVarint(frequency) &&
+                (frequency > 0) &&
+                (frequency <= static_cast<uint64_t>(numeric_limits<int>::max()));
+        }
+
+        Node* node = valid ? nodes.create(token) : nodes.create();
+
+        if (valid)
+        {
+            node->data.increaseFrequency(static_cast<int>(frequency) - 1);
+        }
+#ifndef DSA_TBST_COMPACT_NODE
+        node->id = ++nextId;
+#endif
+
+        return node;
     }
 
     /**
-     * operator!=(const TreeIterator& treeIter)
+     * MappedFile(const string& path)
      *
-     * Equality operator
+     * Constructor mapping the whole file into memory.
      *
-     * @param treeIter The iterator used as comparison target.
-     * @pre None
-     * @post The local data is compared against the target data.
-     * @return True if the data are matching; false otherwise.
+     * @param path Path of the file to map.
      */
-    bool TreeIterator::operator!=(const TreeIterator& treeIter) const
+    MappedFile::MappedFile(const string& path)
     {
-        return (tbsTree != treeIter.tbsTree) ||
-               (currentNode != treeIter.currentNode);
+#ifdef DSA_TBST_HAS_MMAP
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+
+        if (descriptor >= 0)
+        {
+            struct stat status;
+
+            if (::fstat(descriptor, &status) == 0)
+            {
+                length = static_cast<size_t>(status.st_size);
+                opened = true;
+
+                if (length > 0)
+                {
+                    void* view =
+                        ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+                    if (view != MAP_FAILED)
+                    {
+                        ::madvise(view, length, MADV_SEQUENTIAL);
+                        bytes = static_cast<const char*>(view);
+                        mapped = true;
+                    }
+                    else
+                    {
+                        opened = false;
+                    }
+                }
+            }
+            ::close(descriptor);
+        }
+#else
+        ifstream input(path, ios::in | ios::binary | ios::ate);
+
+        if (input.is_open())
+        {
+            buffer.resize(static_cast<size_t>(input.tellg()));
+            input.seekg(0);
+            input.read(buffer.data(), buffer.size());
+
+            bytes = buffer.data();
+            length = buffer.size();
+            opened = !input.fail();
+        }
+#endif
     }
 
     /**
-     * isTokenChar(char ch)
-     *
-     * Function checking whether input character is part of word token.
+     * ~MappedFile()
      *
-     * @param ch Character to check.
-     * @pre None
-     * @post Character is compared against our definition of token data.
-     * @return True of char belongs to a token; false otherwise.
+     * Destructor unmapping the file.
      */
-    bool isTokenChar(char ch)
+    MappedFile::~MappedFile()
     {
-        switch (ch)
+#ifdef DSA_TBST_HAS_MMAP
+        if (mapped)
         {
-            case '\'':
-            case '\"':
-            case '-':
-            case '_':
-                return true;
-
-            default:
-                break;
+            ::munmap(const_cast<char*>(bytes), length);
         }
-
-        return (isalnum(ch) != 0);
+#endif
     }
 }
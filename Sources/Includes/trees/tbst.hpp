@@ -4,15 +4,21 @@
 
 #pragma once
 
+#include <vector>
+
 #include "node.hpp"
+#include "tbst_node_pool.hpp"
 
 namespace dsa
 {
     // Tree traversal types
-    const int ITERATIVE = 0;    // Iterative in-order
-    const int PREORDER = 1;    // Recursive pre-order
-    const int INORDER = 2;    // Recursive in-order
-    const int POSTORDER = 3;    // Recursive post-order
+    const int ITERATIVE = 0;    // In-order, following the threads
+    const int PREORDER = 1;    // Pre-order
+    const int INORDER = 2;    // In-order
+    const int POSTORDER = 3;    // Post-order
+
+    // Unlimited number of matches
+    const int NO_LIMIT = -1;
 
     // Display constants
     const int NODES_PER_LINE = 7;   // nodes per line
@@ -21,22 +27,31 @@ namespace dsa
     // Forward declaration of classes
     class ThreadedBinarySearchTree;
     class TreeIterator;
+    class TraversalIterator;
+    class TraversalRange;
+    class MatchIterator;
+    class MatchRange;
 
     /**
      * ThreadedBinarySearchTree
      *
      * Class implementing a Threaded Binary Search Tree (TBST).
+     * A self-balancing tree keeps the AVL property on every insertion and
+     * removal, so it never needs balance(); its nodes do not track their
+     * depth and parent.
      */
     class ThreadedBinarySearchTree
     {
     public:
         ThreadedBinarySearchTree();
+        explicit ThreadedBinarySearchTree(bool balancing);
         ThreadedBinarySearchTree(const ThreadedBinarySearchTree& source);
         ~ThreadedBinarySearchTree();
 
         // Properties
         bool isEmpty() const;
         bool isVine() const;
+        bool isSelfBalancing() const;
         int getNodesCount() const;
         int getHeigth() const;
 
@@ -47,7 +62,14 @@ namespace dsa
         void vineToTree();
 
         Node* find(const std::string& token) const;
+        Node* lowerBound(const std::string& token) const;
+        MatchRange prefix(const std::string& token, int limit = NO_LIMIT) const;
+        MatchRange range(
+            const std::string& low,
+            const std::string& high,
+            int limit = NO_LIMIT) const;
         bool insert(const std::string& token);
+        bool insert(const std::string& token, int frequency);
         bool insert(const Node& node);
         bool remove(const std::string& token);
 
@@ -56,19 +78,32 @@ namespace dsa
         Node* getLast() const;
         Node* getNext(Node* current) const;
         Node* getPrevious(Node* current) const;
-        TreeIterator begin();
-        TreeIterator rbegin();
-        TreeIterator end();
-        TreeIterator rend();
+        TreeIterator begin() const;
+        TreeIterator rbegin() const;
+        TreeIterator end() const;
+        TreeIterator rend() const;
 
-        // Non-recursive traversal
-        Node** inorderIterativeTraverse() const;
+        // Lazy traversal
+        TraversalRange traverse(int traverseType) const;
 
-        // Recursive traversal
+        // Array traversal (the caller owns the returned list)
+        Node** inorderIterativeTraverse() const;
         Node** preorderTraverse() const;
         Node** inorderTraverse() const;
         Node** postorderTraverse() const;
 
+        // Frequency queries
+        std::vector<Node*> topK(int k) const;
+        void buildFrequencyIndex();
+        bool hasFrequencyIndex() const;
+
+        // Bulk loading
+        bool ingest(const std::string& path, int threadsCount = 0);
+
+        // Snapshots
+        bool save(const std::string& path) const;
+        bool load(const std::string& path);
+
         // Operators
         friend std::istream& operator>>(
             std::istream& is,
@@ -78,28 +113,44 @@ namespace dsa
         void show(std::ostream& output, bool details) const;
         void show(std::ostream& output, Node** nodesList, bool details) const;
         void showPartial(std::ostream& output, Node** nodesList, bool top) const;
+        void show(
+            std::ostream& output,
+            const TraversalRange& nodes,
+            bool details) const;
+        void showPartial(
+            std::ostream& output,
+            const TraversalRange& nodes,
+            bool top) const;
 
         // Traversal helpers
         Node** createNodesList() const;
 
     private:
         // Helper methods
-        void init(Node* node);
+        void init();
         bool insertHelper(Node* newNode);
-        void compress(int nonThreadCount, int threadCount) const;
-        static void destroy(Node* node);
-        static void traverseHelper(
-            int traverseType,
-            Node* node,
-            Node** nodesList,
-            int& currentPosition);
+        bool insertBalanced(Node* newNode);
+        bool removeBalanced(const std::string& token);
+        void setSubtree(Node** path, const bool* links, int index, Node* subtree);
+        int balancedHeight() const;
+        static Node* rebalance(Node* node);
+        void compress(int nonThreadCount, int threadCount);
+        Node** traverseToList(int traverseType) const;
         static void show(
             std::ostream& output, Node** nodesList, int first, int last);
+        static void show(
+            std::ostream& output, TraversalIterator first, int count);
 
         // Tree data
         Node* rootNode;         // root node
         int treeSize;           // total number of nodes
         int treeHeight;         // tree height (i.e. number of layers)
+        bool selfBalancing;     // whether AVL balance is maintained
+        NodePool nodePool;      // storage of the nodes
+
+        // Frequency index (nodes by decreasing frequency)
+        std::vector<Node*> frequencyIndex;
+        bool frequencyIndexValid;   // cleared by every modification
     };
 
     /**
@@ -110,7 +161,7 @@ namespace dsa
     class TreeIterator
     {
     public:
-        TreeIterator(ThreadedBinarySearchTree* tbst);
+        TreeIterator(const ThreadedBinarySearchTree* tbst);
         TreeIterator(const TreeIterator& treeIter);
 
         // Operators
@@ -125,7 +176,115 @@ namespace dsa
     private:
         friend class ThreadedBinarySearchTree;
 
-        ThreadedBinarySearchTree* tbsTree;
+        const ThreadedBinarySearchTree* tbsTree;
         Node* currentNode;
     };
+
+    /**
+     * TraversalIterator
+     *
+     * Forward iterator walking the tree lazily in one of the traversal orders.
+     * Pre-order and in-order walks follow the threads and keep no state besides
+     * the current node; post-order keeps the ancestors of the current node.
+     */
+    class TraversalIterator
+    {
+    public:
+        TraversalIterator();
+        TraversalIterator(int traverseType, Node* root, int height);
+
+        // Operators
+        Node* operator*() const;
+        TraversalIterator& operator++();     // prefix
+        TraversalIterator operator++(int);   // postfix
+        bool operator==(const TraversalIterator& traversalIter) const;
+        bool operator!=(const TraversalIterator& traversalIter) const;
+
+    private:
+        void descend(Node* node);
+
+        int traversal;                  // traversal type
+        Node* currentNode;              // current node; NULL past the end
+        std::vector<Node*> ancestors;   // post-order path to current node
+    };
+
+    /**
+     * TraversalRange
+     *
+     * Range of the tree nodes in a given traversal order, usable with a
+     * range-based for loop. Nothing is allocated up front; the range is
+     * invalidated by any modification of the tree.
+     */
+    class TraversalRange
+    {
+    public:
+        TraversalRange(int traverseType, Node* root, int height);
+
+        TraversalIterator begin() const;
+        TraversalIterator end() const;
+
+    private:
+        int traversal;      // traversal type
+        Node* rootNode;     // root of the traversed tree
+        int treeHeight;     // height of the traversed tree
+    };
+
+    /**
+     * MatchIterator
+     *
+     * Forward iterator over the nodes matched by a prefix or range search.
+     * It walks the in-order threads from the first match and stops at the
+     * first node that does not match, or once the limit is reached.
+     */
+    class MatchIterator
+    {
+    public:
+        MatchIterator();
+        MatchIterator(const MatchRange* range, Node* first);
+
+        // Operators
+        Node* operator*() const;
+        MatchIterator& operator++();     // prefix
+        MatchIterator operator++(int);   // postfix
+        bool operator==(const MatchIterator& matchIter) const;
+        bool operator!=(const MatchIterator& matchIter) const;
+
+    private:
+        const MatchRange* matchRange;   // search being iterated
+        Node* currentNode;              // current match; NULL past the end
+        int remaining;                  // matches left before the limit
+    };
+
+    /**
+     * MatchRange
+     *
+     * Range of the nodes matched by a prefix search (tokens starting with
+     * the bound) or a range search (tokens lower than the bound, starting
+     * from the lower bound), usable with a range-based for loop. Matches are
+     * found lazily; the range is invalidated by any modification of the tree.
+     */
+    class MatchRange
+    {
+    public:
+        MatchRange(
+            const ThreadedBinarySearchTree* tbst,
+            Node* first,
+            const std::string& bound,
+            bool prefixMatch,
+            int limit);
+
+        MatchIterator begin() const;
+        MatchIterator end() const;
+
+    private:
+        friend class MatchIterator;
+
+        bool matches(const Node* node) const;
+
+        const ThreadedBinarySearchTree* tbsTree;    // searched tree
+        Node* firstNode;                            // first candidate
+        std::string matchBound;                     // prefix or upper bound
+        bool isPrefix;                              // prefix vs. range search
+        int matchLimit;                             // maximum number of matches
+    };
 }
@@ -0,0 +1,362 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ *
+ * This file contains the methods associated with the following classes:
+ *      ConcurrentThreadedBinarySearchTree  : class sharing a TBST between threads
+ *      ReadGuard                           : class granting read access
+ */
+
+#include "tbst_concurrent.hpp"
+
+#include <functional>
+#include <thread>
+
+namespace dsa
+{
+    /**
+     * ConcurrentThreadedBinarySearchTree()
+     *
+     * Default constructor
+     */
+    ConcurrentThreadedBinarySearchTree::ConcurrentThreadedBinarySearchTree()
+        : published(0),
+          versionIndex(0)
+    {
+    }
+
+    /**
+     * ConcurrentThreadedBinarySearchTree(bool balancing)
+     *
+     * Constructor
+     * @param balancing Whether the tree keeps itself balanced (AVL)
+     */
+    ConcurrentThreadedBinarySearchTree::ConcurrentThreadedBinarySearchTree(
+        bool balancing)
+        : trees{ ThreadedBinarySearchTree(balancing),
+                 ThreadedBinarySearchTree(balancing) },
+          published(0),
+          versionIndex(0)
+    {
+    }
+
+    /**
+     * ~ConcurrentThreadedBinarySearchTree()
+     *
+     * Destructor
+     * @pre No reader or writer is active.
+     */
+    ConcurrentThreadedBinarySearchTree::~ConcurrentThreadedBinarySearchTree()
+    {
+    }
+
+    /**
+     * read() const
+     *
+     * Method granting read access to the published tree. Readers never wait,
+     * even while a writer is active.
+     *
+     * @pre None
+     * @post The published tree is protected until the guard is destroyed.
+     * @return Read guard
+     */
+    ConcurrentThreadedBinarySearchTree::ReadGuard
+    ConcurrentThreadedBinarySearchTree::read() const
+    {
+        return ReadGuard(this);
+    }
+
+    /**
+     * contains(const std::string& token) const
+     *
+     * Method checking whether a token is in the tree.
+     *
+     * @param token Data to search for
+     * @pre None
+     * @post Searches the published tree
+     * @return True if the token is found; false otherwise
+     */
+    bool ConcurrentThreadedBinarySearchTree::contains(
+        const std::string& token) const
+    {
+        return read()->find(token) != nullptr;
+    }
+
+    /**
+     * getFrequency(const std::string& token) const
+     *
+     * Method retrieving the frequency of a token.
+     *
+     * @param token Data to search for
+     * @pre None
+     * @post Searches the published tree
+     * @return Frequency of the token; 0 if it is not found
+     */
+    int ConcurrentThreadedBinarySearchTree::getFrequency(
+        const std::string& token) const
+    {
+        ReadGuard guard = read();
+        Node* node = guard->find(token);
+
+        return (node != nullptr) ? node->data.getFrequency() : 0;
+    }
+
+    /**
+     * getNodesCount() const
+     *
+     * Method retrieving the tree size (in number of nodes).
+     *
+     * @pre None
+     * @post Returns the size of the published tree
+     * @return tree size
+     */
+    int ConcurrentThreadedBinarySearchTree::getNodesCount() const
+    {
+        return read()->getNodesCount();
+    }
+
+    /**
+     * clear()
+     *
+     * Method destroying all the nodes in the tree.
+     *
+     * @pre None
+     * @post Tree is left empty
+     */
+    void ConcurrentThreadedBinarySearchTree::clear()
+    {
+        write([](ThreadedBinarySearchTree& tree)
+        {
+            tree.clear();
+            return true;
+        });
+    }
+
+    /**
+     * insert(const std::string& token)
+     *
+     * Method inserting a new token into the tree.
+     *
+     * @param token Data to insert
+     * @pre token is valid (not empty)
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ConcurrentThreadedBinarySearchTree::insert(const std::string& token)
+    {
+        return write([&token](ThreadedBinarySearchTree& tree)
+        {
+            return tree.insert(token);
+        });
+    }
+
+    /**
+     * insert(const std::string& token, int frequency)
+     *
+     * Method inserting a token that occurred a given number of times.
+     *
+     * @param token Data to insert
+     * @param frequency Number of occurrences of the token
+     * @pre token is valid (not empty); frequency is positive
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ConcurrentThreadedBinarySearchTree::insert(
+        const std::string& token,
+        int frequency)
+    {
+        return write([&token, frequency](ThreadedBinarySearchTree& tree)
+        {
+            return tree.insert(token, frequency);
+        });
+    }
+
+    /**
+     * remove(const std::string& token)
+     *
+     * Method removing a token from the tree.
+     *
+     * @param token Data to remove
+     * @pre token is valid (not empty)
+     * @post Returns the outcome of the operation
+     * @return true on success; false on failure
+     */
+    bool ConcurrentThreadedBinarySearchTree::remove(const std::string& token)
+    {
+        return write([&token](ThreadedBinarySearchTree& tree)
+        {
+            return tree.remove(token);
+        });
+    }
+
+    /**
+     * write(Operation operation)
+     *
+     * Helper method applying an operation to both copies of the tree, each
+     * one only once no reader can access it.
+     *
+     * @param operation Operation to apply to a tree
+     * @pre None
+     * @post Both copies hold the outcome of the operation
+     * @return Outcome of the operation
+     */
+    template <typename Operation>
+    bool ConcurrentThreadedBinarySearchTree::write(Operation operation)
+    {
+        std::lock_guard<std::mutex> guard(writeLock);
+
+        int current = published.load();
+        bool success = operation(trees[1 - current]);
+
+        published.store(1 - current);
+        toggleVersionAndWait();
+        operation(trees[current]);
+
+        return success;
+    }
+
+    /**
+     * toggleVersionAndWait()
+     *
+     * Helper method waiting until no reader can still be using the copy of
+     * the tree that was published before the last swap. New readers are
+     * directed to the other read indicator while the current one drains.
+     *
+     * @pre Called by the writer, after swapping the copies
+     * @post No reader uses the unpublished copy
+     */
+    void ConcurrentThreadedBinarySearchTree::toggleVersionAndWait()
+    {
+        int previous = versionIndex.load();
+        int next = 1 - previous;
+
+        while (!isEmpty(next))
+        {
+            std::this_thread::yield();
+        }
+
+        versionIndex.store(next);
+
+        while (!isEmpty(previous))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * isEmpty(int version) const
+     *
+     * Helper method checking whether a read indicator has no reader.
+     *
+     * @param version Read indicator to check
+     * @pre None
+     * @post Checks every stripe of the read indicator
+     * @return True if no reader is announced; false otherwise
+     */
+    bool ConcurrentThreadedBinarySearchTree::isEmpty(int version) const
+    {
+        for (const ReadStripe& stripe : readIndicators[version])
+        {
+            if (stripe.readers.load() != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * getStripe()
+     *
+     * Helper method retrieving the read indicator stripe of the calling
+     * thread, so that readers on different threads rarely share a counter.
+     *
+     * @pre None
+     * @post Returns the stripe of the calling thread
+     * @return Stripe index
+     */
+    int ConcurrentThreadedBinarySearchTree::getStripe()
+    {
+        thread_local int stripe = static_cast<int>(
+            std::hash<std::thread::id>()(std::this_thread::get_id()) %
+            READ_INDICATOR_STRIPES);
+
+        return stripe;
+    }
+
+    /**
+     * ReadGuard(const ConcurrentThreadedBinarySearchTree* owner)
+     *
+     * Constructor announcing the reader and selecting the published tree.
+     * @param owner Tree to read
+     */
+    ConcurrentThreadedBinarySearchTree::ReadGuard::ReadGuard(
+        const ConcurrentThreadedBinarySearchTree* owner)
+        : concurrentTree(owner),
+          tree(nullptr),
+          version(owner->versionIndex.load()),
+          stripe(getStripe())
+    {
+        owner->readIndicators[version][stripe].readers.fetch_add(1);
+        tree = &owner->trees[owner->published.load()];
+    }
+
+    /**
+     * ReadGuard(ReadGuard&& source)
+     *
+     * Move constructor
+     * @param source Guard whose read access is taken over
+     */
+    ConcurrentThreadedBinarySearchTree::ReadGuard::ReadGuard(ReadGuard&& source)
+        : concurrentTree(source.concurrentTree),
+          tree(source.tree),
+          version(source.version),
+          stripe(source.stripe)
+    {
+        source.concurrentTree = nullptr;
+        source.tree = nullptr;
+    }
+
+    /**
+     * ~ReadGuard()
+     *
+     * Destructor announcing that the reader is gone.
+     */
+    ConcurrentThreadedBinarySearchTree::ReadGuard::~ReadGuard()
+    {
+        if (concurrentTree != nullptr)
+        {
+            concurrentTree->readIndicators[version][stripe].readers.fetch_sub(1);
+        }
+    }
+
+    /**
+     * operator*() const
+     *
+     * De-reference operator
+     *
+     * @pre The guard was not moved from.
+     * @post Retrieves the published tree
+     * @return Published tree
+     */
+    const ThreadedBinarySearchTree&
+    ConcurrentThreadedBinarySearchTree::ReadGuard::operator*() const
+    {
+        return *tree;
+    }
+
+    /**
+     * operator->() const
+     *
+     * Member access operator
+     *
+     * @pre The guard was not moved from.
+     * @post Retrieves the published tree
+     * @return Published tree
+     */
+    const ThreadedBinarySearchTree*
+    ConcurrentThreadedBinarySearchTree::ReadGuard::operator->() const
+    {
+        return tree;
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "tbst.hpp"
+
+namespace dsa
+{
+    // Number of read indicator stripes (readers spread over them by thread)
+    const int READ_INDICATOR_STRIPES = 16;
+
+    /**
+     * ConcurrentThreadedBinarySearchTree
+     *
+     * Class sharing a Threaded Binary Search Tree between any number of
+     * readers and writers, using the Left-Right technique: two copies of the
+     * tree are kept. Readers never block: they announce themselves on a read
+     * indicator and use the copy that is currently published. Writers are
+     * serialized; each update is applied to the unpublished copy, the copies
+     * are swapped, and once the readers of the old copy are gone the update
+     * is applied to it as well. A copy is never modified while it is read,
+     * so no node can be freed under a reader.
+     */
+    class ConcurrentThreadedBinarySearchTree
+    {
+    public:
+        class ReadGuard;
+
+        ConcurrentThreadedBinarySearchTree();
+        explicit ConcurrentThreadedBinarySearchTree(bool balancing);
+        ~ConcurrentThreadedBinarySearchTree();
+
+        ConcurrentThreadedBinarySearchTree(
+            const ConcurrentThreadedBinarySearchTree&) = delete;
+        ConcurrentThreadedBinarySearchTree& operator=(
+            const ConcurrentThreadedBinarySearchTree&) = delete;
+
+        // Read access
+        ReadGuard read() const;
+        bool contains(const std::string& token) const;
+        int getFrequency(const std::string& token) const;
+        int getNodesCount() const;
+
+        // Operations (serialized)
+        void clear();
+        bool insert(const std::string& token);
+        bool insert(const std::string& token, int frequency);
+        bool remove(const std::string& token);
+
+        /**
+         * ReadGuard
+         *
+         * Class granting read access to the published tree for as long as
+         * it lives. Nodes and iterators obtained through the guard must not
+         * be used after it is destroyed.
+         */
+        class ReadGuard
+        {
+        public:
+            ReadGuard(ReadGuard&& source);
+            ~ReadGuard();
+
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+            ReadGuard& operator=(ReadGuard&&) = delete;
+
+            // Operators
+            const ThreadedBinarySearchTree& operator*() const;
+            const ThreadedBinarySearchTree* operator->() const;
+
+        private:
+            friend class ConcurrentThreadedBinarySearchTree;
+
+            ReadGuard(const ConcurrentThreadedBinarySearchTree* owner);
+
+            const ConcurrentThreadedBinarySearchTree* concurrentTree;
+            const ThreadedBinarySearchTree* tree;
+            int version;
+            int stripe;
+        };
+
+    private:
+        // Read indicator stripe, on its own cache line
+        struct alignas(64) ReadStripe
+        {
+            std::atomic<long> readers{0};
+        };
+
+        // Helper methods
+        template <typename Operation>
+        bool write(Operation operation);
+        void toggleVersionAndWait();
+        bool isEmpty(int version) const;
+        static int getStripe();
+
+        ThreadedBinarySearchTree trees[2];          // both copies of the tree
+        std::atomic<int> published;                 // copy used by readers
+        std::atomic<int> versionIndex;              // read indicator in use
+        mutable ReadStripe readIndicators[2][READ_INDICATOR_STRIPES];
+        std::mutex writeLock;                       // serializes writers
+    };
+}
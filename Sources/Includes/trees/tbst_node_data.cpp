@@ -6,7 +6,9 @@
  */
 
 #include "node.hpp"
+#include "tbst_token_arena.hpp"
 
+#include <cstring>
 #include <iostream>
 
 namespace dsa
@@ -17,7 +19,14 @@ namespace dsa
      * Default constructor
      */
     nodeData::nodeData()
+#ifdef DSA_TBST_INTERN_TOKENS
+        : tokenData(""),
+        tokenLength(0),
+        tokenFrequency(0),
+        tokenPrefix(0)
+#else
         : tokenFrequency(0)
+#endif
     {
     }
 
@@ -29,31 +38,52 @@ namespace dsa
      * @param source Source data to copy.
      */
     nodeData::nodeData(const nodeData& source)
+#ifdef DSA_TBST_INTERN_TOKENS
+        : tokenData(source.tokenData),
+        tokenLength(source.tokenLength),
+        tokenFrequency(source.tokenFrequency),
+        tokenPrefix(source.tokenPrefix)
+#else
         : tokenFrequency(source.tokenFrequency),
         tokenData(source.tokenData)
+#endif
     {
     }
 
     /**
-     * nodeData(const string& token)
+     * nodeData(const nodeData& source, TokenArena& arena)
      *
-     * Constructor
+     * Constructor copying data into another tree
      *
-     * @param token Input token to copy & store.
+     * @param source Source data to copy.
+     * @param arena Arena interning the token of the copy.
      */
-    nodeData::nodeData(const std::string& token)
-        : tokenFrequency(0)
+    nodeData::nodeData(const nodeData& source, TokenArena& arena)
+        : nodeData(source)
     {
-        setToken(token);
+#ifdef DSA_TBST_INTERN_TOKENS
+        if (tokenLength > 0)
+        {
+            tokenData = arena.intern(getTokenView());
+        }
+#else
+        // Tokens are stored by the data itself
+        static_cast<void>(arena);
+#endif
     }
 
     /**
-     * ~nodeData()
+     * nodeData(const string& token, TokenArena& arena)
+     *
+     * Constructor
      *
-     * Destructor
+     * @param token Input token to copy & store.
+     * @param arena Arena interning the token.
      */
-    nodeData::~nodeData()
+    nodeData::nodeData(const std::string& token, TokenArena& arena)
+        : nodeData()
     {
+        setToken(token, arena);
     }
 
     /**
@@ -67,7 +97,11 @@ namespace dsa
      */
     bool nodeData::isValid() const
     {
+#ifdef DSA_TBST_INTERN_TOKENS
+        return (tokenLength > 0) && (tokenFrequency > 0);
+#else
         return !tokenData.empty() && (tokenFrequency > 0);
+#endif
     }
 
     /**
@@ -95,7 +129,29 @@ namespace dsa
      */
     std::string nodeData::getToken() const
     {
+#ifdef DSA_TBST_INTERN_TOKENS
+        return std::string(tokenData, tokenLength);
+#else
+        return tokenData;
+#endif
+    }
+
+    /**
+     * getTokenView() const
+     *
+     * Method retrieving the current token without copying it.
+     *
+     * @pre None
+     * @post Returns a view of the current token, valid until it changes
+     * @return token view
+     */
+    std::string_view nodeData::getTokenView() const
+    {
+#ifdef DSA_TBST_INTERN_TOKENS
+        return std::string_view(tokenData, tokenLength);
+#else
         return tokenData;
+#endif
     }
 
     /**
@@ -115,19 +171,44 @@ namespace dsa
     }
 
     /**
-     * setToken(const string& token)
+     * increaseFrequency(int count)
+     *
+     * Method increasing the token frequency by a given count (if token is valid)
+     *
+     * @param count Number of occurrences to add.
+     * @pre data token should be valid (i.e. not empty); count is positive
+     * @post token frequency is increased by count
+     */
+    void nodeData::increaseFrequency(int count)
+    {
+        if (isValid() && (count > 0))
+        {
+            tokenFrequency += count;
+        }
+    }
+
+    /**
+     * setToken(const string& token, TokenArena& arena)
      *
      * Method for setting the data token.
      *
      * @param token Input token to set.
+     * @param arena Arena interning the token (see DSA_TBST_INTERN_TOKENS).
      * @pre Input token is valid (i.e. not empty)
      * @post local token data and frequency are set.
      */
-    void nodeData::setToken(const std::string& token)
+    void nodeData::setToken(const std::string& token, TokenArena& arena)
     {
         if (!token.empty())
         {
+#ifdef DSA_TBST_INTERN_TOKENS
+            tokenData = arena.intern(token);
+            tokenLength = static_cast<std::uint32_t>(token.size());
+            tokenPrefix = makePrefix(token.data(), token.size());
+#else
+            static_cast<void>(arena);
             tokenData = token;
+#endif
             tokenFrequency = 1;
         }
     }
@@ -147,7 +228,70 @@ namespace dsa
      */
     int nodeData::compare(const std::string& token) const
     {
+#ifdef DSA_TBST_INTERN_TOKENS
+        std::uint64_t prefix = makePrefix(token.data(), token.size());
+
+        if (tokenPrefix != prefix)
+        {
+            return (tokenPrefix < prefix) ? -1 : 1;
+        }
+
+        return compareTokens(tokenData, tokenLength, token.data(), token.size());
+#else
         return tokenData.compare(token);
+#endif
+    }
+
+    /**
+     * compare(const nodeData& data)
+     *
+     * Method comparing the local token with the token of another node data.
+     *
+     * @param data Node data to compare against.
+     * @pre both data tokens are valid (i.e. not empty)
+     * @post local data is compared against input data
+     * @return Comparison result as follows:
+     *      < 0 : local token < target data
+     *        0 : local token == target data
+     *      > 0 : local token > target data
+     */
+    int nodeData::compare(const nodeData& data) const
+    {
+#ifdef DSA_TBST_INTERN_TOKENS
+        if (tokenData == data.tokenData)
+        {
+            // Interned tokens are equal exactly when they share their storage
+            return 0;
+        }
+
+        if (tokenPrefix != data.tokenPrefix)
+        {
+            return (tokenPrefix < data.tokenPrefix) ? -1 : 1;
+        }
+
+        return compareTokens(
+            tokenData, tokenLength, data.tokenData, data.tokenLength);
+#else
+        return tokenData.compare(data.tokenData);
+#endif
+    }
+
+    /**
+     * startsWith(const std::string& prefix) const
+     *
+     * Method checking whether the current token starts with a prefix.
+     *
+     * @param prefix Prefix to look for
+     * @pre None
+     * @post The token is compared against the prefix.
+     * @return True if the token starts with the prefix; false otherwise.
+     */
+    bool nodeData::startsWith(const std::string& prefix) const
+    {
+        std::string_view token = getTokenView();
+
+        return (token.size() >= prefix.size()) &&
+               (token.compare(0, prefix.size(), prefix) == 0);
     }
 
     /**
@@ -226,13 +370,75 @@ namespace dsa
     {
         if (details)
         {
-            output << "Token: " << tokenData.c_str();
+            output << "Token: " << getToken().c_str();
             output << ", Frequency: " << tokenFrequency;
         }
         else
         {
-            output << tokenData.c_str();
+            output << getToken().c_str();
             output << "[" << tokenFrequency << "]";
         }
     }
+
+#ifdef DSA_TBST_INTERN_TOKENS
+    /**
+     * makePrefix(const char* token, std::size_t length)
+     *
+     * Helper method packing the first 8 bytes of a token into an integer,
+     * zero-padded, so that comparing prefixes as integers orders them as
+     * the tokens themselves.
+     *
+     * @param token Token data
+     * @param length Token length
+     * @pre None
+     * @post None
+     * @return Big-endian prefix of the token
+     */
+    std::uint64_t nodeData::makePrefix(const char* token, std::size_t length)
+    {
+        std::uint64_t prefix = 0;
+        std::size_t bytes = (length < sizeof(prefix)) ? length : sizeof(prefix);
+
+        for (std::size_t i = 0; i < sizeof(prefix); i++)
+        {
+            prefix <<= 8;
+            if (i < bytes)
+            {
+                prefix |= static_cast<unsigned char>(token[i]);
+            }
+        }
+
+        return prefix;
+    }
+
+    /**
+     * compareTokens(const char* left, std::size_t leftLength,
+     *               const char* right, std::size_t rightLength)
+     *
+     * Helper method comparing two tokens whose prefixes are equal.
+     *
+     * @param left Left token data
+     * @param leftLength Left token length
+     * @param right Right token data
+     * @param rightLength Right token length
+     * @pre Token prefixes are equal
+     * @post None
+     * @return Comparison result (as for compare)
+     */
+    int nodeData::compareTokens(
+        const char* left, std::size_t leftLength,
+        const char* right, std::size_t rightLength)
+    {
+        std::size_t common = (leftLength < rightLength) ? leftLength : rightLength;
+        std::size_t skipped = (common < 8) ? common : 8;
+        int result = std::memcmp(left + skipped, right + skipped, common - skipped);
+
+        if (result == 0)
+        {
+            result = (leftLength < rightLength) ? -1 : (leftLength > rightLength) ? 1 : 0;
+        }
+
+        return result;
+    }
+#endif
 }
@@ -3,10 +3,20 @@
  */
 
 #pragma once
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <string_view>
+
+// Define DSA_TBST_INTERN_TOKENS to intern the tokens into the TokenArena of their tree.
+// Nodes then hold a pointer to the interned token and its first 8 bytes inline,
+// so most comparisons are resolved without touching the token characters and
+// without any allocation.
 
 namespace dsa
 {
+    class TokenArena;
+
     /**
      * nodeData
      *
@@ -17,20 +27,24 @@ namespace dsa
     public:
         nodeData();
         nodeData(const nodeData& source);
-        nodeData(const std::string& token);
-        ~nodeData();
+        nodeData(const nodeData& source, TokenArena& arena);
+        nodeData(const std::string& token, TokenArena& arena);
 
         // Properties
         bool isValid() const;
         int getFrequency() const;
         std::string getToken() const;
+        std::string_view getTokenView() const;
 
         // Operations
         void increaseFrequency();
-        void setToken(const std::string& token);
+        void increaseFrequency(int count);
+        void setToken(const std::string& token, TokenArena& arena);
 
         // Comparison
         int compare(const std::string& token) const;
+        int compare(const nodeData& data) const;
+        bool startsWith(const std::string& prefix) const;
 
         // Operators
         bool operator==(const std::string& token) const;
@@ -42,7 +56,20 @@ namespace dsa
         void show(std::ostream& output, bool details) const;
 
     private:
+#ifdef DSA_TBST_INTERN_TOKENS
+        // Helper methods
+        static std::uint64_t makePrefix(const char* token, std::size_t length);
+        static int compareTokens(
+            const char* left, std::size_t leftLength,
+            const char* right, std::size_t rightLength);
+
+        const char* tokenData;      // interned token data (owned by TokenArena)
+        std::uint32_t tokenLength;  // token length
+        int tokenFrequency;         // token frequency
+        std::uint64_t tokenPrefix;  // first 8 bytes of the token, big-endian
+#else
         int tokenFrequency;     // token frequency
         std::string tokenData;  // token data
+#endif
     };
 }
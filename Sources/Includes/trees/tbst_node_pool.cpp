@@ -0,0 +1,254 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ *
+ * This file contains the methods for NodePool class
+ * that allocates the nodes of the TBST.
+ */
+
+#include "tbst_node_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dsa
+{
+    // Number of nodes per chunk
+    const size_t NODES_PER_CHUNK = 1024;
+
+    /**
+     * NodePool()
+     *
+     * Default constructor
+     */
+    NodePool::NodePool()
+        : chunkUsed(NODES_PER_CHUNK),
+          freeList(nullptr),
+          nodesCount(0)
+    {
+    }
+
+    /**
+     * ~NodePool()
+     *
+     * Destructor
+     */
+    NodePool::~NodePool()
+    {
+        clear();
+    }
+
+    /**
+     * getNodesCount() const
+     *
+     * Method retrieving the number of live nodes.
+     *
+     * @pre None
+     * @post Returns the number of live nodes
+     * @return number of live nodes
+     */
+    size_t NodePool::getNodesCount() const
+    {
+        return nodesCount;
+    }
+
+    /**
+     * create()
+     *
+     * Method creating an empty node.
+     *
+     * @pre None
+     * @post Returns a new node
+     * @return New node
+     */
+    Node* NodePool::create()
+    {
+        Node* node = new (allocate()) Node();
+        nodesCount++;
+        return node;
+    }
+
+    /**
+     * create(const std::string& token)
+     *
+     * Method creating a node holding a token.
+     *
+     * @param token Token to store
+     * @pre None
+     * @post Returns a new node
+     * @return New node
+     */
+    Node* NodePool::create(const std::string& token)
+    {
+        Node* node = new (allocate()) Node(token, tokens);
+        nodesCount++;
+        return node;
+    }
+
+    /**
+     * create(const Node& source)
+     *
+     * Method creating a node holding a copy of the data of another node,
+     * possibly of another pool.
+     *
+     * @param source Node to copy
+     * @pre None
+     * @post Returns a new node
+     * @return New node
+     */
+    Node* NodePool::create(const Node& source)
+    {
+        Node* node = new (allocate()) Node(source, tokens);
+        nodesCount++;
+        return node;
+    }
+
+    /**
+     * release(Node* node)
+     *
+     * Method destroying a node and recycling its storage.
+     *
+     * @param node Node to release
+     * @pre Node was created by this pool and was not released yet
+     * @post Node is destroyed
+     */
+    void NodePool::release(Node* node)
+    {
+        if (node != nullptr)
+        {
+            node->~Node();
+
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->next = freeList;
+            freeList = slot;
+            nodesCount--;
+        }
+    }
+
+    /**
+     * clear()
+     *
+     * Method destroying all the nodes and freeing their storage.
+     *
+     * @pre None
+     * @post Pool is left empty
+     */
+    void NodePool::clear()
+    {
+        if (!std::is_trivially_destructible<Node>::value && (nodesCount > 0))
+        {
+            destroyNodes();
+        }
+
+        chunks.clear();
+        chunkUsed = NODES_PER_CHUNK;
+        freeList = nullptr;
+        nodesCount = 0;
+        tokens.clear();
+    }
+
+    /**
+     * swap(NodePool& other)
+     *
+     * Method exchanging the nodes of two pools.
+     *
+     * @param other Pool to exchange nodes with
+     * @pre None
+     * @post Each pool owns the nodes of the other one
+     */
+    void NodePool::swap(NodePool& other)
+    {
+        std::swap(chunks, other.chunks);
+        std::swap(chunkUsed, other.chunkUsed);
+        std::swap(freeList, other.freeList);
+        std::swap(nodesCount, other.nodesCount);
+        tokens.swap(other.tokens);
+    }
+
+    /**
+     * allocate()
+     *
+     * Helper method retrieving storage for one node, from the free list if
+     * possible, otherwise from the last chunk.
+     *
+     * @pre None
+     * @post Returns uninitialized node storage
+     * @return Node storage
+     */
+    void* NodePool::allocate()
+    {
+        Slot* slot;
+
+        if (freeList != nullptr)
+        {
+            slot = freeList;
+            freeList = slot->next;
+        }
+        else
+        {
+            if (chunkUsed == NODES_PER_CHUNK)
+            {
+                chunks.emplace_back(new Slot[NODES_PER_CHUNK]);
+                chunkUsed = 0;
+            }
+            slot = &chunks.back()[chunkUsed++];
+        }
+
+        return slot->storage;
+    }
+
+    /**
+     * destroyNodes()
+     *
+     * Helper method running the destructors of all the live nodes. Released
+     * slots are located first, so that only live nodes are destroyed.
+     *
+     * @pre None
+     * @post All live nodes are destroyed; storage is not freed.
+     */
+    void NodePool::destroyNodes()
+    {
+        std::vector<std::pair<Slot*, size_t>> starts;
+        std::vector<bool> released(chunks.size() * NODES_PER_CHUNK, false);
+        std::less<Slot*> before;
+
+        starts.reserve(chunks.size());
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            starts.emplace_back(chunks[i].get(), i);
+        }
+        std::sort(starts.begin(), starts.end(),
+            [&before](const std::pair<Slot*, size_t>& left,
+                      const std::pair<Slot*, size_t>& right)
+            {
+                return before(left.first, right.first);
+            });
+
+        for (Slot* slot = freeList; slot != nullptr; slot = slot->next)
+        {
+            auto chunk = std::upper_bound(starts.begin(), starts.end(), slot,
+                [&before](Slot* target, const std::pair<Slot*, size_t>& start)
+                {
+                    return before(target, start.first);
+                }) - 1;
+
+            released[chunk->second * NODES_PER_CHUNK +
+                     static_cast<size_t>(slot - chunk->first)] = true;
+        }
+
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            size_t used = (i + 1 == chunks.size()) ? chunkUsed : NODES_PER_CHUNK;
+
+            for (size_t j = 0; j < used; j++)
+            {
+                if (!released[i * NODES_PER_CHUNK + j])
+                {
+                    reinterpret_cast<Node*>(chunks[i][j].storage)->~Node();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "node.hpp"
+#include "tbst_token_arena.hpp"
+
+namespace dsa
+{
+    /**
+     * NodePool
+     *
+     * Class allocating the nodes of a Threaded Binary Search Tree from large
+     * chunks. Released nodes are recycled through a free list, and clear()
+     * releases every node at once: it only frees the chunks when nodes are
+     * trivially destructible (see DSA_TBST_INTERN_TOKENS), and otherwise
+     * runs the destructors chunk by chunk, without walking the tree.
+     * The pool also owns the arena interning the tokens of its nodes, so
+     * that it is released along with them.
+     */
+    class NodePool
+    {
+    public:
+        NodePool();
+        ~NodePool();
+
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        // Properties
+        size_t getNodesCount() const;
+
+        // Operations
+        Node* create();
+        Node* create(const std::string& token);
+        Node* create(const Node& source);
+        void release(Node* node);
+        void clear();
+        void swap(NodePool& other);
+
+    private:
+        // Storage for one node, or the free list link once released
+        union Slot
+        {
+            Slot* next;
+            alignas(Node) unsigned char storage[sizeof(Node)];
+        };
+
+        // Helper methods
+        void* allocate();
+        void destroyNodes();
+
+        std::vector<std::unique_ptr<Slot[]>> chunks;    // node storage
+        size_t chunkUsed;                               // slots used in last chunk
+        Slot* freeList;                                 // released slots
+        size_t nodesCount;                              // live nodes
+        TokenArena tokens;                              // interned tokens
+    };
+}
@@ -0,0 +1,466 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ *
+ * This file contains the methods for ReportWriter class
+ * that dumps the nodes of the TBST.
+ */
+
+#include "tbst_report_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#define DSA_TBST_HAS_POSIX_IO
+#endif
+
+namespace dsa
+{
+    // Largest formatted integer (sign and digits)
+    const size_t INTEGER_MAX_CHARS = 12;
+
+    /**
+     * ReportWriter(const std::string& path, int format, size_t bufferSize)
+     *
+     * Constructor creating (or truncating) the report file.
+     * @param path Path of the report file
+     * @param format Report format (REPORT_TEXT, REPORT_CSV, REPORT_BINARY)
+     * @param bufferSize Size of the output buffer
+     */
+    ReportWriter::ReportWriter(
+        const std::string& path,
+        int format,
+        size_t bufferSize)
+        : reportFormat(format),
+          buffer(std::max<size_t>(bufferSize, INTEGER_MAX_CHARS * 2)),
+          bufferUsed(0),
+          stream(nullptr),
+          descriptor(-1),
+          ownsOutput(false),
+          good(false),
+          recordsCount(0),
+          closed(false)
+    {
+#ifdef DSA_TBST_HAS_POSIX_IO
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ownsOutput = (descriptor >= 0);
+        good = ownsOutput;
+#else
+        std::ofstream* file =
+            new std::ofstream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        stream = file;
+        ownsOutput = true;
+        good = file->is_open();
+#endif
+    }
+
+    /**
+     * ReportWriter(std::ostream& output, int format, size_t bufferSize)
+     *
+     * Constructor writing the report into an output stream.
+     * @param output Output stream
+     * @param format Report format (REPORT_TEXT, REPORT_CSV, REPORT_BINARY)
+     * @param bufferSize Size of the output buffer
+     */
+    ReportWriter::ReportWriter(
+        std::ostream& output,
+        int format,
+        size_t bufferSize)
+        : reportFormat(format),
+          buffer(std::max<size_t>(bufferSize, INTEGER_MAX_CHARS * 2)),
+          bufferUsed(0),
+          stream(&output),
+          descriptor(-1),
+          ownsOutput(false),
+          good(output.good()),
+          recordsCount(0),
+          closed(false)
+    {
+    }
+
+    /**
+     * ~ReportWriter()
+     *
+     * Destructor completing the report.
+     */
+    ReportWriter::~ReportWriter()
+    {
+        close();
+    }
+
+    /**
+     * isGood() const
+     *
+     * Method checking whether every write succeeded so far.
+     *
+     * @pre None
+     * @post Checks the writer state
+     * @return True if no write failed; false otherwise
+     */
+    bool ReportWriter::isGood() const
+    {
+        return good;
+    }
+
+    /**
+     * write(const Node* node)
+     *
+     * Method appending the record of a node to the report.
+     *
+     * @param node Node to report
+     * @pre The report is not closed
+     * @post The record is buffered (and emitted once the buffer is full)
+     */
+    void ReportWriter::write(const Node* node)
+    {
+        if ((node != nullptr) && !closed)
+        {
+            std::string_view token = node->data.getTokenView();
+            int frequency = node->data.getFrequency();
+
+            switch (reportFormat)
+            {
+                case REPORT_CSV:
+                    writeCsv(token, frequency);
+                    break;
+
+                case REPORT_BINARY:
+                    writeBinary(token, frequency);
+                    break;
+
+                default:
+                    writeText(token, frequency);
+                    break;
+            }
+
+            recordsCount++;
+        }
+    }
+
+    /**
+     * write(const TraversalRange& nodes)
+     *
+     * Method appending the records of a range of nodes to the report.
+     *
+     * @param nodes Range of nodes to report
+     * @pre The report is not closed
+     * @post The records are buffered (and emitted as the buffer fills up)
+     */
+    void ReportWriter::write(const TraversalRange& nodes)
+    {
+        for (const Node* node : nodes)
+        {
+            write(node);
+        }
+    }
+
+    /**
+     * write(const ThreadedBinarySearchTree& tree)
+     *
+     * Method appending the records of all the nodes of a tree (in order).
+     *
+     * @param tree Tree to report
+     * @pre The report is not closed
+     * @post The records are buffered (and emitted as the buffer fills up)
+     */
+    void ReportWriter::write(const ThreadedBinarySearchTree& tree)
+    {
+        write(tree.traverse(INORDER));
+    }
+
+    /**
+     * flush()
+     *
+     * Method emitting the buffered output and flushing the output stream.
+     *
+     * @pre None
+     * @post The buffer is empty
+     * @return true if every write succeeded so far; false otherwise
+     */
+    bool ReportWriter::flush()
+    {
+        drain();
+
+        if (stream != nullptr)
+        {
+            stream->flush();
+            good = good && !stream->fail();
+        }
+
+        return good;
+    }
+
+    /**
+     * close()
+     *
+     * Method completing the report: the last text line is terminated, the
+     * buffered output is emitted and the report file (if any) is closed.
+     *
+     * @pre None
+     * @post The report is complete; further records are ignored
+     * @return true if every write succeeded; false otherwise
+     */
+    bool ReportWriter::close()
+    {
+        if (!closed)
+        {
+            if ((reportFormat == REPORT_TEXT) && (recordsCount > 0))
+            {
+                append("\r\n");
+            }
+
+            flush();
+            closed = true;
+
+            if (ownsOutput)
+            {
+#ifdef DSA_TBST_HAS_POSIX_IO
+                good = (::close(descriptor) == 0) && good;
+                descriptor = -1;
+#else
+                delete stream;
+                stream = nullptr;
+#endif
+                ownsOutput = false;
+            }
+        }
+
+        return good;
+    }
+
+    /**
+     * drain()
+     *
+     * Helper method emitting the buffered output, leaving the flushing of
+     * the output stream to flush().
+     *
+     * @pre None
+     * @post The buffer is empty
+     */
+    void ReportWriter::drain()
+    {
+        if (bufferUsed > 0)
+        {
+            good = emit(buffer.data(), bufferUsed) && good;
+            bufferUsed = 0;
+        }
+    }
+
+    /**
+     * reserve(size_t length)
+     *
+     * Helper method reserving room in the buffer, emitting the buffered
+     * output first if it does not fit.
+     *
+     * @param length Number of bytes to reserve
+     * @pre length does not exceed the buffer size
+     * @post Returns where to write the bytes; they count as buffered output
+     * @return Reserved room
+     */
+    char* ReportWriter::reserve(size_t length)
+    {
+        if (bufferUsed + length > buffer.size())
+        {
+            drain();
+        }
+
+        char* room = buffer.data() + bufferUsed;
+        bufferUsed += length;
+
+        return room;
+    }
+
+    /**
+     * append(std::string_view bytes)
+     *
+     * Helper method appending bytes to the buffered output. Byte sequences
+     * larger than the buffer are emitted directly.
+     *
+     * @param bytes Bytes to append
+     * @pre None
+     * @post The bytes are buffered or emitted
+     */
+    void ReportWriter::append(std::string_view bytes)
+    {
+        if (bytes.size() > buffer.size())
+        {
+            drain();
+            good = emit(bytes.data(), bytes.size()) && good;
+        }
+        else if (!bytes.empty())
+        {
+            std::memcpy(reserve(bytes.size()), bytes.data(), bytes.size());
+        }
+    }
+
+    /**
+     * appendInteger(int value)
+     *
+     * Helper method appending an integer in decimal.
+     *
+     * @param value Integer to append
+     * @pre None
+     * @post The digits are buffered
+     */
+    void ReportWriter::appendInteger(int value)
+    {
+        char* room = reserve(INTEGER_MAX_CHARS);
+        char* last = std::to_chars(room, room + INTEGER_MAX_CHARS, value).ptr;
+
+        // Give back the unused room
+        bufferUsed -= INTEGER_MAX_CHARS - static_cast<size_t>(last - room);
+    }
+
+    /**
+     * appendUnsigned(std::uint32_t value)
+     *
+     * Helper method appending a 32-bit integer in little-endian order.
+     *
+     * @param value Integer to append
+     * @pre None
+     * @post The bytes are buffered
+     */
+    void ReportWriter::appendUnsigned(std::uint32_t value)
+    {
+        char* room = reserve(sizeof(value));
+
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            room[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    /**
+     * writeText(std::string_view token, int frequency)
+     *
+     * Helper method appending a text record: token[frequency], laid out
+     * NODES_PER_LINE per line as by ThreadedBinarySearchTree::show().
+     *
+     * @param token Token to report
+     * @param frequency Frequency of the token
+     * @pre None
+     * @post The record is buffered
+     */
+    void ReportWriter::writeText(std::string_view token, int frequency)
+    {
+        if ((recordsCount % NODES_PER_LINE) == 0)
+        {
+            append((recordsCount > 0) ? "\r\n\t" : "\t");
+        }
+
+        append(token);
+        append("[");
+        appendInteger(frequency);
+        append("] ");
+    }
+
+    /**
+     * writeCsv(std::string_view token, int frequency)
+     *
+     * Helper method appending a CSV record; the header comes first. Tokens
+     * holding quotes, commas or line breaks are quoted.
+     *
+     * @param token Token to report
+     * @param frequency Frequency of the token
+     * @pre None
+     * @post The record is buffered
+     */
+    void ReportWriter::writeCsv(std::string_view token, int frequency)
+    {
+        if (recordsCount == 0)
+        {
+            append("token,frequency\r\n");
+        }
+
+        if (token.find_first_of("\",\r\n") == std::string_view::npos)
+        {
+            append(token);
+        }
+        else
+        {
+            size_t start = 0;
+            size_t quote = token.find('"');
+
+            append("\"");
+            while (quote != std::string_view::npos)
+            {
+                append(token.substr(start, quote + 1 - start));
+                append("\"");
+                start = quote + 1;
+                quote = token.find('"', start);
+            }
+            append(token.substr(start));
+            append("\"");
+        }
+
+        append(",");
+        appendInteger(frequency);
+        append("\r\n");
+    }
+
+    /**
+     * writeBinary(std::string_view token, int frequency)
+     *
+     * Helper method appending a binary record: token length, token bytes
+     * and frequency, with integers as little-endian 32-bit values.
+     *
+     * @param token Token to report
+     * @param frequency Frequency of the token
+     * @pre None
+     * @post The record is buffered
+     */
+    void ReportWriter::writeBinary(std::string_view token, int frequency)
+    {
+        appendUnsigned(static_cast<std::uint32_t>(token.size()));
+        append(token);
+        appendUnsigned(static_cast<std::uint32_t>(frequency));
+    }
+
+    /**
+     * emit(const char* bytes, size_t length)
+     *
+     * Helper method writing bytes to the report output.
+     *
+     * @param bytes Bytes to write
+     * @param length Number of bytes to write
+     * @pre None
+     * @post The bytes are written (unless an error occurs)
+     * @return true on success; false on failure
+     */
+    bool ReportWriter::emit(const char* bytes, size_t length)
+    {
+        bool success = good;
+
+        if (success && (stream != nullptr))
+        {
+            stream->write(bytes, static_cast<std::streamsize>(length));
+            success = !stream->fail();
+        }
+#ifdef DSA_TBST_HAS_POSIX_IO
+        else if (success)
+        {
+            while (success && (length > 0))
+            {
+                ssize_t written = ::write(descriptor, bytes, length);
+
+                if (written > 0)
+                {
+                    bytes += written;
+                    length -= static_cast<size_t>(written);
+                }
+                else
+                {
+                    success = (written < 0) && (errno == EINTR);
+                }
+            }
+        }
+#endif
+
+        return success;
+    }
+}
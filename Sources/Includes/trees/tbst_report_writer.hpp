@@ -0,0 +1,81 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "tbst.hpp"
+
+namespace dsa
+{
+    // Report formats
+    const int REPORT_TEXT = 0;      // token[frequency], as displayed by show()
+    const int REPORT_CSV = 1;       // token,frequency lines (tokens quoted as needed)
+    const int REPORT_BINARY = 2;    // u32 length, token, u32 frequency (little-endian)
+
+    // Default size of the report buffer
+    const size_t REPORT_BUFFER_SIZE = 1 << 20;
+
+    /**
+     * ReportWriter
+     *
+     * Class dumping the nodes of a Threaded Binary Search Tree. Records are
+     * formatted straight into a large reusable buffer (integers through
+     * std::to_chars), which is emitted with a single write() per fill, either
+     * to a file descriptor or to an output stream.
+     */
+    class ReportWriter
+    {
+    public:
+        ReportWriter(
+            const std::string& path,
+            int format,
+            size_t bufferSize = REPORT_BUFFER_SIZE);
+        ReportWriter(
+            std::ostream& output,
+            int format,
+            size_t bufferSize = REPORT_BUFFER_SIZE);
+        ~ReportWriter();
+
+        ReportWriter(const ReportWriter&) = delete;
+        ReportWriter& operator=(const ReportWriter&) = delete;
+
+        // Properties
+        bool isGood() const;
+
+        // Operations
+        void write(const Node* node);
+        void write(const TraversalRange& nodes);
+        void write(const ThreadedBinarySearchTree& tree);
+        bool flush();
+        bool close();
+
+    private:
+        // Helper methods
+        void drain();
+        char* reserve(size_t length);
+        void append(std::string_view bytes);
+        void appendInteger(int value);
+        void appendUnsigned(std::uint32_t value);
+        void writeText(std::string_view token, int frequency);
+        void writeCsv(std::string_view token, int frequency);
+        void writeBinary(std::string_view token, int frequency);
+        bool emit(const char* bytes, size_t length);
+
+        int reportFormat;               // REPORT_TEXT, REPORT_CSV or REPORT_BINARY
+        std::vector<char> buffer;       // pending output
+        size_t bufferUsed;              // bytes of pending output
+        std::ostream* stream;           // output stream (if any)
+        int descriptor;                 // output file (if any)
+        bool ownsOutput;                // whether to close the output file
+        bool good;                      // whether every write succeeded
+        long recordsCount;              // records written so far
+        bool closed;                    // whether the report was completed
+    };
+}
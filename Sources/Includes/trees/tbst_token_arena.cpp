@@ -0,0 +1,142 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ *
+ * This file contains the methods for TokenArena class
+ * that interns the tokens stored in the TBST.
+ */
+
+#include "tbst_token_arena.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace dsa
+{
+    // Size of the blocks holding the interned tokens
+    const size_t TOKEN_BLOCK_SIZE = 64 * 1024;
+
+    /**
+     * TokenArena()
+     *
+     * Default constructor
+     */
+    TokenArena::TokenArena()
+        : blockUsed(0)
+    {
+    }
+
+    /**
+     * ~TokenArena()
+     *
+     * Destructor
+     */
+    TokenArena::~TokenArena()
+    {
+    }
+
+    /**
+     * getTokensCount() const
+     *
+     * Method retrieving the number of distinct tokens interned so far.
+     *
+     * @pre None
+     * @post Returns the number of interned tokens
+     * @return number of interned tokens
+     */
+    size_t TokenArena::getTokensCount() const
+    {
+        return index.size();
+    }
+
+    /**
+     * intern(std::string_view token)
+     *
+     * Method returning the interned copy of a token, copying it into the
+     * arena the first time it is seen.
+     *
+     * @param token Token to intern
+     * @pre None
+     * @post Token is interned
+     * @return Stable, NUL-terminated copy of the token
+     */
+    const char* TokenArena::intern(std::string_view token)
+    {
+        auto found = index.find(token);
+
+        if (found != index.end())
+        {
+            return found->second;
+        }
+
+        char* copy = allocate(token.size() + 1);
+
+        std::memcpy(copy, token.data(), token.size());
+        copy[token.size()] = '\0';
+        index.emplace(std::string_view(copy, token.size()), copy);
+
+        return copy;
+    }
+
+    /**
+     * clear()
+     *
+     * Method freeing all the interned tokens.
+     *
+     * @pre No node refers to the interned tokens anymore
+     * @post Arena is left empty
+     */
+    void TokenArena::clear()
+    {
+        index.clear();
+        blocks.clear();
+        blockUsed = 0;
+    }
+
+    /**
+     * swap(TokenArena& other)
+     *
+     * Method exchanging the interned tokens of two arenas.
+     *
+     * @param other Arena to exchange tokens with
+     * @pre None
+     * @post Each arena owns the tokens of the other one
+     */
+    void TokenArena::swap(TokenArena& other)
+    {
+        std::swap(blocks, other.blocks);
+        std::swap(blockUsed, other.blockUsed);
+        std::swap(index, other.index);
+    }
+
+    /**
+     * allocate(size_t length)
+     *
+     * Helper method reserving space in the arena.
+     * Tokens larger than a block get a dedicated block.
+     *
+     * @param length Number of bytes to reserve
+     * @pre None
+     * @post Space is reserved
+     * @return Reserved space
+     */
+    char* TokenArena::allocate(size_t length)
+    {
+        if (length > TOKEN_BLOCK_SIZE)
+        {
+            // Dedicated block, kept in front so the last block stays the current one
+            blocks.emplace(blocks.begin(), new char[length]);
+            return blocks.front().get();
+        }
+
+        if (blocks.empty() || (length > TOKEN_BLOCK_SIZE - blockUsed))
+        {
+            blocks.emplace_back(new char[TOKEN_BLOCK_SIZE]);
+            blockUsed = 0;
+        }
+
+        char* space = blocks.back().get() + blockUsed;
+
+        blockUsed += length;
+        return space;
+    }
+}
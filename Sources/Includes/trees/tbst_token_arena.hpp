@@ -0,0 +1,49 @@
+/**
+ * @author Daniel Sebastian Iliescu
+ */
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dsa
+{
+    /**
+     * TokenArena
+     *
+     * Class interning the tokens of a Threaded Binary Search Tree.
+     * Each distinct token is copied once into large contiguous blocks and
+     * is never moved afterwards, so nodes can refer to it through a plain
+     * pointer. Equal tokens are interned at the same address.
+     * Every tree owns an arena (held by its node pool), which is freed when
+     * the tree is cleared or destroyed. Like the tree, it is not thread-safe.
+     */
+    class TokenArena
+    {
+    public:
+        TokenArena();
+        ~TokenArena();
+
+        TokenArena(const TokenArena&) = delete;
+        TokenArena& operator=(const TokenArena&) = delete;
+
+        // Properties
+        size_t getTokensCount() const;
+
+        // Operations
+        const char* intern(std::string_view token);
+        void clear();
+        void swap(TokenArena& other);
+
+    private:
+        // Helper methods
+        char* allocate(size_t length);
+
+        std::vector<std::unique_ptr<char[]>> blocks;            // token storage
+        size_t blockUsed;                                       // bytes used in last block
+        std::unordered_map<std::string_view, const char*> index; // interned tokens
+    };
+}
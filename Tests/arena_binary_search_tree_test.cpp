@@ -0,0 +1,196 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the arena-backed Binary Search Tree.
+ */
+
+#include "trees/arena_binary_search_tree.hpp"
+
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <type_traits>
+
+namespace
+{
+	const std::string UNIT_NAME = "arena_binary_search_tree_";
+
+	using key_type = std::int32_t;
+	using value_type = std::int32_t;
+	constexpr std::size_t ITERATIONS = 10000;
+}
+
+namespace dsa
+{
+	static_assert(
+		sizeof( arena_binary_search_tree_node< key_type, value_type > ) == 4 * sizeof( std::uint32_t ),
+		"Index links should not add padding to small nodes." );
+
+	static_assert(
+		std::is_trivially_copyable< arena_binary_search_tree_node< key_type, value_type > >::value,
+		"Nodes of trivially copyable types should be copied as raw memory." );
+
+	TEST_CASE( ( UNIT_NAME + "empty" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+
+		REQUIRE( bst.empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "insert" ).c_str() )
+	{
+		std::vector< key_type > keys;
+		generator< value_type >().fill_buffer_n( std::back_inserter( keys ), ITERATIONS );
+
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : keys )
+		{
+			bst.insert( key, static_cast< value_type >( key ) );
+		}
+
+		std::sort( std::begin( keys ), std::end( keys ) );
+		keys.erase( std::unique( std::begin( keys ), std::end( keys ) ), std::end( keys ) );
+
+		std::vector< key_type > extracted_keys;
+		bst.inorder([&extracted_keys]( auto const & node )
+		{
+			extracted_keys.emplace_back( node.key );
+		} );
+
+		REQUIRE(
+			std::equal(
+				std::cbegin( keys ),
+				std::cend( keys ),
+				std::cbegin( extracted_keys ),
+				std::cend( extracted_keys ) ) );
+		REQUIRE( bst.size() == bst.calculated_size() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "erase_all_children_cases" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : { 0, -2, -1, -3, 4, 3, 7, 6, 8 } )
+		{
+			bst.insert( key, value_type() );
+		}
+
+		bst.erase( 5 );
+		REQUIRE( bst.size() == 9 );
+
+		bst.erase( -1 );
+		REQUIRE( !bst.contains( -1 ) );
+
+		bst.erase( -2 );
+		REQUIRE( !bst.contains( -2 ) );
+		REQUIRE( bst.contains( -3 ) );
+
+		bst.erase( 4 );
+		REQUIRE( !bst.contains( 4 ) );
+		REQUIRE( bst.contains( 3 ) );
+		REQUIRE( bst.contains( 7 ) );
+
+		bst.erase( 0 );
+		REQUIRE( !bst.contains( 0 ) );
+		REQUIRE( bst.size() == 5 );
+		REQUIRE( bst.size() == bst.calculated_size() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "erase_reuses_storage" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( key_type key = 0; key < 64; ++key )
+		{
+			bst.insert( key, key );
+		}
+
+		const auto capacity = bst.storage().size();
+
+		for ( key_type key = 0; key < 64; key += 2 )
+		{
+			bst.erase( key );
+		}
+
+		for ( key_type key = 100; key < 132; ++key )
+		{
+			bst.insert( key, key );
+		}
+
+		REQUIRE( bst.storage().size() == capacity );
+		REQUIRE( bst.size() == 64 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "copy" ).c_str() )
+	{
+		std::vector< key_type > keys;
+		generator< value_type >().fill_buffer_n( std::back_inserter( keys ), ITERATIONS );
+
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : keys )
+		{
+			bst.insert( key, static_cast< value_type >( key ) );
+		}
+
+		const auto bst_copy( bst );
+
+		REQUIRE( bst == bst_copy );
+
+		bst.erase( keys.front() );
+
+		REQUIRE( bst != bst_copy );
+		REQUIRE( bst_copy.contains( keys.front() ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "degenerate_depth" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( key_type key = 0; key < static_cast< key_type >( ITERATIONS ); ++key )
+		{
+			bst.insert( key, key );
+		}
+
+		REQUIRE( bst.height() == ITERATIONS - 1 );
+		REQUIRE( !bst.balanced() );
+
+		bst.clear();
+
+		REQUIRE( bst.empty() );
+		REQUIRE( !bst.contains( 0 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "height_balanced" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : { 0, -3, -2, 4, 3, 7, 8 } )
+		{
+			bst.insert( key, value_type() );
+		}
+
+		REQUIRE( bst.height() == 3 );
+		REQUIRE( bst.balanced() );
+
+		bst.insert( 9, value_type() );
+		bst.insert( -1, value_type() );
+
+		REQUIRE( !bst.balanced() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "traversal_orders" ).c_str() )
+	{
+		arena_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : { 4, 2, 6, 1, 3, 5, 7 } )
+		{
+			bst.insert( key, value_type() );
+		}
+
+		std::vector< key_type > preorder;
+		std::vector< key_type > postorder;
+
+		bst.preorder( [&preorder]( auto const & node ) { preorder.push_back( node.key ); } );
+		bst.postorder( [&postorder]( auto const & node ) { postorder.push_back( node.key ); } );
+
+		REQUIRE( preorder == std::vector< key_type >( { 4, 2, 1, 3, 6, 5, 7 } ) );
+		REQUIRE( postorder == std::vector< key_type >( { 1, 3, 2, 5, 7, 6, 4 } ) );
+	}
+}
@@ -0,0 +1,158 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the direction-optimizing breadth-first search.
+ */
+
+#include "graphs/breadth_first_search.hpp"
+#include "graphs/csr_graph.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "breadth_first_search_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using tree_type = dsa::breadth_first_tree< vertex_type >;
+
+	constexpr unsigned SCALE = 12;
+	constexpr std::size_t EDGE_FACTOR = 16;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t THREADS = 4;
+
+	std::vector< vertex_type >
+	serial_distances(
+		const graph_type& graph,
+		const vertex_type source )
+	{
+		std::vector< vertex_type > distances( graph.vertex_count(), tree_type::unreached );
+		std::deque< vertex_type > queue { source };
+
+		distances[ source ] = 0;
+
+		while ( !queue.empty() )
+		{
+			const auto vertex = queue.front();
+			queue.pop_front();
+
+			for ( const auto target : graph.neighbors( vertex ) )
+			{
+				if ( distances[ target ] == tree_type::unreached )
+				{
+					distances[ target ] = distances[ vertex ] + 1;
+					queue.push_back( target );
+				}
+			}
+		}
+
+		return distances;
+	}
+
+	/**
+	 * Counts the vertices whose distance or parent is inconsistent with the reference distances.
+	 */
+	std::size_t
+	count_errors(
+		const graph_type& graph,
+		const vertex_type source,
+		const tree_type& tree,
+		const std::vector< vertex_type >& expected )
+	{
+		std::size_t errors = 0;
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			if ( tree.distances[ vertex ] != expected[ vertex ] )
+			{
+				++errors;
+			}
+			else if ( expected[ vertex ] == tree_type::unreached )
+			{
+				errors += ( tree.parents[ vertex ] != tree_type::unreached );
+			}
+			else if ( vertex == source )
+			{
+				errors += ( tree.parents[ vertex ] != source );
+			}
+			else
+			{
+				const auto parent = tree.parents[ vertex ];
+				const auto neighbors = graph.neighbors( parent );
+
+				errors += ( expected[ parent ] + 1 != expected[ vertex ] ) ||
+					( std::find( neighbors.begin(), neighbors.end(), vertex ) == neighbors.end() );
+			}
+		}
+
+		return errors;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "single_vertex" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+		const graph_type graph( 1, {}, false );
+
+		const auto tree = breadth_first_search( graph, graph, 0, pool );
+
+		REQUIRE( tree.parents == std::vector< vertex_type > { 0 } );
+		REQUIRE( tree.distances == std::vector< vertex_type > { 0 } );
+		REQUIRE_THROWS_AS( breadth_first_search( graph, graph, 1, pool ), const std::out_of_range& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "directions_agree" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		for ( const bool undirected : { false, true } )
+		{
+			const auto graph = rmat_graph( SCALE, EDGE_FACTOR, undirected );
+			const auto transposed = graph.transpose();
+
+			for ( const vertex_type source : { vertex_type { 0 }, vertex_type { 1 }, vertex_type { 1000 } } )
+			{
+				const auto expected = serial_distances( graph, source );
+
+				// Top-down only, bottom-up once switched, then the default heuristic.
+				REQUIRE( count_errors( graph, source, breadth_first_search( graph, transposed, source, pool, 0, 18 ), expected ) == 0 );
+				REQUIRE( count_errors( graph, source, breadth_first_search( graph, transposed, source, pool, 1000000, 0 ), expected ) == 0 );
+				REQUIRE( count_errors( graph, source, breadth_first_search( graph, transposed, source, pool ), expected ) == 0 );
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		const auto graph = rmat_graph( BENCHMARK_SCALE, EDGE_FACTOR, true );
+
+		const auto measure = [&]( const std::size_t alpha )
+		{
+			const auto [ tree, milliseconds ] = timed( [&]
+			{
+				return breadth_first_search( graph, graph, 0, pool, alpha );
+			} );
+
+			REQUIRE( tree.distances[ 0 ] == 0 );
+
+			return milliseconds;
+		};
+
+		WARN( "R-MAT scale " << BENCHMARK_SCALE << ", " << graph.edge_count() << " edges, " << pool.size() << " threads" );
+		WARN( "top-down: " << measure( 0 ) << " ms" );
+		WARN( "direction-optimizing: " << measure( 15 ) << " ms" );
+	}
+}
@@ -0,0 +1,371 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the concurrent Skip List.
+ */
+
+#include "trees/concurrent_skip_list.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace
+{
+	const std::string UNIT_NAME = "concurrent_skip_list_";
+
+	using key_type = std::int32_t;
+	using value_type = std::int32_t;
+	constexpr std::size_t ITERATIONS = 10000;
+	constexpr std::size_t THREADS = 4;
+	constexpr std::size_t RETIRED_BOUND = 1024;
+	constexpr key_type BENCHMARK_KEYS = 1 << 17;
+	constexpr std::size_t BENCHMARK_OPERATIONS = 1 << 22;
+	constexpr std::size_t BENCHMARK_THREADS = 64;
+	constexpr key_type BENCHMARK_SPAN = 64;
+
+	template < typename Function >
+	void
+	run_threads(
+		Function&& function,
+		const std::size_t count = THREADS )
+	{
+		std::vector< std::thread > threads;
+
+		for ( std::size_t thread = 0; thread < count; ++thread )
+		{
+			threads.emplace_back( function, thread );
+		}
+
+		for ( auto& thread : threads )
+		{
+			thread.join();
+		}
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "empty" ).c_str() )
+	{
+		concurrent_skip_list< key_type, value_type > list;
+
+		REQUIRE( list.empty() );
+		REQUIRE( !list.contains( 0 ) );
+		REQUIRE( !list.erase( 0 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "sequential_operations" ).c_str() )
+	{
+		generator< value_type > generator;
+
+		std::set< key_type > reference;
+		concurrent_skip_list< key_type, value_type > list;
+
+		for ( std::size_t iteration = 0; iteration < ITERATIONS; ++iteration )
+		{
+			const auto key = generator() % 512;
+
+			if ( generator() % 2 )
+			{
+				REQUIRE( list.insert( key, key ) == reference.insert( key ).second );
+			}
+			else
+			{
+				REQUIRE( list.erase( key ) == ( reference.erase( key ) == 1 ) );
+			}
+		}
+
+		std::vector< key_type > extracted_keys;
+		list.range( 0, 512, [&extracted_keys]( const key_type& key, const value_type& value )
+		{
+			REQUIRE( key == value );
+			extracted_keys.push_back( key );
+		} );
+
+		REQUIRE( std::equal(
+			std::cbegin( reference ),
+			std::cend( reference ),
+			std::cbegin( extracted_keys ),
+			std::cend( extracted_keys ) ) );
+		REQUIRE( list.size() == reference.size() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "concurrent_insert" ).c_str() )
+	{
+		concurrent_skip_list< key_type, value_type > list;
+
+		// Every thread inserts every key; exactly one insertion of each key must succeed.
+		std::atomic< std::size_t > inserted { 0 };
+
+		run_threads( [&list, &inserted]( const std::size_t thread )
+		{
+			for ( std::size_t iteration = 0; iteration < ITERATIONS; ++iteration )
+			{
+				const auto key = static_cast< key_type >( ( iteration * ( thread + 1 ) ) % ITERATIONS );
+
+				if ( list.insert( key, key ) )
+				{
+					++inserted;
+				}
+			}
+		} );
+
+		REQUIRE( inserted == list.size() );
+
+		for ( key_type key = 0; key < static_cast< key_type >( ITERATIONS ); ++key )
+		{
+			REQUIRE( list.contains( key ) );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "concurrent_insert_erase" ).c_str() )
+	{
+		concurrent_skip_list< key_type, value_type > list;
+
+		std::atomic< std::size_t > failures { 0 };
+
+		// Each thread owns the keys congruent to its index and toggles them repeatedly.
+		run_threads( [&list, &failures]( const std::size_t thread )
+		{
+			for ( std::size_t round = 0; round < 4; ++round )
+			{
+				for ( auto key = static_cast< key_type >( thread ); key < 2048; key += THREADS )
+				{
+					failures += !list.insert( key, key );
+				}
+
+				for ( auto key = static_cast< key_type >( thread ); key < 2048; key += 2 * THREADS )
+				{
+					failures += !list.erase( key );
+				}
+
+				if ( round + 1 < 4 )
+				{
+					for ( auto key = static_cast< key_type >( thread + THREADS ); key < 2048; key += 2 * THREADS )
+					{
+						failures += !list.erase( key );
+					}
+				}
+			}
+		} );
+
+		REQUIRE( failures == 0 );
+		REQUIRE( list.size() == 1024 );
+
+		for ( key_type key = 0; key < 2048; ++key )
+		{
+			REQUIRE( list.contains( key ) == ( ( key % ( 2 * THREADS ) ) >= static_cast< key_type >( THREADS ) ) );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "range_is_a_snapshot" ).c_str() )
+	{
+		concurrent_skip_list< key_type, value_type > list;
+		std::atomic< bool > done { false };
+
+		// The writer keeps the key set contiguous at every instant, so a scan that
+		// is not a single snapshot could observe a gap.
+		std::thread writer( [&list, &done]()
+		{
+			for ( key_type key = 0; key < static_cast< key_type >( ITERATIONS ); ++key )
+			{
+				list.insert( key, key );
+
+				if ( key >= 64 )
+				{
+					list.erase( key - 64 );
+				}
+			}
+
+			done = true;
+		} );
+
+		bool contiguous = true;
+
+		while ( !done )
+		{
+			std::vector< key_type > keys;
+
+			list.range( 0, static_cast< key_type >( ITERATIONS ), [&keys]( const key_type& key, const value_type& )
+			{
+				keys.push_back( key );
+			} );
+
+			for ( std::size_t index = 1; index < keys.size(); ++index )
+			{
+				contiguous = contiguous && ( keys[ index ] == keys[ index - 1 ] + 1 );
+			}
+
+			contiguous = contiguous && ( keys.size() <= 65 );
+		}
+
+		writer.join();
+
+		REQUIRE( contiguous );
+		REQUIRE( list.size() == 64 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "erased_nodes_are_reclaimed" ).c_str() )
+	{
+		concurrent_skip_list< key_type, value_type > list;
+
+		for ( std::size_t iteration = 0; iteration < 10 * ITERATIONS; ++iteration )
+		{
+			const auto key = static_cast< key_type >( iteration % 256 );
+
+			list.insert( key, key );
+			list.erase( key );
+		}
+
+		REQUIRE( list.empty() );
+		REQUIRE( list.retired_size() < RETIRED_BOUND );
+
+		// Readers keep traversing while writers churn through the same keys.
+		run_threads( [&list]( const std::size_t thread )
+		{
+			for ( std::size_t iteration = 0; iteration < ITERATIONS; ++iteration )
+			{
+				const auto key = static_cast< key_type >( iteration % 512 );
+
+				if ( thread % 2 )
+				{
+					list.contains( key );
+				}
+				else if ( list.insert( key, key ) )
+				{
+					list.erase( key );
+				}
+			}
+		} );
+
+		REQUIRE( list.retired_size() < RETIRED_BOUND );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		// 85% lookups, 5% inserts, 5% erases and 5% range scans over a half-full key space.
+		const auto measure = [&]( auto& map, const std::size_t threads )
+		{
+			for ( key_type key = 0; key < BENCHMARK_KEYS; key += 2 )
+			{
+				map.insert( key, key );
+			}
+
+			const auto run = timed( [&map, threads]
+			{
+				std::atomic< std::size_t > scanned { 0 };
+
+				run_threads( [&map, &scanned, threads]( const std::size_t thread )
+				{
+					auto state = static_cast< std::uint32_t >( 2654435761u * ( thread + 1 ) );
+
+					for ( std::size_t operation = 0; operation < BENCHMARK_OPERATIONS / threads; ++operation )
+					{
+						state ^= state << 13;
+						state ^= state >> 17;
+						state ^= state << 5;
+
+						const auto key = static_cast< key_type >( state % BENCHMARK_KEYS );
+						const auto choice = ( state >> 24 ) % 20;
+
+						if ( choice == 0 )
+						{
+							map.insert( key, key );
+						}
+						else if ( choice == 1 )
+						{
+							map.erase( key );
+						}
+						else if ( choice == 2 )
+						{
+							std::size_t items = 0;
+
+							map.range( key, key + BENCHMARK_SPAN, [&items]( const key_type&, const value_type& )
+							{
+								++items;
+							} );
+
+							scanned.fetch_add( items, std::memory_order_relaxed );
+						}
+						else
+						{
+							map.contains( key );
+						}
+					}
+				}, threads );
+
+				return scanned.load();
+			} );
+
+			return BENCHMARK_OPERATIONS / run.second / 1e3;
+		};
+
+		// The same operations on a std::set behind a single mutex.
+		struct locked_set
+		{
+			void
+			insert(
+				const key_type key,
+				const value_type )
+			{
+				const std::lock_guard< std::mutex > guard( this->lock );
+				this->keys.insert( key );
+			}
+
+			void
+			erase( const key_type key )
+			{
+				const std::lock_guard< std::mutex > guard( this->lock );
+				this->keys.erase( key );
+			}
+
+			bool
+			contains( const key_type key )
+			{
+				const std::lock_guard< std::mutex > guard( this->lock );
+				return this->keys.count( key ) != 0;
+			}
+
+			void
+			range(
+				const key_type lower,
+				const key_type upper,
+				std::function< void( const key_type&, const value_type& ) >&& callback )
+			{
+				const std::lock_guard< std::mutex > guard( this->lock );
+
+				for ( auto key = this->keys.lower_bound( lower ); key != this->keys.end() && *key < upper; ++key )
+				{
+					callback( *key, *key );
+				}
+			}
+
+			std::mutex lock;
+			std::set< key_type > keys;
+		};
+
+		WARN( BENCHMARK_OPERATIONS << " operations over " << BENCHMARK_KEYS << " keys, "
+			<< std::thread::hardware_concurrency() << " hardware threads" );
+
+		for ( std::size_t threads = 1; threads <= BENCHMARK_THREADS; threads *= 2 )
+		{
+			concurrent_skip_list< key_type, value_type > list;
+			locked_set set;
+
+			const auto list_throughput = measure( list, threads );
+			const auto set_throughput = measure( set, threads );
+
+			WARN( threads << " threads: skip list " << list_throughput << " Mops/s, locked std::set "
+				<< set_throughput << " Mops/s" );
+		}
+	}
+}
@@ -0,0 +1,153 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the parallel connected components.
+ */
+
+#include "graphs/connected_components.hpp"
+#include "graphs/csr_graph.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "connected_components_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using edge_type = graph_type::edge;
+	using components_type = dsa::component_labels< vertex_type >;
+
+	constexpr unsigned SCALE = 14;
+	constexpr std::size_t EDGE_FACTOR = 2;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t BENCHMARK_EDGE_FACTOR = 16;
+	constexpr std::size_t THREADS = 4;
+
+	/**
+	 * Labels the components by breadth-first searches over the edges taken both ways.
+	 */
+	components_type
+	serial_components(
+		const graph_type& graph,
+		const graph_type& transposed )
+	{
+		constexpr auto unlabeled = std::numeric_limits< vertex_type >::max();
+
+		components_type components;
+		components.labels.assign( graph.vertex_count(), unlabeled );
+
+		for ( vertex_type root = 0; root < graph.vertex_count(); ++root )
+		{
+			if ( components.labels[ root ] != unlabeled )
+			{
+				continue;
+			}
+
+			std::deque< vertex_type > queue { root };
+			components.labels[ root ] = static_cast< vertex_type >( components.count );
+
+			while ( !queue.empty() )
+			{
+				const auto vertex = queue.front();
+				queue.pop_front();
+
+				for ( const auto* adjacency : { &graph, &transposed } )
+				{
+					for ( const auto target : adjacency->neighbors( vertex ) )
+					{
+						if ( components.labels[ target ] == unlabeled )
+						{
+							components.labels[ target ] = components.labels[ root ];
+							queue.push_back( target );
+						}
+					}
+				}
+			}
+
+			++components.count;
+		}
+
+		return components;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "small" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		const graph_type graph( 7, { { 5, 1, 1 }, { 1, 5, 1 }, { 3, 6, 1 }, { 6, 3, 1 }, { 2, 2, 1 } }, false );
+		const auto components = connected_components( graph, graph, pool );
+
+		REQUIRE( components.count == 5 );
+		REQUIRE( ( components.labels == std::vector< vertex_type > { 0, 1, 2, 3, 4, 1, 3 } ) );
+
+		const graph_type empty;
+
+		REQUIRE( connected_components( empty, empty, pool ).count == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "matches_search" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		for ( const bool undirected : { true, false } )
+		{
+			for ( const std::size_t edge_factor : { std::size_t { 1 }, EDGE_FACTOR, 4 * EDGE_FACTOR } )
+			{
+				const auto graph = rmat_graph( SCALE, edge_factor, undirected );
+				const auto transposed = graph.transpose();
+				const auto expected = serial_components( graph, transposed );
+
+				for ( const std::size_t rounds : { 0, 2, 8 } )
+				{
+					const auto components = undirected ?
+						connected_components( graph, graph, pool, rounds ) :
+						connected_components( graph, transposed, pool, rounds );
+
+					REQUIRE( components.count == expected.count );
+					REQUIRE( components.labels == expected.labels );
+				}
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		const auto graph = rmat_graph( BENCHMARK_SCALE, BENCHMARK_EDGE_FACTOR, true );
+
+		const auto measure = [&]( const auto& label )
+		{
+			const auto [ components, milliseconds ] = timed( label );
+
+			REQUIRE( components.count > 0 );
+
+			return milliseconds;
+		};
+
+		WARN( "R-MAT scale " << BENCHMARK_SCALE << ", " << graph.edge_count() << " edges, " << pool.size() << " threads" );
+		WARN( "breadth-first searches: " << measure( [&]
+		{
+			return serial_components( graph, graph );
+		} ) << " ms" );
+		WARN( "union-find, no sampling: " << measure( [&]
+		{
+			return connected_components( graph, graph, pool, 0 );
+		} ) << " ms" );
+		WARN( "afforest: " << measure( [&]
+		{
+			return connected_components( graph, graph, pool );
+		} ) << " ms" );
+	}
+}
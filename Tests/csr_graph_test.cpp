@@ -0,0 +1,175 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the CSR graph.
+ */
+
+#include "graphs/csr_graph.hpp"
+
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "csr_graph_";
+
+	using graph_type = dsa::csr_graph<>;
+	using edge_type = graph_type::edge;
+	constexpr std::size_t VERTICES = 500;
+	constexpr std::size_t EDGES = 10000;
+
+	std::vector< edge_type >
+	random_edges(
+		const std::size_t vertices,
+		const std::size_t edges )
+	{
+		generator< std::uint32_t > generator;
+		std::vector< edge_type > result;
+
+		for ( std::size_t edge = 0; edge < edges; ++edge )
+		{
+			result.push_back( {
+				generator() % static_cast< std::uint32_t >( vertices ),
+				generator() % static_cast< std::uint32_t >( vertices ),
+				static_cast< std::int32_t >( generator() % 1000 ) } );
+		}
+
+		return result;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "empty" ).c_str() )
+	{
+		graph_type empty;
+
+		REQUIRE( empty.empty() );
+		REQUIRE( empty.vertex_count() == 0 );
+		REQUIRE( empty.edge_count() == 0 );
+
+		graph_type isolated( 10, {} );
+
+		REQUIRE( isolated.vertex_count() == 10 );
+		REQUIRE( isolated.edge_count() == 0 );
+
+		for ( std::uint32_t vertex = 0; vertex < 10; ++vertex )
+		{
+			REQUIRE( isolated.neighbors( vertex ).empty() );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "build_keeps_edge_order" ).c_str() )
+	{
+		const auto edges = random_edges( VERTICES, EDGES );
+
+		std::vector< std::vector< std::pair< std::uint32_t, std::int32_t > > > reference( VERTICES );
+
+		for ( const auto& edge : edges )
+		{
+			reference[ edge.source ].emplace_back( edge.target, edge.weight );
+		}
+
+		const graph_type graph( VERTICES, edges );
+
+		REQUIRE( graph.vertex_count() == VERTICES );
+		REQUIRE( graph.edge_count() == EDGES );
+		REQUIRE( graph.weighted() );
+		REQUIRE( graph.offsets().back() == EDGES );
+
+		for ( std::uint32_t vertex = 0; vertex < VERTICES; ++vertex )
+		{
+			const auto neighbors = graph.neighbors( vertex );
+			const auto weights = graph.neighbor_weights( vertex );
+
+			REQUIRE( graph.degree( vertex ) == reference[ vertex ].size() );
+			REQUIRE( neighbors.size() == weights.size() );
+
+			for ( std::size_t index = 0; index < neighbors.size(); ++index )
+			{
+				REQUIRE( neighbors[ index ] == reference[ vertex ][ index ].first );
+				REQUIRE( weights[ index ] == reference[ vertex ][ index ].second );
+			}
+		}
+
+		const graph_type unweighted( VERTICES, edges, false );
+
+		REQUIRE( !unweighted.weighted() );
+		REQUIRE( unweighted.weights().empty() );
+		REQUIRE( unweighted.targets() == graph.targets() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "transpose" ).c_str() )
+	{
+		const auto edges = random_edges( VERTICES, EDGES );
+		const graph_type graph( VERTICES, edges );
+		const auto transposed = graph.transpose();
+
+		REQUIRE( transposed.vertex_count() == VERTICES );
+		REQUIRE( transposed.edge_count() == EDGES );
+
+		std::vector< std::vector< std::pair< std::uint32_t, std::int32_t > > > expected( VERTICES );
+		std::vector< std::vector< std::pair< std::uint32_t, std::int32_t > > > actual( VERTICES );
+
+		for ( const auto& edge : edges )
+		{
+			expected[ edge.target ].emplace_back( edge.source, edge.weight );
+		}
+
+		for ( std::uint32_t vertex = 0; vertex < VERTICES; ++vertex )
+		{
+			const auto neighbors = transposed.neighbors( vertex );
+			const auto weights = transposed.neighbor_weights( vertex );
+
+			// In-edges are listed by source.
+			REQUIRE( std::is_sorted( neighbors.begin(), neighbors.end() ) );
+
+			for ( std::size_t index = 0; index < neighbors.size(); ++index )
+			{
+				actual[ vertex ].emplace_back( neighbors[ index ], weights[ index ] );
+			}
+
+			std::sort( std::begin( expected[ vertex ] ), std::end( expected[ vertex ] ) );
+			std::sort( std::begin( actual[ vertex ] ), std::end( actual[ vertex ] ) );
+		}
+
+		REQUIRE( actual == expected );
+
+		const auto restored = transposed.transpose();
+
+		for ( std::uint32_t vertex = 0; vertex < VERTICES; ++vertex )
+		{
+			REQUIRE( restored.degree( vertex ) == graph.degree( vertex ) );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "adopt_arrays" ).c_str() )
+	{
+		const graph_type graph( { 0, 2, 2, 3 }, { 1, 2, 0 } );
+
+		REQUIRE( graph.vertex_count() == 3 );
+		REQUIRE( graph.edge_count() == 3 );
+		REQUIRE( !graph.weighted() );
+		REQUIRE( graph.degree( 0 ) == 2 );
+		REQUIRE( graph.degree( 1 ) == 0 );
+		REQUIRE( graph.neighbors( 2 )[ 0 ] == 0 );
+
+		REQUIRE_THROWS_AS( graph_type( { 0, 2, 1 }, { 0, 1 } ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( graph_type( { 0, 2 }, { 0, 1, 1 } ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( graph_type( { 0, 1 }, { 0 }, { 1, 2 } ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( graph_type( { 0, 1 }, { 1 } ), const std::out_of_range& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "invalid_edges" ).c_str() )
+	{
+		REQUIRE_THROWS_AS( graph_type( 2, { { 0, 2, 1 } } ), const std::out_of_range& );
+		REQUIRE_THROWS_AS( graph_type( 2, { { 2, 0, 1 } } ), const std::out_of_range& );
+		REQUIRE_THROWS_AS( ( csr_graph< std::uint8_t >( 300, {} ) ), const std::length_error& );
+	}
+}
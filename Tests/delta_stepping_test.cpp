@@ -0,0 +1,234 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the delta-stepping single-source shortest paths.
+ */
+
+#include "graphs/csr_graph.hpp"
+#include "graphs/delta_stepping.hpp"
+#include "graphs/graph_loader.hpp"
+#include "graphs/graphm.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/generator.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "delta_stepping_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using distance_type = std::int64_t;
+
+	constexpr auto UNREACHED = std::numeric_limits< distance_type >::max();
+
+	constexpr unsigned SCALE = 12;
+	constexpr std::size_t EDGE_FACTOR = 8;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t THREADS = 4;
+	constexpr int GRAPHM_NODES = 48;
+	constexpr std::uint32_t GRAPHM_SPARSITY = 8;
+	constexpr std::uint32_t GRAPHM_MAX_WEIGHT = 50;
+
+	std::vector< distance_type >
+	dijkstra(
+		const graph_type& graph,
+		const vertex_type source )
+	{
+		using entry = std::pair< distance_type, vertex_type >;
+
+		std::vector< distance_type > distances( graph.vertex_count(), UNREACHED );
+		std::priority_queue< entry, std::vector< entry >, std::greater< entry > > queue;
+
+		distances[ source ] = 0;
+		queue.push( { 0, source } );
+
+		while ( !queue.empty() )
+		{
+			const auto top = queue.top();
+			queue.pop();
+
+			if ( top.first != distances[ top.second ] )
+			{
+				continue;
+			}
+
+			const auto neighbors = graph.neighbors( top.second );
+
+			for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+			{
+				const auto weight = graph.weighted() ? graph.neighbor_weights( top.second )[ edge ] : 1;
+				const auto candidate = top.first + weight;
+
+				if ( candidate < distances[ neighbors[ edge ] ] )
+				{
+					distances[ neighbors[ edge ] ] = candidate;
+					queue.push( { candidate, neighbors[ edge ] } );
+				}
+			}
+		}
+
+		return distances;
+	}
+
+	/**
+	 * A random graph without loops nor parallel edges, as GraphM accepts them.
+	 */
+	dsa::loaded_graph
+	random_loaded_graph()
+	{
+		generator< std::uint32_t > generator;
+		dsa::loaded_graph graph;
+
+		graph.vertices = GRAPHM_NODES;
+
+		for ( std::uint32_t node = 0; node < GRAPHM_NODES; ++node )
+		{
+			for ( std::uint32_t target = 0; target < GRAPHM_NODES; ++target )
+			{
+				if ( target != node && generator() % GRAPHM_SPARSITY == 0 )
+				{
+					graph.edges.push_back( { node, target, static_cast< std::int32_t >( generator() % ( GRAPHM_MAX_WEIGHT + 1 ) ) } );
+				}
+			}
+		}
+
+		return graph;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "matches_dijkstra" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		for ( const std::int32_t max_weight : { 0, 1, 100, 100000 } )
+		{
+			const auto graph = rmat_graph( SCALE, EDGE_FACTOR, false, 0, max_weight );
+
+			for ( const vertex_type source : { vertex_type { 0 }, vertex_type { 7 }, vertex_type { 1000 } } )
+			{
+				const auto expected = dijkstra( graph, source );
+
+				for ( const distance_type delta : { 0, 1, 10, 1000, 1000000000 } )
+				{
+					REQUIRE( delta_stepping( graph, source, pool, delta ) == expected );
+				}
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "matches_graphm" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		const auto loaded = random_loaded_graph();
+		const graph_type graph( loaded.vertices, loaded.edges );
+		std::map< std::pair< int, int >, distance_type > costs;
+		GraphM matrix;
+
+		REQUIRE( matrix.buildGraph( loaded ) );
+
+		for ( const auto& edge : loaded.edges )
+		{
+			costs[ { static_cast< int >( edge.source ) + 1, static_cast< int >( edge.target ) + 1 } ] = edge.weight;
+		}
+
+		// GraphM numbers its nodes from 1 and finds no path from a node to itself.
+		for ( vertex_type source = 0; source < GRAPHM_NODES; ++source )
+		{
+			for ( const distance_type delta : { 0, 1, 20 } )
+			{
+				const auto distances = delta_stepping( graph, source, pool, delta );
+
+				for ( vertex_type target = 0; target < GRAPHM_NODES; ++target )
+				{
+					const auto path = matrix.findPath( static_cast< int >( source ) + 1, static_cast< int >( target ) + 1 );
+
+					if ( source == target || distances[ target ] == UNREACHED )
+					{
+						REQUIRE( path.empty() );
+						continue;
+					}
+
+					distance_type cost = 0;
+
+					for ( std::size_t node = 1; node < path.size(); ++node )
+					{
+						cost += costs.at( { path[ node - 1 ], path[ node ] } );
+					}
+
+					REQUIRE( path.front() == static_cast< int >( source ) + 1 );
+					REQUIRE( path.back() == static_cast< int >( target ) + 1 );
+					REQUIRE( cost == distances[ target ] );
+				}
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "unweighted" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		const graph_type path( 5, { { 0, 1, 9 }, { 1, 2, 9 }, { 2, 3, 9 }, { 0, 2, 9 } }, false );
+
+		REQUIRE( ( delta_stepping( path, 0, pool ) == std::vector< distance_type > { 0, 1, 1, 2, UNREACHED } ) );
+		REQUIRE( ( delta_stepping< std::int32_t >( path, 3, pool ) == std::vector< std::int32_t > { 2147483647, 2147483647, 2147483647, 0, 2147483647 } ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "invalid_arguments" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		const graph_type graph( 3, { { 0, 1, 4 }, { 1, 2, -1 } } );
+
+		REQUIRE_THROWS_AS( delta_stepping( graph, 0, pool ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( delta_stepping( graph, 3, pool ), const std::out_of_range& );
+		REQUIRE_THROWS_AS( delta_stepping( graph_type( 2, {} ), 0, pool, distance_type { -1 } ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		const auto graph = rmat_graph( BENCHMARK_SCALE, EDGE_FACTOR, false, 0, 1000 );
+
+		const auto measure = [&]( const auto& search )
+		{
+			const auto [ distances, milliseconds ] = timed( search );
+
+			REQUIRE( distances[ 0 ] == 0 );
+
+			return milliseconds;
+		};
+
+		WARN( "R-MAT scale " << BENCHMARK_SCALE << ", " << graph.edge_count() << " edges, " << pool.size() << " threads" );
+		WARN( "dijkstra: " << measure( [&]
+		{
+			return dijkstra( graph, 0 );
+		} ) << " ms" );
+		WARN( "delta-stepping (default delta): " << measure( [&]
+		{
+			return delta_stepping( graph, 0, pool );
+		} ) << " ms" );
+
+		for ( const distance_type delta : { 1, 10, 100, 1000 } )
+		{
+			WARN( "delta-stepping (delta " << delta << "): " << measure( [&]
+			{
+				return delta_stepping( graph, 0, pool, delta );
+			} ) << " ms" );
+		}
+	}
+}
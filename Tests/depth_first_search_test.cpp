@@ -0,0 +1,260 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the iterative depth-first search and its algorithms.
+ */
+
+#include "graphs/csr_graph.hpp"
+#include "graphs/depth_first_search.hpp"
+
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "depth_first_search_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	constexpr std::size_t VERTICES = 200;
+	constexpr std::size_t PATH_LENGTH = 1000000;
+
+	graph_type
+	random_graph(
+		const std::size_t vertices,
+		const std::size_t edges,
+		const bool acyclic )
+	{
+		generator< std::uint32_t > generator;
+		std::vector< graph_type::edge > list;
+
+		for ( std::size_t edge = 0; edge < edges; ++edge )
+		{
+			auto source = generator() % static_cast< vertex_type >( vertices );
+			auto target = generator() % static_cast< vertex_type >( vertices );
+
+			if ( acyclic && source == target )
+			{
+				continue;
+			}
+
+			if ( acyclic && source > target )
+			{
+				std::swap( source, target );
+			}
+
+			list.push_back( { source, target, 1 } );
+		}
+
+		return graph_type( vertices, list, false );
+	}
+
+	void
+	recursive_search(
+		const graph_type& graph,
+		const vertex_type vertex,
+		std::vector< bool >& visited,
+		std::vector< vertex_type >& pre_order,
+		std::vector< vertex_type >& post_order )
+	{
+		visited[ vertex ] = true;
+		pre_order.push_back( vertex );
+
+		for ( const auto target : graph.neighbors( vertex ) )
+		{
+			if ( !visited[ target ] )
+			{
+				recursive_search( graph, target, visited, pre_order, post_order );
+			}
+		}
+
+		post_order.push_back( vertex );
+	}
+
+	std::vector< std::vector< bool > >
+	reachability( const graph_type& graph )
+	{
+		std::vector< std::vector< bool > > reachable( graph.vertex_count(), std::vector< bool >( graph.vertex_count(), false ) );
+
+		for ( vertex_type source = 0; source < graph.vertex_count(); ++source )
+		{
+			std::vector< vertex_type > pending { source };
+			reachable[ source ][ source ] = true;
+
+			while ( !pending.empty() )
+			{
+				const auto vertex = pending.back();
+				pending.pop_back();
+
+				for ( const auto target : graph.neighbors( vertex ) )
+				{
+					if ( !reachable[ source ][ target ] )
+					{
+						reachable[ source ][ target ] = true;
+						pending.push_back( target );
+					}
+				}
+			}
+		}
+
+		return reachable;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "matches_recursive_order" ).c_str() )
+	{
+		for ( const std::size_t edges : { std::size_t { 0 }, VERTICES / 2, VERTICES * 4 } )
+		{
+			const auto graph = random_graph( VERTICES, edges, false );
+
+			std::vector< bool > visited( VERTICES, false );
+			std::vector< vertex_type > expected_pre;
+			std::vector< vertex_type > expected_post;
+
+			for ( vertex_type root = 0; root < VERTICES; ++root )
+			{
+				if ( !visited[ root ] )
+				{
+					recursive_search( graph, root, visited, expected_pre, expected_post );
+				}
+			}
+
+			std::vector< vertex_type > pre_order;
+			std::vector< vertex_type > post_order;
+
+			depth_first_search< graph_type > search( graph );
+			search.visit_all(
+				[&pre_order]( const vertex_type vertex )
+				{
+					pre_order.push_back( vertex );
+				},
+				[&post_order]( const vertex_type vertex )
+				{
+					post_order.push_back( vertex );
+				} );
+
+			REQUIRE( pre_order == expected_pre );
+			REQUIRE( post_order == expected_post );
+
+			for ( vertex_type vertex = 0; vertex < VERTICES; ++vertex )
+			{
+				REQUIRE( search.visited( vertex ) );
+			}
+
+			search.reset();
+			REQUIRE( !search.visited( 0 ) );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "long_path" ).c_str() )
+	{
+		std::vector< graph_type::edge > edges;
+
+		for ( vertex_type vertex = 0; vertex + 1 < PATH_LENGTH; ++vertex )
+		{
+			edges.push_back( { vertex, vertex + 1, 1 } );
+		}
+
+		const graph_type graph( PATH_LENGTH, edges, false );
+
+		std::size_t discovered = 0;
+		vertex_type last_finished = 0;
+
+		depth_first_search< graph_type > search( graph );
+		search.visit(
+			0,
+			[&discovered]( const vertex_type )
+			{
+				++discovered;
+			},
+			[&last_finished]( const vertex_type vertex )
+			{
+				last_finished = vertex;
+			} );
+
+		REQUIRE( discovered == PATH_LENGTH );
+		REQUIRE( last_finished == 0 );
+
+		std::vector< vertex_type > order;
+		REQUIRE( topological_sort( graph, order ) );
+		REQUIRE( order.front() == 0 );
+		REQUIRE( order.back() == PATH_LENGTH - 1 );
+
+		REQUIRE( strongly_connected_components( graph ).count == PATH_LENGTH );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "topological_sort" ).c_str() )
+	{
+		const auto graph = random_graph( VERTICES, VERTICES * 4, true );
+
+		std::vector< vertex_type > order;
+		REQUIRE( topological_sort( graph, order ) );
+		REQUIRE( order.size() == VERTICES );
+
+		std::vector< std::size_t > position( VERTICES );
+
+		for ( std::size_t index = 0; index < order.size(); ++index )
+		{
+			position[ order[ index ] ] = index;
+		}
+
+		for ( vertex_type source = 0; source < VERTICES; ++source )
+		{
+			for ( const auto target : graph.neighbors( source ) )
+			{
+				REQUIRE( position[ source ] < position[ target ] );
+			}
+		}
+
+		const graph_type cycle( 3, { { 0, 1, 1 }, { 1, 2, 1 }, { 2, 0, 1 } }, false );
+		REQUIRE( !topological_sort( cycle, order ) );
+
+		const graph_type loop( 2, { { 0, 1, 1 }, { 1, 1, 1 } }, false );
+		REQUIRE( !topological_sort( loop, order ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "strongly_connected_components" ).c_str() )
+	{
+		for ( const std::size_t edges : { std::size_t { 0 }, VERTICES, VERTICES * 2, VERTICES * 8 } )
+		{
+			const auto graph = random_graph( VERTICES, edges, false );
+			const auto reachable = reachability( graph );
+			const auto components = strongly_connected_components( graph );
+
+			REQUIRE( components.labels.size() == VERTICES );
+
+			std::vector< bool > labels_used( components.count, false );
+			std::size_t mismatches = 0;
+
+			for ( vertex_type source = 0; source < VERTICES; ++source )
+			{
+				labels_used[ components.labels[ source ] ] = true;
+
+				for ( vertex_type target = 0; target < VERTICES; ++target )
+				{
+					const bool same = reachable[ source ][ target ] && reachable[ target ][ source ];
+					mismatches += ( same != ( components.labels[ source ] == components.labels[ target ] ) );
+				}
+
+				// Edges between components go from higher to lower labels.
+				for ( const auto target : graph.neighbors( source ) )
+				{
+					REQUIRE( components.labels[ source ] >= components.labels[ target ] );
+				}
+			}
+
+			REQUIRE( mismatches == 0 );
+			REQUIRE( std::all_of( std::begin( labels_used ), std::end( labels_used ), []( const bool used )
+			{
+				return used;
+			} ) );
+		}
+	}
+}
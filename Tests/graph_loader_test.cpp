@@ -0,0 +1,304 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the text and binary graph loaders.
+ */
+
+#include "graphs/graph_loader.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/rmat_generator.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "graph_loader_";
+	const std::string TEXT_FILE = "graph_loader_test.txt";
+	const std::string BINARY_FILE = "graph_loader_test.bin";
+
+	using edge_type = dsa::loaded_graph::edge;
+
+	constexpr std::size_t THREADS = 4;
+	constexpr unsigned SCALE = 14;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t EDGE_FACTOR = 16;
+
+	const std::string TWO_GRAPHS =
+		"3\n"
+		"first\n"
+		"second\n"
+		"third\n"
+		"1 2 10\n"
+		"\n"
+		"2 3 -4 trailing text\n"
+		"3 1 7\r\n"
+		"0 0 0\n"
+		"0\n"
+		"2\n"
+		"alpha\n"
+		"beta\n"
+		"  2 1 5\n"
+		"0 0 0\n";
+
+	bool
+	same_edges(
+		const std::vector< edge_type >& lhs,
+		const std::vector< edge_type >& rhs )
+	{
+		return std::equal( std::begin( lhs ), std::end( lhs ), std::begin( rhs ), std::end( rhs ), []( const edge_type& left, const edge_type& right )
+		{
+			return left.source == right.source && left.target == right.target && left.weight == right.weight;
+		} );
+	}
+
+	/**
+	 * Writes an R-MAT graph (without self-loops) in the text format.
+	 */
+	std::string
+	rmat_text(
+		const unsigned scale,
+		std::vector< edge_type >& edges )
+	{
+		rmat_generator generator( scale );
+		std::string text = std::to_string( generator.vertices() ) + "\n";
+
+		for ( std::uint32_t vertex = 0; vertex < generator.vertices(); ++vertex )
+		{
+			text += "vertex " + std::to_string( vertex ) + "\n";
+		}
+
+		for ( std::size_t edge = 0; edge < EDGE_FACTOR * generator.vertices(); ++edge )
+		{
+			const auto endpoints = generator();
+			const auto weight = static_cast< std::int32_t >( edge % 1000 );
+
+			if ( endpoints.first != endpoints.second )
+			{
+				edges.push_back( { endpoints.first, endpoints.second, weight } );
+				text += std::to_string( endpoints.first + 1 ) + ' ' + std::to_string( endpoints.second + 1 ) + ' ' + std::to_string( weight ) + '\n';
+			}
+		}
+
+		return text + "0 0 0\n";
+	}
+
+	void
+	write_file(
+		const std::string& path,
+		const std::string& text )
+	{
+		std::ofstream output( path, std::ios::out | std::ios::binary | std::ios::trunc );
+		output << text;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "parse_text" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+		const char* const last = TWO_GRAPHS.data() + TWO_GRAPHS.size();
+
+		loaded_graph graph;
+		auto position = parse_text_graph( TWO_GRAPHS.data(), last, 3, pool, graph );
+
+		REQUIRE( graph.vertices == 3 );
+		REQUIRE( ( graph.descriptions == std::vector< std::string > { "first", "second", "third" } ) );
+		REQUIRE( ( same_edges( graph.edges, { { 0, 1, 10 }, { 1, 2, -4 }, { 2, 0, 7 } } ) ) );
+
+		// The count of 0 is skipped.
+		position = parse_text_graph( position, last, 3, pool, graph );
+
+		REQUIRE( graph.vertices == 2 );
+		REQUIRE( ( graph.descriptions == std::vector< std::string > { "alpha", "beta" } ) );
+		REQUIRE( ( same_edges( graph.edges, { { 1, 0, 5 } } ) ) );
+		REQUIRE( position == last );
+
+		parse_text_graph( position, last, 3, pool, graph );
+		REQUIRE( graph.vertices == 0 );
+
+		// Without labels, and without a terminating line.
+		const std::string unlabeled = "2\na\nb\n1 2\n2 1";
+		parse_text_graph( unlabeled.data(), unlabeled.data() + unlabeled.size(), 2, pool, graph );
+
+		REQUIRE( ( same_edges( graph.edges, { { 0, 1, 0 }, { 1, 0, 0 } } ) ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "read_stream" ).c_str() )
+	{
+		std::istringstream input( TWO_GRAPHS );
+		loaded_graph graph;
+
+		REQUIRE( read_text_graph( input, 3, graph ) );
+		REQUIRE( graph.descriptions.size() == 3 );
+		REQUIRE( ( same_edges( graph.edges, { { 0, 1, 10 }, { 1, 2, -4 }, { 2, 0, 7 } } ) ) );
+
+		REQUIRE( read_text_graph( input, 3, graph ) );
+		REQUIRE( ( graph.descriptions == std::vector< std::string > { "alpha", "beta" } ) );
+		REQUIRE( ( same_edges( graph.edges, { { 1, 0, 5 } } ) ) );
+
+		REQUIRE( !read_text_graph( input, 3, graph ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "malformed_text" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		const auto parse = [&pool]( const std::string& text, const bool streamed )
+		{
+			loaded_graph graph;
+
+			if ( streamed )
+			{
+				std::istringstream input( text );
+				read_text_graph( input, 3, graph );
+			}
+			else
+			{
+				parse_text_graph( text.data(), text.data() + text.size(), 3, pool, graph );
+			}
+		};
+
+		for ( const bool streamed : { false, true } )
+		{
+			REQUIRE_THROWS_AS( parse( "-1\n", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "nodes\n", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "3\na\nb", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "2\na\nb\n1 x 3\n0 0 0\n", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "2\na\nb\n1 2\n0 0 0\n", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "2\na\nb\n1 2 99999999999\n0 0 0\n", streamed ), const std::invalid_argument& );
+			REQUIRE_THROWS_AS( parse( "2\na\nb\n1 3 1\n0 0 0\n", streamed ), const std::out_of_range& );
+			REQUIRE_THROWS_AS( parse( "2\na\nb\n-1 2 1\n0 0 0\n", streamed ), const std::out_of_range& );
+
+			// Errors past the end of the graph belong to the next one.
+			REQUIRE_NOTHROW( parse( "2\na\nb\n1 2 1\n0 0 0\n1 x\n", streamed ) );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "large_text" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+		std::vector< edge_type > expected;
+
+		// Several windows, followed by a second graph.
+		const auto text = rmat_text( SCALE, expected ) + TWO_GRAPHS;
+		write_file( TEXT_FILE, text );
+
+		const auto graphs = load_text_graphs( TEXT_FILE, 3, pool );
+		std::remove( TEXT_FILE.c_str() );
+
+		REQUIRE( graphs.size() == 3 );
+		REQUIRE( graphs[ 0 ].vertices == std::size_t { 1 } << SCALE );
+		REQUIRE( graphs[ 0 ].descriptions.back() == "vertex " + std::to_string( ( 1 << SCALE ) - 1 ) );
+		REQUIRE( same_edges( graphs[ 0 ].edges, expected ) );
+		REQUIRE( ( graphs[ 2 ].descriptions == std::vector< std::string > { "alpha", "beta" } ) );
+
+		std::istringstream input( text );
+		loaded_graph streamed;
+
+		REQUIRE( read_text_graph( input, 3, streamed ) );
+		REQUIRE( same_edges( streamed.edges, expected ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "binary_edge_list" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		loaded_graph graph;
+		graph.vertices = 5;
+		graph.edges = { { 0, 4, -1 }, { 4, 0, 2147483647 }, { 2, 2, 0 }, { 3, 1, 12 } };
+
+		save_binary_edge_list( BINARY_FILE, graph );
+		const auto loaded = load_binary_edge_list( BINARY_FILE, pool );
+
+		REQUIRE( loaded.vertices == 5 );
+		REQUIRE( loaded.descriptions.empty() );
+		REQUIRE( same_edges( loaded.edges, graph.edges ) );
+
+		graph.edges.clear();
+		save_binary_edge_list( BINARY_FILE, graph );
+		REQUIRE( load_binary_edge_list( BINARY_FILE, pool ).edges.empty() );
+
+		graph.edges = { { 0, 5, 1 } };
+		save_binary_edge_list( BINARY_FILE, graph );
+		REQUIRE_THROWS_AS( load_binary_edge_list( BINARY_FILE, pool ), const std::out_of_range& );
+
+		write_file( BINARY_FILE, "DSAEDGES" + std::string( 20, '\0' ) );
+		REQUIRE_THROWS_AS( load_binary_edge_list( BINARY_FILE, pool ), const std::invalid_argument& );
+
+		write_file( BINARY_FILE, "5\na\nb\nc\nd\ne\n0 0 0\n" );
+		REQUIRE_THROWS_AS( load_binary_edge_list( BINARY_FILE, pool ), const std::invalid_argument& );
+
+		std::remove( BINARY_FILE.c_str() );
+		REQUIRE_THROWS_AS( load_binary_edge_list( BINARY_FILE, pool ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		std::vector< edge_type > expected;
+
+		const auto text = rmat_text( BENCHMARK_SCALE, expected );
+		write_file( TEXT_FILE, text );
+
+		const auto measure = [&]( const auto& load )
+		{
+			const auto [ edges, milliseconds ] = timed( load );
+
+			REQUIRE( edges == expected.size() );
+
+			return static_cast< double >( text.size() ) / ( 1 << 20 ) / ( milliseconds / 1000 );
+		};
+
+		WARN( text.size() / ( 1 << 20 ) << " MB, " << expected.size() << " edges, " << pool.size() << " threads" );
+
+		WARN( "stream extraction: " << measure( [&]
+		{
+			std::ifstream input( TEXT_FILE );
+			std::string line;
+			std::size_t edges = 0;
+			int vertices = 0;
+
+			input >> vertices;
+			std::getline( input, line );
+
+			for ( int vertex = 0; vertex < vertices; ++vertex )
+			{
+				std::getline( input, line );
+			}
+
+			for ( int source, target, weight; input >> source >> target >> weight && source != 0; )
+			{
+				++edges;
+			}
+
+			return edges;
+		} ) << " MB/s" );
+
+		WARN( "read_text_graph: " << measure( [&]
+		{
+			std::ifstream input( TEXT_FILE );
+			loaded_graph graph;
+
+			read_text_graph( input, 3, graph );
+
+			return graph.edges.size();
+		} ) << " MB/s" );
+
+		WARN( "load_text_graphs: " << measure( [&]
+		{
+			return load_text_graphs( TEXT_FILE, 3, pool ).front().edges.size();
+		} ) << " MB/s" );
+
+		std::remove( TEXT_FILE.c_str() );
+	}
+}
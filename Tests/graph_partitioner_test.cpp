@@ -0,0 +1,212 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the multilevel k-way graph partitioner.
+ */
+
+#include "graphs/csr_graph.hpp"
+#include "graphs/graph_partitioner.hpp"
+#include "graphs/vertex_ordering.hpp"
+
+#include "concurrency/thread_pool.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "graph_partitioner_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using edge_type = graph_type::edge;
+	using partition_type = dsa::graph_partition< vertex_type >;
+
+	constexpr unsigned SCALE = 12;
+	constexpr std::size_t EDGE_FACTOR = 16;
+	constexpr std::size_t GRID_SIDE = 64;
+	constexpr std::size_t BENCHMARK_GRID_SIDE = 2000;
+	constexpr std::size_t SWEEPS = 10;
+	constexpr std::size_t PARTS_PER_THREAD = 64;
+
+	/**
+	 * Checks the sizes, balance and cut of a partition.
+	 */
+	bool
+	is_consistent(
+		const graph_type& graph,
+		const partition_type& partition,
+		const double imbalance )
+	{
+		std::vector< std::size_t > sizes( partition.count, 0 );
+		std::size_t cut = 0;
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			if ( partition.parts[ vertex ] >= partition.count )
+			{
+				return false;
+			}
+
+			++sizes[ partition.parts[ vertex ] ];
+
+			for ( const auto target : graph.neighbors( vertex ) )
+			{
+				cut += partition.parts[ vertex ] != partition.parts[ target ] ? 1 : 0;
+			}
+		}
+
+		const auto heaviest = std::ceil( static_cast< double >( graph.vertex_count() ) / partition.count * ( 1 + imbalance ) );
+
+		return partition.parts.size() == graph.vertex_count() &&
+			sizes == partition.sizes &&
+			cut == partition.cut &&
+			*std::max_element( std::begin( sizes ), std::end( sizes ) ) <= heaviest;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "grid" ).c_str() )
+	{
+		const auto grid = grid_graph( GRID_SIDE );
+
+		for ( const std::size_t count : { 1, 2, 4, 16 } )
+		{
+			const auto partition = partition_graph( grid, count );
+
+			REQUIRE( is_consistent( grid, partition, 0.03 ) );
+
+			// Square blocks cut about 2 * side * ( sqrt( count ) - 1 ) undirected edges.
+			const auto blocks = 4 * GRID_SIDE * static_cast< std::size_t >( std::ceil( std::sqrt( count ) ) - 1 );
+
+			REQUIRE( partition.cut <= 2 * blocks );
+		}
+
+		const auto partition = partition_graph( grid, 7, 0.0 );
+
+		REQUIRE( is_consistent( grid, partition, 0.0 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "rmat" ).c_str() )
+	{
+		const auto graph = rmat_graph( SCALE, EDGE_FACTOR, false );
+
+		for ( const std::size_t count : { 2, 8, 64 } )
+		{
+			const auto partition = partition_graph( graph, count, 0.1 );
+
+			REQUIRE( is_consistent( graph, partition, 0.1 ) );
+
+			// A random assignment cuts ( count - 1 ) / count of the edges.
+			REQUIRE( partition.cut < graph.edge_count() * ( count - 1 ) / count );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "degenerate" ).c_str() )
+	{
+		const graph_type empty;
+		const auto nothing = partition_graph( empty, 4 );
+
+		REQUIRE( nothing.parts.empty() );
+		REQUIRE( nothing.sizes == std::vector< std::size_t >( 4, 0 ) );
+
+		// More parts than vertices, isolated vertices, self-loops and parallel edges.
+		const graph_type small( 3, { { 0, 0, 1 }, { 0, 1, 1 }, { 0, 1, 1 } }, false );
+		const auto partition = partition_graph( small, 5 );
+
+		REQUIRE( is_consistent( small, partition, 0.03 ) );
+
+		REQUIRE_THROWS_AS( partition_graph( small, 0 ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( partition_graph( small, 2, -1.0 ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "ordering" ).c_str() )
+	{
+		const auto grid = grid_graph( GRID_SIDE );
+		const auto partition = partition_graph( grid, 4 );
+		const auto labels = partition_ordering( partition );
+		const auto relabeled = relabel( grid, labels );
+
+		// Part p holds the labels from the sizes of the parts before it on.
+		std::size_t first = 0;
+
+		for ( std::size_t part = 0; part < partition.count; ++part )
+		{
+			for ( vertex_type vertex = 0; vertex < grid.vertex_count(); ++vertex )
+			{
+				if ( partition.parts[ vertex ] == part )
+				{
+					REQUIRE( labels[ vertex ] >= first );
+					REQUIRE( labels[ vertex ] < first + partition.sizes[ part ] );
+				}
+			}
+
+			first += partition.sizes[ part ];
+		}
+
+		REQUIRE( relabeled.edge_count() == grid.edge_count() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		const auto threads = pool.size() + 1;
+
+		const auto measure = [&]( const graph_type& graph )
+		{
+			std::vector< double > values( graph.vertex_count(), 1.0 );
+			std::vector< double > sums( graph.vertex_count() );
+
+			// Pull sweeps, each thread owning a contiguous range of vertices (and of parts).
+			const auto [ value, milliseconds ] = timed( [&]
+			{
+				for ( std::size_t sweep = 0; sweep < SWEEPS; ++sweep )
+				{
+					pool.parallel_for( 0, threads, [&]( const std::size_t thread )
+					{
+						for ( auto vertex = graph.vertex_count() * thread / threads; vertex < graph.vertex_count() * ( thread + 1 ) / threads; ++vertex )
+						{
+							double sum = 0;
+
+							for ( const auto target : graph.neighbors( static_cast< vertex_type >( vertex ) ) )
+							{
+								sum += values[ target ];
+							}
+
+							sums[ vertex ] = sum;
+						}
+					}, 1 );
+
+					values.swap( sums );
+				}
+
+				return values[ 0 ];
+			} );
+
+			REQUIRE( value > 0 );
+
+			return milliseconds;
+		};
+
+		const auto grid = grid_graph( BENCHMARK_GRID_SIDE );
+
+		const auto [ partition, milliseconds ] = timed( [&]
+		{
+			return partition_graph( grid, threads * PARTS_PER_THREAD );
+		} );
+
+		WARN( BENCHMARK_GRID_SIDE << "x" << BENCHMARK_GRID_SIDE << " grid, " << grid.edge_count() << " edges, " << threads << " threads, " << partition.count << " parts, " << SWEEPS << " sweeps" );
+		WARN( "partitioning: " << milliseconds << " ms, cut " << partition.cut << " edges" );
+		WARN( "input order: " << measure( grid ) << " ms" );
+		WARN( "partition order: " << measure( relabel( grid, partition_ordering( partition ) ) ) << " ms" );
+	}
+}
@@ -0,0 +1,181 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the adjacency list graph.
+ */
+
+#include "graphs/graphl.hpp"
+
+#include "graphs/graph_loader.hpp"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "graphl_";
+	const std::string TEXT_FILE = "graphl_test.txt";
+
+	const std::string GRAPH =
+		"5\n"
+		"Aurora and 85th\n"
+		"Green Lake Starbucks\n"
+		"Woodland Park Zoo\n"
+		"Troll under bridge\n"
+		"PCC\n"
+		"1 2\n"
+		"1 4\n"
+		"2 3\n"
+		"3 1\n"
+		"4 3\n"
+		"5 4\n"
+		"0 0\n";
+
+	/**
+	 * Returns what action writes to std::cout.
+	 */
+	template < typename Action >
+	std::string
+	capture( const Action& action )
+	{
+		std::ostringstream output;
+		auto* const buffer = std::cout.rdbuf( output.rdbuf() );
+
+		action();
+		std::cout.rdbuf( buffer );
+
+		return output.str();
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "build" ).c_str() )
+	{
+		std::istringstream input( GRAPH );
+		GraphL graph;
+
+		REQUIRE( graph.isEmpty() );
+
+		graph.buildGraph( input );
+
+		REQUIRE( graph.getSize() == 5 );
+
+		const auto frozen = graph.freeze();
+
+		REQUIRE( frozen.vertex_count() == 5 );
+		REQUIRE( frozen.edge_count() == 6 );
+		REQUIRE( std::vector< csr_graph<>::vertex_type >( std::begin( frozen.neighbors( 0 ) ), std::end( frozen.neighbors( 0 ) ) ) ==
+			std::vector< csr_graph<>::vertex_type >( { 1, 3 } ) );
+
+		const auto output = capture( [&graph]
+		{
+			graph.displayGraph();
+		} );
+
+		REQUIRE( output.find( "Troll under bridge" ) != std::string::npos );
+		REQUIRE( output.find( "  edge 5 4\n" ) != std::string::npos );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "find_node" ).c_str() )
+	{
+		std::istringstream input( GRAPH );
+		GraphL graph;
+
+		graph.buildGraph( input );
+
+		REQUIRE( graph.findNode( "Aurora and 85th" ) == 1 );
+		REQUIRE( graph.findNode( "Woodland Park Zoo" ) == 3 );
+		REQUIRE( graph.findNode( "PCC" ) == 5 );
+		REQUIRE( graph.findNode( "pcc" ) == 0 );
+		REQUIRE( graph.findNode( "" ) == 0 );
+		REQUIRE( graph.insertEdge( graph.findNode( "PCC" ), graph.findNode( "Aurora and 85th" ) ) );
+
+		graph.makeEmpty();
+
+		REQUIRE( graph.findNode( "PCC" ) == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "load_graphs" ).c_str() )
+	{
+		std::ofstream( TEXT_FILE, std::ios::binary ) << GRAPH << GRAPH;
+
+		const auto graphs = GraphL::loadGraphs( TEXT_FILE );
+		std::istringstream input( GRAPH );
+
+		std::remove( TEXT_FILE.c_str() );
+
+		REQUIRE( graphs.size() == 2 );
+
+		GraphL mapped;
+		GraphL streamed;
+
+		REQUIRE( mapped.buildGraph( graphs.back() ) );
+
+		streamed.buildGraph( input );
+
+		REQUIRE( capture( [&mapped] { mapped.displayGraph(); } ) == capture( [&streamed] { streamed.displayGraph(); } ) );
+		REQUIRE_THROWS_AS( GraphL::loadGraphs( TEXT_FILE ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "edges" ).c_str() )
+	{
+		loaded_graph loaded;
+
+		loaded.vertices = 4;
+		loaded.edges = { { 0, 2, 0 }, { 0, 1, 0 } };
+
+		GraphL graph;
+
+		REQUIRE( graph.buildGraph( loaded ) );
+
+		REQUIRE_FALSE( graph.insertEdge( 1, 2 ) );
+		REQUIRE_FALSE( graph.insertEdge( 1, 1 ) );
+		REQUIRE_FALSE( graph.insertEdge( 1, 5 ) );
+		REQUIRE( graph.insertEdge( 1, 4 ) );
+		REQUIRE( graph.insertEdge( 4, 1 ) );
+		REQUIRE( graph.removeEdge( 1, 3 ) );
+		REQUIRE_FALSE( graph.removeEdge( 1, 3 ) );
+
+		// The edges of a node are kept ordered by target.
+		const auto frozen = graph.freeze();
+
+		REQUIRE( std::vector< csr_graph<>::vertex_type >( std::begin( frozen.neighbors( 0 ) ), std::end( frozen.neighbors( 0 ) ) ) ==
+			std::vector< csr_graph<>::vertex_type >( { 1, 3 } ) );
+		REQUIRE( frozen.neighbors( 3 ).size() == 1 );
+
+		// Duplicate edges are invalid in bulk.
+		loaded.edges.push_back( { 0, 2, 0 } );
+
+		REQUIRE_FALSE( graph.buildGraph( loaded ) );
+		REQUIRE( graph.isEmpty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "depth_first_search" ).c_str() )
+	{
+		std::istringstream input( GRAPH );
+		GraphL graph;
+
+		graph.buildGraph( input );
+
+		// Node 5 cannot be reached from node 1.
+		REQUIRE( capture( [&graph]
+		{
+			graph.depthFirstSearch();
+		} ) == "Depth - first ordering: search failed!\n\n" );
+
+		REQUIRE( graph.insertEdge( 3, 5 ) );
+		REQUIRE( capture( [&graph]
+		{
+			graph.depthFirstSearch();
+		} ) == "Depth - first ordering: 1 2 3 5 4\n\n" );
+	}
+}
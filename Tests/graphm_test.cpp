@@ -0,0 +1,537 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the adjacency matrix graph and its shortest paths.
+ */
+
+#include "graphs/graphm.hpp"
+
+#include "graphs/graph_loader.hpp"
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "graphm_";
+	const std::string TEXT_FILE = "graphm_test.txt";
+
+	using cost_matrix = std::vector< std::vector< long long > >;
+
+	constexpr long long NO_PATH = std::numeric_limits< long long >::max();
+
+	constexpr int NODES = 80;
+	constexpr int UPDATE_NODES = 40;
+	constexpr int UPDATES = 200;
+	constexpr int MAX_WEIGHT = 20;
+
+	const int MODES[] =
+	{
+		dsa::SHORTEST_PATH_AUTO,
+		dsa::SHORTEST_PATH_DIJKSTRA,
+		dsa::SHORTEST_PATH_FLOYD_WARSHALL
+	};
+
+	/**
+	 * A distance and the path (1-based nodes) displayed for a pair of nodes;
+	 * the distance is NO_PATH when the nodes are displayed as not connected.
+	 */
+	struct displayed_path
+	{
+		long long distance = NO_PATH;
+		std::vector< int > nodes;
+	};
+
+	/**
+	 * Returns what action writes to std::cout.
+	 */
+	template < typename Action >
+	std::string
+	capture( const Action& action )
+	{
+		std::ostringstream output;
+		auto* const buffer = std::cout.rdbuf( output.rdbuf() );
+
+		action();
+		std::cout.rdbuf( buffer );
+
+		return output.str();
+	}
+
+	/**
+	 * Builds a graph of nodes whose possible edges are present one time in
+	 * sparsity, with weights (zero included) up to MAX_WEIGHT.
+	 */
+	dsa::loaded_graph
+	random_graph(
+		const int nodes,
+		const std::uint32_t sparsity )
+	{
+		generator< std::uint32_t > generator;
+		dsa::loaded_graph graph;
+
+		graph.vertices = nodes;
+
+		for ( int node = 0; node < nodes; ++node )
+		{
+			graph.descriptions.push_back( "node " + std::to_string( node + 1 ) );
+
+			for ( int target = 0; target < nodes; ++target )
+			{
+				if ( target != node && generator() % sparsity == 0 )
+				{
+					graph.edges.push_back( {
+						static_cast< std::uint32_t >( node ),
+						static_cast< std::uint32_t >( target ),
+						static_cast< std::int32_t >( generator() % ( MAX_WEIGHT + 1 ) ) } );
+				}
+			}
+		}
+
+		return graph;
+	}
+
+	/**
+	 * Returns the edge costs (1-based, NO_PATH when there is no edge).
+	 */
+	cost_matrix
+	edge_costs( const dsa::loaded_graph& graph )
+	{
+		cost_matrix costs( graph.vertices + 1, std::vector< long long >( graph.vertices + 1, NO_PATH ) );
+
+		for ( const auto& edge : graph.edges )
+		{
+			costs[ edge.source + 1 ][ edge.target + 1 ] = edge.weight;
+		}
+
+		return costs;
+	}
+
+	/**
+	 * Reference all-pairs shortest distances, by a plain Floyd-Warshall.
+	 */
+	cost_matrix
+	all_pairs( const cost_matrix& costs )
+	{
+		auto distances = costs;
+
+		for ( std::size_t node = 1; node < distances.size(); ++node )
+		{
+			distances[ node ][ node ] = 0;
+		}
+
+		for ( std::size_t via = 1; via < distances.size(); ++via )
+		{
+			for ( std::size_t from = 1; from < distances.size(); ++from )
+			{
+				for ( std::size_t to = 1; to < distances.size(); ++to )
+				{
+					if ( distances[ from ][ via ] != NO_PATH && distances[ via ][ to ] != NO_PATH &&
+						distances[ from ][ via ] + distances[ via ][ to ] < distances[ from ][ to ] )
+					{
+						distances[ from ][ to ] = distances[ from ][ via ] + distances[ via ][ to ];
+					}
+				}
+			}
+		}
+
+		return distances;
+	}
+
+	/**
+	 * Returns the cost of a path along existing edges, or NO_PATH if one of its
+	 * edges is missing.
+	 */
+	long long
+	path_cost(
+		const cost_matrix& costs,
+		const std::vector< int >& path )
+	{
+		long long cost = 0;
+
+		for ( std::size_t node = 1; node < path.size(); ++node )
+		{
+			if ( costs[ path[ node - 1 ] ][ path[ node ] ] == NO_PATH )
+			{
+				return NO_PATH;
+			}
+
+			cost += costs[ path[ node - 1 ] ][ path[ node ] ];
+		}
+
+		return cost;
+	}
+
+	/**
+	 * Parses the output of displayAll into the displayed paths (1-based).
+	 */
+	std::vector< std::vector< displayed_path > >
+	displayed_paths(
+		const dsa::GraphM& graph,
+		const int nodes )
+	{
+		std::vector< std::vector< displayed_path > > paths( nodes + 1, std::vector< displayed_path >( nodes + 1 ) );
+		std::istringstream output( capture( [&graph]
+		{
+			graph.displayAll();
+		} ) );
+		std::string line;
+
+		while ( std::getline( output, line ) )
+		{
+			// Path lines are indented past the node descriptions.
+			if ( line.empty() || line[ 0 ] != ' ' )
+			{
+				continue;
+			}
+
+			std::istringstream fields( line );
+			std::string distance;
+			int from = 0;
+			int to = 0;
+
+			fields >> from >> to >> distance;
+
+			REQUIRE( from >= 1 );
+			REQUIRE( to >= 1 );
+
+			if ( distance != "---" )
+			{
+				auto& path = paths[ from ][ to ];
+
+				path.distance = std::stoll( distance );
+
+				for ( int node; fields >> node; )
+				{
+					path.nodes.push_back( node );
+				}
+			}
+		}
+
+		return paths;
+	}
+
+	/**
+	 * Checks every displayed path against the reference distances: each one has
+	 * the shortest distance and runs along existing edges of that total cost.
+	 */
+	void
+	check_paths(
+		const dsa::GraphM& graph,
+		const cost_matrix& costs )
+	{
+		const auto nodes = static_cast< int >( costs.size() ) - 1;
+		const auto distances = all_pairs( costs );
+		const auto paths = displayed_paths( graph, nodes );
+
+		for ( int from = 1; from <= nodes; ++from )
+		{
+			for ( int to = 1; to <= nodes; ++to )
+			{
+				if ( from == to )
+				{
+					continue;
+				}
+
+				const auto& path = paths[ from ][ to ];
+
+				REQUIRE( path.distance == distances[ from ][ to ] );
+
+				if ( path.distance != NO_PATH )
+				{
+					REQUIRE( path.nodes.size() >= 2 );
+					REQUIRE( path.nodes.front() == from );
+					REQUIRE( path.nodes.back() == to );
+					REQUIRE( path_cost( costs, path.nodes ) == path.distance );
+				}
+			}
+		}
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "build" ).c_str() )
+	{
+		GraphM graph;
+
+		REQUIRE( graph.isEmpty() );
+
+		std::istringstream input(
+			"3\n"
+			"first\n"
+			"second\n"
+			"third\n"
+			"1 2 10\n"
+			"2 3 4\n"
+			"0 0 0\n"
+			"2\n"
+			"alpha\n"
+			"beta\n"
+			"1 1 5\n"
+			"0 0 0\n" );
+
+		graph.buildGraph( input );
+
+		REQUIRE( graph.getSize() == 3 );
+
+		graph.findShortestPath();
+
+		const auto output = capture( [&graph]
+		{
+			graph.display( 1, 3 );
+		} );
+
+		REQUIRE( output.find( "14" ) != std::string::npos );
+		REQUIRE( output.find( "first\nsecond\nthird\n" ) != std::string::npos );
+
+		// A self-loop is invalid edge data: the second graph is rejected.
+		const auto error = std::cerr.rdbuf( nullptr );
+
+		graph.buildGraph( input );
+		std::cerr.rdbuf( error );
+
+		REQUIRE( graph.isEmpty() );
+
+		REQUIRE_FALSE( graph.insertEdge( 1, 2, 1 ) );
+		REQUIRE( graph.findPath( 1, 2 ).empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "find_node" ).c_str() )
+	{
+		loaded_graph loaded;
+
+		loaded.vertices = 5;
+		loaded.descriptions = { "first", "second", "first", "" };
+		loaded.edges = { { 0, 1, 3 }, { 2, 1, 1 } };
+
+		GraphM graph;
+
+		REQUIRE( graph.findNode( "first" ) == 0 );
+		REQUIRE( graph.buildGraph( loaded ) );
+
+		// A shared description names its first node; empty ones name none.
+		REQUIRE( graph.findNode( "first" ) == 1 );
+		REQUIRE( graph.findNode( "second" ) == 2 );
+		REQUIRE( graph.findNode( "" ) == 0 );
+		REQUIRE( graph.findNode( "third" ) == 0 );
+		REQUIRE( graph.findPath( graph.findNode( "first" ), graph.findNode( "second" ) ) == std::vector< int >( { 1, 2 } ) );
+
+		// Invalid edge data leaves the graph, and its names, empty.
+		loaded.edges.push_back( { 3, 3, 1 } );
+
+		REQUIRE_FALSE( graph.buildGraph( loaded ) );
+		REQUIRE( graph.findNode( "first" ) == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "load_graphs" ).c_str() )
+	{
+		const std::string text =
+			"3\n"
+			"first\n"
+			"second\n"
+			"third\n"
+			"1 2 10\n"
+			"2 3 4\n"
+			"0 0 0\n"
+			"2\n"
+			"alpha\n"
+			"beta\n"
+			"2 1 5\n"
+			"0 0 0\n";
+
+		std::ofstream( TEXT_FILE, std::ios::binary ) << text;
+
+		const auto graphs = GraphM::loadGraphs( TEXT_FILE );
+		std::istringstream input( text );
+
+		std::remove( TEXT_FILE.c_str() );
+
+		REQUIRE( graphs.size() == 2 );
+
+		// The graphs of the file are the ones read from the stream.
+		for ( const auto& loaded : graphs )
+		{
+			GraphM mapped;
+			GraphM streamed;
+
+			REQUIRE( mapped.buildGraph( loaded ) );
+
+			streamed.buildGraph( input );
+			mapped.findShortestPath();
+			streamed.findShortestPath();
+
+			REQUIRE( mapped.getSize() == streamed.getSize() );
+			REQUIRE( capture( [&mapped] { mapped.displayAll(); } ) == capture( [&streamed] { streamed.displayAll(); } ) );
+		}
+
+		REQUIRE_THROWS_AS( GraphM::loadGraphs( TEXT_FILE ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "modes" ).c_str() )
+	{
+		// Sparse and dense graphs, with more nodes than a Floyd-Warshall tile.
+		for ( const std::uint32_t sparsity : { 20u, 3u } )
+		{
+			const auto loaded = random_graph( NODES, sparsity );
+			const auto costs = edge_costs( loaded );
+			GraphM graph;
+
+			REQUIRE( graph.buildGraph( loaded ) );
+
+			for ( const auto mode : MODES )
+			{
+				graph.findShortestPath( mode );
+				check_paths( graph, costs );
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "find_path" ).c_str() )
+	{
+		const auto loaded = random_graph( NODES, 20 );
+		const auto costs = edge_costs( loaded );
+		const auto distances = all_pairs( costs );
+		GraphM graph;
+
+		REQUIRE( graph.buildGraph( loaded ) );
+
+		for ( int from = 1; from <= NODES; ++from )
+		{
+			for ( int to = 1; to <= NODES; ++to )
+			{
+				// An exact heuristic never overestimates; the zero one is Dijkstra's.
+				const auto exact = [&distances, to]( const int node )
+				{
+					return distances[ node ][ to ] == NO_PATH ? 0 : static_cast< int >( distances[ node ][ to ] );
+				};
+				const auto paths =
+				{
+					graph.findPath( from, to ),
+					graph.findPath( from, to, []( int ) { return 0; } ),
+					graph.findPath( from, to, exact )
+				};
+
+				for ( const auto& path : paths )
+				{
+					if ( from == to || distances[ from ][ to ] == NO_PATH )
+					{
+						REQUIRE( path.empty() );
+					}
+					else
+					{
+						REQUIRE( path.front() == from );
+						REQUIRE( path.back() == to );
+						REQUIRE( path_cost( costs, path ) == distances[ from ][ to ] );
+					}
+				}
+			}
+		}
+
+		REQUIRE( graph.findPath( 0, 1 ).empty() );
+		REQUIRE( graph.findPath( 1, NODES + 1 ).empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "incremental_updates" ).c_str() )
+	{
+		generator< std::uint32_t > generator;
+
+		for ( const auto mode : MODES )
+		{
+			const auto loaded = random_graph( UPDATE_NODES, 8 );
+			auto costs = edge_costs( loaded );
+			GraphM graph;
+
+			REQUIRE( graph.buildGraph( loaded ) );
+
+			graph.findShortestPath( mode );
+
+			// Lowered, raised and removed edges are repaired in place, without
+			// calling findShortestPath again.
+			for ( int update = 0; update < UPDATES; ++update )
+			{
+				const auto from = static_cast< int >( generator() % UPDATE_NODES ) + 1;
+				const auto to = static_cast< int >( generator() % UPDATE_NODES ) + 1;
+
+				if ( from == to )
+				{
+					continue;
+				}
+
+				if ( generator() % 3 == 0 )
+				{
+					REQUIRE( graph.removeEdge( from, to ) == ( costs[ from ][ to ] != NO_PATH ) );
+
+					costs[ from ][ to ] = NO_PATH;
+				}
+				else
+				{
+					const auto weight = static_cast< int >( generator() % ( MAX_WEIGHT + 1 ) );
+
+					REQUIRE( graph.insertEdge( from, to, weight ) == ( costs[ from ][ to ] != weight ) );
+
+					costs[ from ][ to ] = weight;
+				}
+
+				check_paths( graph, costs );
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "missing_edge_regression" ).c_str() )
+	{
+		// The shortest path from 7 to 4 runs through 5 and 6, and there is no
+		// edge from 7 to 6: it must not be displayed as "7 6 4".
+		loaded_graph loaded;
+
+		loaded.vertices = 7;
+		loaded.descriptions.assign( 7, "node" );
+		loaded.edges =
+		{
+			{ 6, 4, 1 },
+			{ 4, 5, 1 },
+			{ 5, 3, 1 },
+			{ 6, 3, 10 },
+			{ 5, 6, 1 },
+			{ 2, 5, 2 }
+		};
+
+		auto costs = edge_costs( loaded );
+
+		for ( const auto mode : MODES )
+		{
+			GraphM graph;
+
+			REQUIRE( graph.buildGraph( loaded ) );
+
+			graph.findShortestPath( mode );
+
+			REQUIRE( displayed_paths( graph, 7 )[ 7 ][ 4 ].nodes == std::vector< int >( { 7, 5, 6, 4 } ) );
+			REQUIRE( graph.findPath( 7, 4 ) == std::vector< int >( { 7, 5, 6, 4 } ) );
+			check_paths( graph, costs );
+
+			REQUIRE( graph.removeEdge( 5, 6 ) );
+
+			auto removed = costs;
+			removed[ 5 ][ 6 ] = NO_PATH;
+
+			REQUIRE( displayed_paths( graph, 7 )[ 7 ][ 4 ].nodes == std::vector< int >( { 7, 4 } ) );
+			check_paths( graph, removed );
+
+			REQUIRE( graph.insertEdge( 3, 6, 0 ) );
+
+			removed[ 3 ][ 6 ] = 0;
+
+			check_paths( graph, removed );
+		}
+	}
+}
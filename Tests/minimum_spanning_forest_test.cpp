@@ -0,0 +1,223 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the Boruvka and Kruskal minimum spanning forests.
+ */
+
+#include "graphs/csr_graph.hpp"
+#include "graphs/minimum_spanning_forest.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "minimum_spanning_forest_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using edge_type = graph_type::edge;
+	using forest_type = dsa::spanning_forest< vertex_type, std::int32_t >;
+
+	constexpr unsigned SCALE = 12;
+	constexpr std::size_t EDGE_FACTOR = 4;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t BENCHMARK_EDGE_FACTOR = 16;
+	constexpr std::size_t THREADS = 4;
+
+	/**
+	 * Weight of the minimum spanning forest by Prim's algorithm from every unreached vertex.
+	 */
+	std::int64_t
+	prim_weight( const graph_type& graph )
+	{
+		using entry = std::pair< std::int32_t, vertex_type >;
+
+		const auto transposed = graph.transpose();
+
+		std::vector< bool > reached( graph.vertex_count(), false );
+		std::int64_t weight = 0;
+
+		for ( vertex_type root = 0; root < graph.vertex_count(); ++root )
+		{
+			std::priority_queue< entry, std::vector< entry >, std::greater< entry > > queue;
+
+			queue.push( { 0, root } );
+
+			while ( !queue.empty() )
+			{
+				const auto top = queue.top();
+				queue.pop();
+
+				if ( reached[ top.second ] )
+				{
+					continue;
+				}
+
+				reached[ top.second ] = true;
+				weight += top.first;
+
+				for ( const auto* adjacency : { &graph, &transposed } )
+				{
+					const auto neighbors = adjacency->neighbors( top.second );
+
+					for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+					{
+						if ( !reached[ neighbors[ edge ] ] )
+						{
+							queue.push( { adjacency->weighted() ? adjacency->neighbor_weights( top.second )[ edge ] : 1, neighbors[ edge ] } );
+						}
+					}
+				}
+			}
+		}
+
+		return weight;
+	}
+
+	/**
+	 * Checks that the forest edges are edges of the graph, add up to its weight and
+	 * connect what the graph connects without a cycle.
+	 */
+	bool
+	is_spanning_forest(
+		const graph_type& graph,
+		const forest_type& forest )
+	{
+		dsa::union_find< vertex_type > graph_sets( graph.vertex_count() );
+		dsa::union_find< vertex_type > forest_sets( graph.vertex_count() );
+		std::int64_t weight = 0;
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			for ( const auto target : graph.neighbors( vertex ) )
+			{
+				graph_sets.unite( vertex, target );
+			}
+		}
+
+		for ( const auto& edge : forest.edges )
+		{
+			const auto neighbors = graph.neighbors( edge.source );
+			bool found = false;
+
+			for ( std::size_t index = 0; index < neighbors.size(); ++index )
+			{
+				found = found || ( neighbors[ index ] == edge.target &&
+					( graph.weighted() ? graph.neighbor_weights( edge.source )[ index ] : 1 ) == edge.weight );
+			}
+
+			if ( !found || !forest_sets.unite( edge.source, edge.target ) )
+			{
+				return false;
+			}
+
+			weight += edge.weight;
+		}
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			if ( graph_sets.find( vertex ) != forest_sets.find( vertex ) )
+			{
+				return false;
+			}
+		}
+
+		return weight == forest.weight;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "small" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		// Two triangles, one with a tie, plus an isolated vertex and a self-loop.
+		const graph_type graph( 7, {
+			{ 0, 1, 4 }, { 1, 2, 1 }, { 2, 0, 2 },
+			{ 3, 4, 5 }, { 4, 5, 5 }, { 5, 3, 5 },
+			{ 6, 6, -3 } } );
+
+		for ( const auto& forest : { boruvka_minimum_spanning_forest( graph, pool ), kruskal_minimum_spanning_forest( graph ) } )
+		{
+			REQUIRE( forest.edges.size() == 4 );
+			REQUIRE( forest.weight == 13 );
+			REQUIRE( is_spanning_forest( graph, forest ) );
+		}
+
+		const graph_type empty;
+
+		REQUIRE( boruvka_minimum_spanning_forest( empty, pool ).edges.empty() );
+		REQUIRE( kruskal_minimum_spanning_forest( empty ).edges.empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "matches_prim" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		// Weights in [-max_weight / 2, max_weight / 2], each edge listed once.
+		for ( const std::int32_t max_weight : { 0, 10, 100000 } )
+		{
+			const auto graph = rmat_graph( SCALE, EDGE_FACTOR, false, -max_weight / 2, max_weight - max_weight / 2 );
+			const auto expected = prim_weight( graph );
+
+			const auto boruvka = boruvka_minimum_spanning_forest( graph, pool );
+			const auto kruskal = kruskal_minimum_spanning_forest( graph );
+
+			REQUIRE( boruvka.weight == expected );
+			REQUIRE( kruskal.weight == expected );
+			REQUIRE( boruvka.edges.size() == kruskal.edges.size() );
+			REQUIRE( is_spanning_forest( graph, boruvka ) );
+			REQUIRE( is_spanning_forest( graph, kruskal ) );
+		}
+
+		// Unweighted edges weigh 1.
+		const graph_type path( 4, { { 0, 1, 9 }, { 1, 2, 9 }, { 2, 3, 9 }, { 3, 0, 9 } }, false );
+
+		REQUIRE( boruvka_minimum_spanning_forest( path, pool ).weight == 3 );
+		REQUIRE( kruskal_minimum_spanning_forest( path ).weight == 3 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+		const auto graph = rmat_graph( BENCHMARK_SCALE, BENCHMARK_EDGE_FACTOR, false, -500000, 500000 );
+
+		const auto measure = [&]( const auto& span )
+		{
+			const auto [ forest, milliseconds ] = timed( span );
+
+			REQUIRE( !forest.edges.empty() );
+
+			return milliseconds;
+		};
+
+		WARN( "R-MAT scale " << BENCHMARK_SCALE << ", " << graph.edge_count() << " edges, " << pool.size() << " threads" );
+		WARN( "Prim: " << measure( [&]
+		{
+			forest_type forest;
+			forest.weight = prim_weight( graph );
+			forest.edges.resize( 1 );
+
+			return forest;
+		} ) << " ms" );
+		WARN( "Kruskal (radix sort): " << measure( [&]
+		{
+			return kruskal_minimum_spanning_forest( graph );
+		} ) << " ms" );
+		WARN( "Boruvka: " << measure( [&]
+		{
+			return boruvka_minimum_spanning_forest( graph, pool );
+		} ) << " ms" );
+	}
+}
@@ -0,0 +1,158 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the persistent Binary Search Tree.
+ */
+
+#include "trees/persistent_binary_search_tree.hpp"
+
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <set>
+
+namespace
+{
+	const std::string UNIT_NAME = "persistent_binary_search_tree_";
+
+	using key_type = std::int32_t;
+	using value_type = std::int32_t;
+	constexpr std::size_t ITERATIONS = 10000;
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "empty" ).c_str() )
+	{
+		persistent_binary_search_tree< key_type, value_type > bst;
+
+		REQUIRE( bst.empty() );
+		REQUIRE( bst.erase( 0 ).empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "insert" ).c_str() )
+	{
+		std::vector< key_type > keys;
+		generator< value_type >().fill_buffer_n( std::back_inserter( keys ), ITERATIONS );
+
+		persistent_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : keys )
+		{
+			bst = bst.insert( key, static_cast< value_type >( key ) );
+		}
+
+		std::sort( std::begin( keys ), std::end( keys ) );
+		keys.erase( std::unique( std::begin( keys ), std::end( keys ) ), std::end( keys ) );
+
+		std::vector< key_type > extracted_keys;
+		bst.inorder([&extracted_keys]( auto const & node )
+		{
+			extracted_keys.emplace_back( node->key );
+		} );
+
+		REQUIRE( keys == extracted_keys );
+		REQUIRE( bst.size() == keys.size() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "versions_are_independent" ).c_str() )
+	{
+		persistent_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : { 0, -2, -1, -3, 4, 3, 7, 6, 8 } )
+		{
+			bst = bst.insert( key, key );
+		}
+
+		const auto snapshot = bst;
+
+		const auto inserted = bst.insert( 5, 5 );
+		const auto erased = bst.erase( 4 );
+
+		REQUIRE( snapshot == bst );
+		REQUIRE( !bst.contains( 5 ) );
+		REQUIRE( bst.contains( 4 ) );
+		REQUIRE( bst.size() == 9 );
+
+		REQUIRE( inserted.contains( 5 ) );
+		REQUIRE( inserted.size() == 10 );
+
+		REQUIRE( !erased.contains( 4 ) );
+		REQUIRE( erased.contains( 3 ) );
+		REQUIRE( erased.contains( 7 ) );
+		REQUIRE( erased.size() == 8 );
+		REQUIRE( *erased.find( 3 ) == 3 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "untouched_subtrees_are_shared" ).c_str() )
+	{
+		persistent_binary_search_tree< key_type, value_type > bst;
+		for ( auto key : { 4, 2, 6, 1, 3, 5, 7 } )
+		{
+			bst = bst.insert( key, value_type() );
+		}
+
+		const auto inserted = bst.insert( 0, value_type() );
+
+		REQUIRE( inserted.root_node() != bst.root_node() );
+		REQUIRE( inserted.root_node()->right == bst.root_node()->right );
+		REQUIRE( inserted.root_node()->left->right == bst.root_node()->left->right );
+
+		const auto erased = bst.erase( 7 );
+
+		REQUIRE( erased.root_node()->left == bst.root_node()->left );
+		REQUIRE( erased.root_node()->right->left == bst.root_node()->right->left );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "random_operations" ).c_str() )
+	{
+		generator< value_type > generator;
+
+		std::set< key_type > reference;
+		persistent_binary_search_tree< key_type, value_type > bst;
+
+		for ( std::size_t iteration = 0; iteration < ITERATIONS; ++iteration )
+		{
+			const auto key = generator() % 256;
+
+			if ( generator() % 2 )
+			{
+				reference.insert( key );
+				bst = bst.insert( key, key );
+			}
+			else
+			{
+				reference.erase( key );
+				bst = bst.erase( key );
+			}
+		}
+
+		std::vector< key_type > extracted_keys;
+		bst.inorder([&extracted_keys]( auto const & node )
+		{
+			extracted_keys.emplace_back( node->key );
+		} );
+
+		REQUIRE( std::equal(
+			std::cbegin( reference ),
+			std::cend( reference ),
+			std::cbegin( extracted_keys ),
+			std::cend( extracted_keys ) ) );
+		REQUIRE( bst.size() == reference.size() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "degenerate_release" ).c_str() )
+	{
+		persistent_binary_search_tree< key_type, value_type > bst;
+		for ( key_type key = 0; key < static_cast< key_type >( ITERATIONS ); ++key )
+		{
+			bst = bst.insert( key, key );
+		}
+
+		REQUIRE( bst.height() == ITERATIONS - 1 );
+
+		bst = persistent_binary_search_tree< key_type, value_type >();
+
+		REQUIRE( bst.empty() );
+	}
+}
@@ -10,12 +10,16 @@
 #include "sorts/insertion_sort.hpp"
 #include "sorts/merge_sort.hpp"
 #include "sorts/quick_sort.hpp"
+#include "sorts/radix_sort.hpp"
 
 #include "utilities/generator.hpp"
 
 #include <catch.hpp>
 
+#include <algorithm>
 #include <array>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -92,4 +96,38 @@ namespace dsa
 		sort_tester< quick::custom_implementation >();
 	}
 
+	TEST_CASE( ( UNIT_NAME + "radix sort" ).c_str() )
+	{
+		sort_tester< radix >();
+	}
+
+	TEST_CASE( ( UNIT_NAME + "radix sort (keyed)" ).c_str() )
+	{
+		using item_type = std::pair< std::uint16_t, std::size_t >;
+		constexpr auto ITERATIONS = 1000U;
+
+		std::vector< item_type > container;
+
+		generator< std::uint16_t > generator;
+
+		for ( std::size_t index = 0; index < ITERATIONS; ++index )
+		{
+			container.emplace_back( generator() % 100, index );
+		}
+
+		// Items of equal keys keep their order.
+		auto expected = container;
+		std::stable_sort( std::begin( expected ), std::end( expected ), []( const item_type& lhs, const item_type& rhs )
+		{
+			return lhs.first < rhs.first;
+		} );
+
+		radix::sort( std::begin( container ), std::end( container ), []( const item_type& item )
+		{
+			return item.first;
+		} );
+
+		REQUIRE( container == expected );
+	}
+
 }
@@ -0,0 +1,863 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the Threaded Binary Search Tree and its companions (node pool,
+ * token arena, Left-Right wrapper and report writer). The tree is checked
+ * against a std::map of token frequencies, and its structure (threads and AVL
+ * balance) by walking its child links.
+ */
+
+#include "trees/tbst.hpp"
+#include "trees/tbst_concurrent.hpp"
+#include "trees/tbst_node_pool.hpp"
+#include "trees/tbst_report_writer.hpp"
+#include "trees/tbst_token_arena.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "tbst_";
+	const std::string TEXT_FILE = "tbst_test.txt";
+	const std::string SNAPSHOT_FILE = "tbst_test.snapshot";
+
+	using frequencies = std::map< std::string, int >;
+
+	constexpr std::size_t TOKENS = 5000;
+	constexpr std::size_t THREADS = 4;
+	constexpr std::size_t BENCHMARK_TOKENS = 1 << 16;
+	constexpr std::size_t BENCHMARK_READS = 1 << 22;
+	constexpr std::size_t BENCHMARK_READERS = 64;
+
+	/**
+	 * Short tokens over a small alphabet, so that they repeat and share prefixes.
+	 */
+	std::vector< std::string >
+	random_tokens( const std::size_t count )
+	{
+		generator< std::uint32_t > generator;
+		std::vector< std::string > tokens;
+
+		for ( std::size_t token = 0; token < count; ++token )
+		{
+			std::string characters( 1 + generator() % 4, 'a' );
+
+			for ( auto& character : characters )
+			{
+				character = static_cast< char >( 'a' + generator() % 5 );
+			}
+
+			tokens.push_back( std::move( characters ) );
+		}
+
+		return tokens;
+	}
+
+	/**
+	 * Token frequencies of a text, tokenized as by the tree.
+	 */
+	frequencies
+	count_tokens( const std::string& text )
+	{
+		frequencies counts;
+		std::string token;
+
+		for ( const auto character : text + ' ' )
+		{
+			if ( std::isalnum( static_cast< unsigned char >( character ) ) ||
+				character == '\'' || character == '"' || character == '-' || character == '_' )
+			{
+				token.push_back( character );
+			}
+			else if ( !token.empty() )
+			{
+				++counts[ token ];
+				token.clear();
+			}
+		}
+
+		return counts;
+	}
+
+	std::string
+	random_text( const std::size_t count )
+	{
+		std::string text;
+
+		for ( const auto& token : random_tokens( count ) )
+		{
+			text += token;
+			text += ( token.size() % 3 == 0 ) ? ",\n" : " ";
+		}
+
+		return text;
+	}
+
+	/**
+	 * The tokens and frequencies of a tree, in order.
+	 */
+	frequencies
+	tree_tokens( const dsa::ThreadedBinarySearchTree& tree )
+	{
+		frequencies tokens;
+
+		for ( const auto* node : tree.traverse( dsa::INORDER ) )
+		{
+			tokens.emplace( node->data.getToken(), node->data.getFrequency() );
+		}
+
+		return tokens;
+	}
+
+	std::vector< std::string >
+	traversal_tokens(
+		const dsa::ThreadedBinarySearchTree& tree,
+		const int traverseType )
+	{
+		std::vector< std::string > tokens;
+
+		for ( const auto* node : tree.traverse( traverseType ) )
+		{
+			tokens.push_back( node->data.getToken() );
+		}
+
+		return tokens;
+	}
+
+	/**
+	 * Pre-order (order 0), in-order (1) or post-order (2) walk of the child links.
+	 */
+	void
+	walk_children(
+		const dsa::Node* node,
+		const int order,
+		std::vector< std::string >& tokens )
+	{
+		if ( order == 0 )
+		{
+			tokens.push_back( node->data.getToken() );
+		}
+
+		if ( node->leftNodeType == dsa::CHILD )
+		{
+			walk_children( node->leftNode, order, tokens );
+		}
+
+		if ( order == 1 )
+		{
+			tokens.push_back( node->data.getToken() );
+		}
+
+		if ( node->rightNodeType == dsa::CHILD )
+		{
+			walk_children( node->rightNode, order, tokens );
+		}
+
+		if ( order == 2 )
+		{
+			tokens.push_back( node->data.getToken() );
+		}
+	}
+
+	/**
+	 * Returns the height of the subtree, or -1 if it is not a valid AVL tree
+	 * (unbalanced, or with a wrong balance factor).
+	 */
+	int
+	avl_height( const dsa::Node* node )
+	{
+		const auto left = ( node->leftNodeType == dsa::CHILD ) ? avl_height( node->leftNode ) : 0;
+		const auto right = ( node->rightNodeType == dsa::CHILD ) ? avl_height( node->rightNode ) : 0;
+
+		if ( left < 0 || right < 0 || std::abs( right - left ) > 1 || node->balanceFactor != right - left )
+		{
+			return -1;
+		}
+
+		return 1 + std::max( left, right );
+	}
+
+	void
+	write_file(
+		const std::string& path,
+		const std::string& contents )
+	{
+		std::ofstream output( path, std::ios::out | std::ios::binary | std::ios::trunc );
+		output << contents;
+	}
+
+	/**
+	 * String buffer counting how many times its stream was flushed.
+	 */
+	class counting_buffer : public std::stringbuf
+	{
+	public:
+		std::size_t flushes = 0;
+
+	protected:
+		int
+		sync() override
+		{
+			++this->flushes;
+			return std::stringbuf::sync();
+		}
+	};
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "empty" ).c_str() )
+	{
+		ThreadedBinarySearchTree tree;
+
+		REQUIRE( tree.isEmpty() );
+		REQUIRE( tree.getNodesCount() == 0 );
+		REQUIRE( tree.find( "token" ) == nullptr );
+		REQUIRE( tree.getFirst() == nullptr );
+		REQUIRE( tree.topK( 3 ).empty() );
+		REQUIRE_FALSE( tree.remove( "token" ) );
+		REQUIRE_FALSE( tree.insert( "" ) );
+		REQUIRE( tree.traverse( PREORDER ).begin() == tree.traverse( PREORDER ).end() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "insert_remove" ).c_str() )
+	{
+		for ( const auto balancing : { false, true } )
+		{
+			const auto tokens = random_tokens( TOKENS );
+			ThreadedBinarySearchTree tree( balancing );
+			frequencies reference;
+
+			for ( std::size_t token = 0; token < tokens.size(); ++token )
+			{
+				if ( token % 3 == 2 )
+				{
+					REQUIRE( tree.remove( tokens[ token ] ) == ( reference.erase( tokens[ token ] ) == 1 ) );
+				}
+				else
+				{
+					REQUIRE( tree.insert( tokens[ token ] ) );
+					++reference[ tokens[ token ] ];
+				}
+			}
+
+			REQUIRE( tree.isSelfBalancing() == balancing );
+			REQUIRE( tree.getNodesCount() == static_cast< int >( reference.size() ) );
+			REQUIRE( tree_tokens( tree ) == reference );
+
+			for ( const auto& token : reference )
+			{
+				const auto* node = tree.find( token.first );
+
+				REQUIRE( node != nullptr );
+				REQUIRE( node->data.getFrequency() == token.second );
+			}
+
+			const ThreadedBinarySearchTree copy( tree );
+
+			REQUIRE( tree_tokens( copy ) == reference );
+
+			tree.clear();
+
+			REQUIRE( tree.isEmpty() );
+			REQUIRE( tree_tokens( copy ) == reference );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "ingest" ).c_str() )
+	{
+		const auto text = random_text( TOKENS );
+		const auto reference = count_tokens( text );
+
+		write_file( TEXT_FILE, text );
+
+		ThreadedBinarySearchTree streamed;
+		std::ifstream input( TEXT_FILE, std::ios::in | std::ios::binary );
+		input >> streamed;
+
+		REQUIRE( tree_tokens( streamed ) == reference );
+
+		// Tokens are inserted in order of first occurrence, so the trees are identical.
+		for ( const auto threads : { 1, 3, static_cast< int >( THREADS ), 0 } )
+		{
+			ThreadedBinarySearchTree ingested;
+
+			REQUIRE( ingested.ingest( TEXT_FILE, threads ) );
+			REQUIRE( tree_tokens( ingested ) == reference );
+			REQUIRE( traversal_tokens( ingested, PREORDER ) == traversal_tokens( streamed, PREORDER ) );
+		}
+
+		ThreadedBinarySearchTree missing;
+
+		REQUIRE_FALSE( missing.ingest( TEXT_FILE + ".missing" ) );
+
+		std::remove( TEXT_FILE.c_str() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "interned_tokens" ).c_str() )
+	{
+		TokenArena arena;
+		const std::string long_token( 100000, 'x' );
+
+		const auto* first = arena.intern( "token" );
+
+		REQUIRE( std::string( first ) == "token" );
+		REQUIRE( arena.intern( std::string( "token" ) ) == first );
+		REQUIRE( arena.intern( "tokens" ) != first );
+		REQUIRE( std::string( arena.intern( long_token ) ) == long_token );
+		REQUIRE( arena.getTokensCount() == 3 );
+
+		arena.clear();
+
+		REQUIRE( arena.getTokensCount() == 0 );
+
+		// Whichever representation nodeData uses (see DSA_TBST_INTERN_TOKENS).
+		nodeData data( "beta", arena );
+
+		REQUIRE( data.getTokenView() == "beta" );
+		REQUIRE( data.compare( "alpha" ) > 0 );
+		REQUIRE( data.compare( "betamax" ) < 0 );
+		REQUIRE( data.compare( nodeData( "beta", arena ) ) == 0 );
+		REQUIRE( data.startsWith( "be" ) );
+		REQUIRE_FALSE( data.startsWith( "betas" ) );
+		REQUIRE( data == "beta" );
+		REQUIRE( data < "gamma" );
+
+		// Each tree interns its own tokens, so a copy outlives its source.
+		auto source = std::make_unique< ThreadedBinarySearchTree >();
+
+		for ( const auto& token : random_tokens( TOKENS ) )
+		{
+			source->insert( token );
+		}
+
+		const ThreadedBinarySearchTree copy( *source );
+		const auto reference = tree_tokens( *source );
+
+		source.reset();
+
+		REQUIRE( tree_tokens( copy ) == reference );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "traversal_ranges" ).c_str() )
+	{
+		for ( const auto balancing : { false, true } )
+		{
+			ThreadedBinarySearchTree tree( balancing );
+
+			for ( const auto& token : random_tokens( TOKENS ) )
+			{
+				tree.insert( token );
+			}
+
+			// The pre-order walk starts at the root.
+			const auto* root = *tree.traverse( PREORDER ).begin();
+
+			std::vector< std::string > preorder;
+			std::vector< std::string > inorder;
+			std::vector< std::string > postorder;
+
+			walk_children( root, 0, preorder );
+			walk_children( root, 1, inorder );
+			walk_children( root, 2, postorder );
+
+			REQUIRE( std::is_sorted( std::begin( inorder ), std::end( inorder ) ) );
+			REQUIRE( traversal_tokens( tree, PREORDER ) == preorder );
+			REQUIRE( traversal_tokens( tree, INORDER ) == inorder );
+			REQUIRE( traversal_tokens( tree, ITERATIVE ) == inorder );
+			REQUIRE( traversal_tokens( tree, POSTORDER ) == postorder );
+
+			// The array traversals list the same nodes as the lazy ranges.
+			auto* list = tree.postorderTraverse();
+			std::vector< std::string > listed;
+
+			for ( int node = 0; node < tree.getNodesCount(); ++node )
+			{
+				listed.push_back( list[ node ]->data.getToken() );
+			}
+
+			delete[] list;
+
+			REQUIRE( listed == postorder );
+
+			// Threads link every node to its in-order neighbors, both ways.
+			std::vector< std::string > backward;
+
+			for ( auto* node = tree.getLast(); node != nullptr; node = tree.getPrevious( node ) )
+			{
+				backward.push_back( node->data.getToken() );
+			}
+
+			std::reverse( std::begin( backward ), std::end( backward ) );
+
+			REQUIRE( backward == inorder );
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "avl_balance" ).c_str() )
+	{
+		ThreadedBinarySearchTree tree( true );
+		std::vector< std::string > tokens;
+
+		// Sorted insertions degenerate an unbalanced tree into a vine.
+		for ( std::size_t token = 0; token < TOKENS; ++token )
+		{
+			auto digits = std::to_string( token );
+			tokens.push_back( "t" + std::string( 6 - digits.size(), '0' ) + digits );
+			tree.insert( tokens.back() );
+		}
+
+		const auto* root = *tree.traverse( PREORDER ).begin();
+		const auto bound = 1.45 * std::log2( static_cast< double >( TOKENS ) + 2 );
+
+		REQUIRE( avl_height( root ) > 0 );
+		REQUIRE( avl_height( root ) <= bound );
+
+		for ( std::size_t token = 0; token < TOKENS; token += 2 )
+		{
+			REQUIRE( tree.remove( tokens[ token ] ) );
+		}
+
+		root = *tree.traverse( PREORDER ).begin();
+
+		REQUIRE( tree.getNodesCount() == static_cast< int >( TOKENS / 2 ) );
+		REQUIRE( avl_height( root ) > 0 );
+		REQUIRE( avl_height( root ) <= bound );
+
+		const auto remaining = traversal_tokens( tree, INORDER );
+
+		REQUIRE( std::is_sorted( std::begin( remaining ), std::end( remaining ) ) );
+
+		// An unbalanced tree is rebalanced on demand.
+		ThreadedBinarySearchTree vine;
+
+		for ( const auto& token : tokens )
+		{
+			vine.insert( token );
+		}
+
+		vine.balance();
+
+		std::vector< std::string > balanced;
+		walk_children( *vine.traverse( PREORDER ).begin(), 1, balanced );
+
+		REQUIRE( vine.getHeigth() == std::ceil( std::log2( static_cast< double >( TOKENS ) + 1 ) ) );
+		REQUIRE( balanced == tokens );
+		REQUIRE( traversal_tokens( vine, ITERATIVE ) == tokens );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "top_k" ).c_str() )
+	{
+		const auto text = random_text( TOKENS );
+		const auto reference = count_tokens( text );
+
+		std::vector< std::pair< int, std::string > > ranked;
+
+		for ( const auto& token : reference )
+		{
+			ranked.emplace_back( -token.second, token.first );
+		}
+
+		std::sort( std::begin( ranked ), std::end( ranked ) );
+
+		ThreadedBinarySearchTree tree;
+		std::istringstream input( text );
+		input >> tree;
+
+		const auto check = [&]( const int k )
+		{
+			const auto nodes = tree.topK( k );
+
+			REQUIRE( nodes.size() == std::min( static_cast< std::size_t >( k ), ranked.size() ) );
+
+			for ( std::size_t node = 0; node < nodes.size(); ++node )
+			{
+				REQUIRE( nodes[ node ]->data.getToken() == ranked[ node ].second );
+				REQUIRE( nodes[ node ]->data.getFrequency() == -ranked[ node ].first );
+			}
+		};
+
+		REQUIRE_FALSE( tree.hasFrequencyIndex() );
+		check( 10 );
+		check( static_cast< int >( ranked.size() ) + 5 );
+
+		tree.buildFrequencyIndex();
+
+		REQUIRE( tree.hasFrequencyIndex() );
+		check( 10 );
+		REQUIRE( tree.topK( 0 ).empty() );
+
+		tree.insert( "zzzz", 1000000 );
+
+		REQUIRE_FALSE( tree.hasFrequencyIndex() );
+		REQUIRE( tree.topK( 1 ).front()->data.getToken() == "zzzz" );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "snapshot" ).c_str() )
+	{
+		for ( const auto balancing : { false, true } )
+		{
+			ThreadedBinarySearchTree tree;
+
+			for ( const auto& token : random_tokens( TOKENS ) )
+			{
+				tree.insert( token );
+			}
+
+			REQUIRE( tree.save( SNAPSHOT_FILE ) );
+
+			ThreadedBinarySearchTree loaded( balancing );
+			loaded.insert( "stale" );
+
+			REQUIRE( loaded.load( SNAPSHOT_FILE ) );
+			REQUIRE( tree_tokens( loaded ) == tree_tokens( tree ) );
+			REQUIRE( loaded.getHeigth() <= std::ceil( std::log2( tree.getNodesCount() + 1.0 ) ) );
+
+			if ( balancing )
+			{
+				REQUIRE( avl_height( *loaded.traverse( PREORDER ).begin() ) > 0 );
+			}
+
+			// A truncated snapshot leaves the tree unchanged.
+			std::ifstream input( SNAPSHOT_FILE, std::ios::in | std::ios::binary );
+			const std::string snapshot( ( std::istreambuf_iterator< char >( input ) ), std::istreambuf_iterator< char >() );
+			input.close();
+
+			write_file( SNAPSHOT_FILE, snapshot.substr( 0, snapshot.size() / 2 ) );
+
+			REQUIRE_FALSE( loaded.load( SNAPSHOT_FILE ) );
+			REQUIRE( tree_tokens( loaded ) == tree_tokens( tree ) );
+		}
+
+		ThreadedBinarySearchTree empty;
+
+		REQUIRE( empty.save( SNAPSHOT_FILE ) );
+		REQUIRE( empty.load( SNAPSHOT_FILE ) );
+		REQUIRE( empty.isEmpty() );
+
+		std::remove( SNAPSHOT_FILE.c_str() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "node_pool" ).c_str() )
+	{
+		NodePool pool;
+		std::vector< Node* > nodes;
+
+		for ( std::size_t node = 0; node < TOKENS; ++node )
+		{
+			nodes.push_back( pool.create( "token" + std::to_string( node ) ) );
+		}
+
+		REQUIRE( pool.getNodesCount() == TOKENS );
+		REQUIRE( nodes[ 42 ]->data.getToken() == "token42" );
+
+		// Released storage is recycled before the pool grows.
+		auto* released = nodes.back();
+		pool.release( released );
+		nodes.pop_back();
+
+		auto* recycled = pool.create( *nodes.front() );
+
+		REQUIRE( recycled == released );
+		REQUIRE( recycled->data.getToken() == "token0" );
+		REQUIRE( pool.getNodesCount() == TOKENS );
+
+		NodePool other;
+		other.swap( pool );
+
+		REQUIRE( pool.getNodesCount() == 0 );
+		REQUIRE( other.getNodesCount() == TOKENS );
+
+		other.clear();
+
+		REQUIRE( other.getNodesCount() == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "left_right" ).c_str() )
+	{
+		ConcurrentThreadedBinarySearchTree tree( true );
+		const auto tokens = random_tokens( TOKENS );
+		std::atomic< bool > done { false };
+		std::atomic< std::size_t > failures { 0 };
+
+		// Readers must only ever see whole updates: the tree only grows, and its
+		// in-order walk stays sorted and as long as its node count.
+		std::vector< std::thread > readers;
+
+		for ( std::size_t reader = 0; reader < THREADS; ++reader )
+		{
+			readers.emplace_back( [&tree, &done, &failures]()
+			{
+				int previous = 0;
+
+				while ( !done )
+				{
+					const auto guard = tree.read();
+					const auto count = guard->getNodesCount();
+					const auto inorder = traversal_tokens( *guard, INORDER );
+
+					failures += ( count < previous ) ||
+						( static_cast< int >( inorder.size() ) != count ) ||
+						!std::is_sorted( std::begin( inorder ), std::end( inorder ) );
+					previous = count;
+				}
+			} );
+		}
+
+		frequencies reference;
+
+		for ( const auto& token : tokens )
+		{
+			tree.insert( token );
+			++reference[ token ];
+		}
+
+		done = true;
+
+		for ( auto& reader : readers )
+		{
+			reader.join();
+		}
+
+		REQUIRE( failures == 0 );
+		REQUIRE( tree.getNodesCount() == static_cast< int >( reference.size() ) );
+		REQUIRE( tree_tokens( *tree.read() ) == reference );
+
+		for ( const auto& token : reference )
+		{
+			REQUIRE( tree.contains( token.first ) );
+			REQUIRE( tree.getFrequency( token.first ) == token.second );
+		}
+
+		REQUIRE( tree.remove( tokens.front() ) );
+		REQUIRE_FALSE( tree.contains( tokens.front() ) );
+
+		tree.clear();
+
+		REQUIRE( tree.getNodesCount() == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "report_writer" ).c_str() )
+	{
+		ThreadedBinarySearchTree tree;
+		tree.insert( "beta", 2 );
+		tree.insert( "alpha", 1 );
+		tree.insert( "say\"hi\"", 3 );
+
+		// The small buffer is emitted many times, but the stream is only flushed on close.
+		counting_buffer csv;
+		{
+			std::ostream output( &csv );
+			ReportWriter writer( output, REPORT_CSV, 8 );
+			writer.write( tree );
+
+			REQUIRE( csv.flushes == 0 );
+			REQUIRE( writer.close() );
+			REQUIRE( csv.flushes == 1 );
+		}
+
+		REQUIRE( csv.str() == "token,frequency\r\nalpha,1\r\nbeta,2\r\n\"say\"\"hi\"\"\",3\r\n" );
+
+		std::ostringstream text;
+		{
+			ReportWriter writer( text, REPORT_TEXT );
+			writer.write( tree.traverse( INORDER ) );
+
+			REQUIRE( writer.close() );
+		}
+
+		REQUIRE( text.str() == "\talpha[1] beta[2] say\"hi\"[3] \r\n" );
+
+		std::ostringstream binary;
+		{
+			ReportWriter writer( binary, REPORT_BINARY );
+			writer.write( tree.find( "beta" ) );
+
+			REQUIRE( writer.close() );
+		}
+
+		REQUIRE( binary.str() == std::string( "\x04\x00\x00\x00" "beta" "\x02\x00\x00\x00", 12 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "prefix_range" ).c_str() )
+	{
+		for ( const auto balancing : { false, true } )
+		{
+			ThreadedBinarySearchTree tree( balancing );
+			frequencies reference;
+
+			for ( const auto& token : random_tokens( TOKENS ) )
+			{
+				tree.insert( token );
+				++reference[ token ];
+			}
+
+			const auto matches = [&]( const MatchRange& range )
+			{
+				std::vector< std::string > tokens;
+
+				for ( const auto* node : range )
+				{
+					tokens.push_back( node->data.getToken() );
+				}
+
+				return tokens;
+			};
+
+			for ( const std::string bound : { "", "a", "bc", "ddd", "eeee", "f", "ab" } )
+			{
+				std::vector< std::string > prefixed;
+
+				for ( auto token = reference.lower_bound( bound ); token != reference.end() && token->first.compare( 0, bound.size(), bound ) == 0; ++token )
+				{
+					prefixed.push_back( token->first );
+				}
+
+				REQUIRE( matches( tree.prefix( bound ) ) == prefixed );
+
+				const auto limited = matches( tree.prefix( bound, 3 ) );
+
+				REQUIRE( limited.size() == std::min< std::size_t >( 3, prefixed.size() ) );
+				REQUIRE( std::equal( std::begin( limited ), std::end( limited ), std::begin( prefixed ) ) );
+
+				if ( bound < "c" )
+				{
+					std::vector< std::string > ranged;
+
+					for ( auto token = reference.lower_bound( bound ); token != reference.lower_bound( "c" ); ++token )
+					{
+						ranged.push_back( token->first );
+					}
+
+					REQUIRE( matches( tree.range( bound, "c" ) ) == ranged );
+				}
+
+				const auto* lower = tree.lowerBound( bound );
+				const auto expected = reference.lower_bound( bound );
+
+				REQUIRE( ( lower == nullptr ) == ( expected == reference.end() ) );
+
+				if ( lower != nullptr )
+				{
+					REQUIRE( lower->data.getToken() == expected->first );
+				}
+			}
+		}
+	}
+
+	TEST_CASE( ( UNIT_NAME + "left_right_benchmark" ).c_str(), "[.benchmark]" )
+	{
+		std::vector< std::string > tokens;
+
+		for ( std::size_t token = 0; token < BENCHMARK_TOKENS; ++token )
+		{
+			tokens.push_back( "token" + std::to_string( token * 2654435761u % 1000003u ) );
+		}
+
+		// Readers look tokens up while a single writer keeps bumping frequencies.
+		const auto measure = [&]( const std::size_t readers, const auto& lookup, const auto& update )
+		{
+			std::atomic< bool > done { false };
+			std::atomic< std::size_t > found { 0 };
+
+			std::thread writer( [&]()
+			{
+				for ( std::size_t token = 0; !done; token = ( token + 1 ) % tokens.size() )
+				{
+					update( tokens[ token ] );
+				}
+			} );
+
+			const auto run = timed( [&]
+			{
+				std::vector< std::thread > threads;
+
+				for ( std::size_t reader = 0; reader < readers; ++reader )
+				{
+					threads.emplace_back( [&, reader]()
+					{
+						std::size_t hits = 0;
+
+						for ( auto read = reader; read < BENCHMARK_READS; read += readers )
+						{
+							hits += lookup( tokens[ ( read * 7919 ) % tokens.size() ] );
+						}
+
+						found += hits;
+					} );
+				}
+
+				for ( auto& thread : threads )
+				{
+					thread.join();
+				}
+
+				return found.load();
+			} );
+
+			done = true;
+			writer.join();
+
+			REQUIRE( run.first == BENCHMARK_READS );
+
+			return BENCHMARK_READS / run.second / 1e3;
+		};
+
+		WARN( BENCHMARK_READS << " lookups over " << BENCHMARK_TOKENS << " tokens, 1 writer, "
+			<< std::thread::hardware_concurrency() << " hardware threads" );
+
+		for ( std::size_t readers = 1; readers <= BENCHMARK_READERS; readers *= 2 )
+		{
+			ConcurrentThreadedBinarySearchTree left_right( true );
+			ThreadedBinarySearchTree shared( true );
+			std::shared_mutex lock;
+
+			for ( const auto& token : tokens )
+			{
+				left_right.insert( token );
+				shared.insert( token );
+			}
+
+			const auto left_right_throughput = measure( readers, [&]( const std::string& token )
+			{
+				return left_right.contains( token );
+			}, [&]( const std::string& token )
+			{
+				left_right.insert( token );
+			} );
+
+			const auto shared_throughput = measure( readers, [&]( const std::string& token )
+			{
+				const std::shared_lock< std::shared_mutex > guard( lock );
+				return shared.find( token ) != nullptr;
+			}, [&]( const std::string& token )
+			{
+				const std::unique_lock< std::shared_mutex > guard( lock );
+				shared.insert( token );
+			} );
+
+			WARN( readers << " readers: Left-Right " << left_right_throughput << " Mops/s, std::shared_mutex "
+				<< shared_throughput << " Mops/s" );
+		}
+	}
+}
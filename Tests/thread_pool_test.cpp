@@ -0,0 +1,132 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the thread pool.
+ */
+
+#include "concurrency/thread_pool.hpp"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "thread_pool_";
+
+	constexpr std::size_t THREADS = 4;
+	constexpr std::size_t ITERATIONS = 100000;
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "submit" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		REQUIRE( pool.size() == THREADS );
+
+		std::vector< std::future< std::size_t > > results;
+
+		for ( std::size_t task = 0; task < 64; ++task )
+		{
+			results.push_back( pool.submit( [task]()
+			{
+				return task * task;
+			} ) );
+		}
+
+		for ( std::size_t task = 0; task < results.size(); ++task )
+		{
+			REQUIRE( results[ task ].get() == task * task );
+		}
+
+		auto failed = pool.submit( []()
+		{
+			throw std::runtime_error( "task failure" );
+		} );
+
+		REQUIRE_THROWS_AS( failed.get(), const std::runtime_error& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "parallel_for_visits_each_index_once" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		std::vector< std::atomic< std::size_t > > visits( ITERATIONS );
+
+		for ( const std::size_t grain : { std::size_t { 0 }, std::size_t { 1 }, std::size_t { 7 }, ITERATIONS * 2 } )
+		{
+			for ( auto& visit : visits )
+			{
+				visit = 0;
+			}
+
+			pool.parallel_for( 0, ITERATIONS, [&visits]( const std::size_t index )
+			{
+				++visits[ index ];
+			}, grain );
+
+			std::size_t wrong = 0;
+
+			for ( const auto& visit : visits )
+			{
+				wrong += ( visit != 1 );
+			}
+
+			REQUIRE( wrong == 0 );
+		}
+
+		std::size_t calls = 0;
+		pool.parallel_for( 5, 5, [&calls]( const std::size_t )
+		{
+			++calls;
+		} );
+
+		REQUIRE( calls == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "parallel_for_nested" ).c_str() )
+	{
+		thread_pool pool( 2 );
+
+		std::atomic< std::size_t > sum { 0 };
+
+		// Every worker blocks in an inner loop; the callers must still make progress.
+		pool.parallel_for( 0, 16, [&pool, &sum]( const std::size_t outer )
+		{
+			pool.parallel_for( 0, 100, [&sum, outer]( const std::size_t inner )
+			{
+				sum += outer * inner;
+			}, 1 );
+		}, 1 );
+
+		REQUIRE( sum == ( 15 * 16 / 2 ) * ( 99 * 100 / 2 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "parallel_for_propagates_exception" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+
+		std::atomic< std::size_t > visited { 0 };
+
+		REQUIRE_THROWS_AS(
+			pool.parallel_for( 0, 1000, [&visited]( const std::size_t index )
+			{
+				++visited;
+
+				if ( index == 500 )
+				{
+					throw std::out_of_range( "index" );
+				}
+			}, 10 ),
+			const std::out_of_range& );
+
+		// Only the throwing chunk is cut short.
+		REQUIRE( visited == 991 );
+	}
+}
@@ -0,0 +1,75 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the lock-free union-find.
+ */
+
+#include "graphs/union_find.hpp"
+
+#include "concurrency/thread_pool.hpp"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "union_find_";
+
+	using vertex_type = std::uint32_t;
+
+	constexpr std::size_t VERTICES = 100000;
+	constexpr std::size_t THREADS = 4;
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "sequential" ).c_str() )
+	{
+		union_find< vertex_type > sets( 6 );
+
+		REQUIRE( sets.size() == 6 );
+		REQUIRE( sets.find( 4 ) == 4 );
+
+		REQUIRE( sets.unite( 4, 2 ) );
+		REQUIRE( sets.unite( 5, 4 ) );
+		REQUIRE_FALSE( sets.unite( 2, 5 ) );
+		REQUIRE( sets.unite( 1, 3 ) );
+
+		// Roots are the smallest vertices of their sets.
+		REQUIRE( sets.find( 5 ) == 2 );
+		REQUIRE( sets.find( 3 ) == 1 );
+		REQUIRE( sets.same( 4, 5 ) );
+		REQUIRE_FALSE( sets.same( 0, 1 ) );
+		REQUIRE_FALSE( sets.same( 3, 5 ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "concurrent" ).c_str() )
+	{
+		thread_pool pool( THREADS );
+		union_find< vertex_type > sets( VERTICES );
+		std::atomic< std::size_t > merges { 0 };
+
+		// Link every vertex to the one 10 below it, from all threads at once, twice:
+		// the 10 residue classes are left and each pair merges exactly once.
+		pool.parallel_for( 0, 2 * VERTICES, [&]( const std::size_t index )
+		{
+			const auto vertex = static_cast< vertex_type >( ( index * 7919 ) % VERTICES );
+
+			if ( vertex >= 10 && sets.unite( vertex, vertex - 10 ) )
+			{
+				++merges;
+			}
+		} );
+
+		REQUIRE( merges == VERTICES - 10 );
+
+		for ( vertex_type vertex = 0; vertex < VERTICES; ++vertex )
+		{
+			REQUIRE( sets.find( vertex ) == vertex % 10 );
+		}
+	}
+}
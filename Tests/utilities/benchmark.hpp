@@ -0,0 +1,25 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Utility function timing the runs of the benchmark test cases.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+/**
+ * Runs action and returns its result with the time it took, in milliseconds.
+ */
+template < typename Action >
+auto
+timed( const Action& action )
+{
+	const auto start = std::chrono::steady_clock::now();
+	auto result = action();
+	const auto elapsed = std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start );
+
+	return std::make_pair( std::move( result ), elapsed.count() );
+}
@@ -0,0 +1,114 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Utility functions building the R-MAT and grid graphs shared by the graph testers.
+ */
+
+#pragma once
+
+#include "graphs/csr_graph.hpp"
+
+#include "rmat_generator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * Weight in [0, max_weight] of the index-th edge, spread by a multiplicative hash.
+ */
+inline std::int32_t
+hashed_weight(
+	const std::size_t index,
+	const std::int32_t max_weight )
+{
+	return static_cast< std::int32_t >( ( index * 2654435761u ) % ( static_cast< std::size_t >( max_weight ) + 1 ) );
+}
+
+/**
+ * Returns a random (but fixed) permutation of the vertices, standing for an input order.
+ */
+inline std::vector< dsa::csr_graph<>::vertex_type >
+shuffled_labels( const std::size_t vertices )
+{
+	std::vector< dsa::csr_graph<>::vertex_type > labels( vertices );
+	std::iota( std::begin( labels ), std::end( labels ), dsa::csr_graph<>::vertex_type { 0 } );
+	std::shuffle( std::begin( labels ), std::end( labels ), std::mt19937( 1 ) );
+
+	return labels;
+}
+
+/**
+ * R-MAT graph of edge_factor edges per vertex, each one listed both ways if undirected.
+ * The graph is weighted, with hashed weights in [min_weight, max_weight], unless both
+ * bounds are equal. The vertices are renamed through shuffled_labels if shuffled.
+ */
+inline dsa::csr_graph<>
+rmat_graph(
+	const unsigned scale,
+	const std::size_t edge_factor,
+	const bool undirected,
+	const std::int32_t min_weight = 1,
+	const std::int32_t max_weight = 1,
+	const bool shuffled = false )
+{
+	rmat_generator generator( scale );
+	const auto labels = shuffled_labels( shuffled ? generator.vertices() : 0 );
+	std::vector< dsa::csr_graph<>::edge > edges;
+
+	const auto label = [&labels]( const dsa::csr_graph<>::vertex_type vertex )
+	{
+		return labels.empty() ? vertex : labels[ vertex ];
+	};
+
+	for ( std::size_t edge = 0; edge < edge_factor * generator.vertices(); ++edge )
+	{
+		const auto endpoints = generator();
+		const auto weight = min_weight + hashed_weight( edge, max_weight - min_weight );
+
+		edges.push_back( { label( endpoints.first ), label( endpoints.second ), weight } );
+
+		if ( undirected )
+		{
+			edges.push_back( { label( endpoints.second ), label( endpoints.first ), weight } );
+		}
+	}
+
+	return dsa::csr_graph<>( generator.vertices(), edges, min_weight != max_weight );
+}
+
+/**
+ * Undirected side x side grid, vertices shuffled.
+ */
+inline dsa::csr_graph<>
+grid_graph( const std::size_t side )
+{
+	const auto labels = shuffled_labels( side * side );
+	std::vector< dsa::csr_graph<>::edge > edges;
+
+	for ( std::size_t row = 0; row < side; ++row )
+	{
+		for ( std::size_t column = 0; column < side; ++column )
+		{
+			const auto vertex = labels[ row * side + column ];
+
+			if ( column + 1 < side )
+			{
+				edges.push_back( { vertex, labels[ row * side + column + 1 ], 1 } );
+				edges.push_back( { labels[ row * side + column + 1 ], vertex, 1 } );
+			}
+
+			if ( row + 1 < side )
+			{
+				edges.push_back( { vertex, labels[ ( row + 1 ) * side + column ], 1 } );
+				edges.push_back( { labels[ ( row + 1 ) * side + column ], vertex, 1 } );
+			}
+		}
+	}
+
+	return dsa::csr_graph<>( side * side, edges, false );
+}
@@ -0,0 +1,79 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Utility class for generating the edges of an R-MAT graph
+ * (Chakrabarti, Zhan, Faloutsos - "R-MAT: A Recursive Model for Graph Mining").
+ *
+ * Each edge picks one quadrant of the adjacency matrix per bit of the vertex
+ * indices, with probabilities a, b, c and 1 - a - b - c, which yields the skewed
+ * degree distribution and small diameter of real-world networks. The defaults
+ * are the Graph500 parameters.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <utility>
+
+class rmat_generator
+{
+public:
+
+	explicit rmat_generator(
+		const unsigned vertex_bits,
+		const std::uint32_t seed = 1,
+		const double probability_a = 0.57,
+		const double probability_b = 0.19,
+		const double probability_c = 0.19 ) :
+		scale( vertex_bits ),
+		a( probability_a ),
+		ab( probability_a + probability_b ),
+		abc( probability_a + probability_b + probability_c ),
+		engine( seed )
+	{
+	}
+	~rmat_generator() noexcept = default;
+
+	rmat_generator( const rmat_generator& ) = delete;
+	rmat_generator( rmat_generator&& ) noexcept = delete;
+
+	rmat_generator& operator=( const rmat_generator& ) = delete;
+	rmat_generator& operator=( rmat_generator&& ) noexcept = delete;
+
+	std::uint32_t
+	vertices() const noexcept
+	{
+		return std::uint32_t { 1 } << this->scale;
+	}
+
+	/**
+	 * Returns the (source, target) vertices of the next edge.
+	 */
+	std::pair< std::uint32_t, std::uint32_t >
+	operator()()
+	{
+		std::uint32_t source = 0;
+		std::uint32_t target = 0;
+
+		for ( unsigned bit = 0; bit < this->scale; ++bit )
+		{
+			const auto quadrant = this->distribution( this->engine );
+
+			source = ( source << 1 ) | ( quadrant >= this->ab ? 1 : 0 );
+			target = ( target << 1 ) | ( ( quadrant >= this->a && quadrant < this->ab ) || quadrant >= this->abc ? 1 : 0 );
+		}
+
+		return { source, target };
+	}
+
+private:
+	const unsigned scale;
+	const double a;
+	const double ab;
+	const double abc;
+
+	std::mt19937 engine;
+	std::uniform_real_distribution< double > distribution { 0.0, 1.0 };
+};
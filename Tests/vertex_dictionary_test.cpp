@@ -0,0 +1,191 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the vertex name dictionary.
+ */
+
+#include "graphs/vertex_dictionary.hpp"
+
+#include "graphs/csr_graph.hpp"
+#include "utilities/benchmark.hpp"
+#include "utilities/generator.hpp"
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "vertex_dictionary_";
+
+	using dictionary_type = dsa::vertex_dictionary<>;
+
+	constexpr std::size_t NAMES = 20000;
+	constexpr std::size_t BENCHMARK_NAMES = 1 << 20;
+	constexpr std::size_t BENCHMARK_EDGES = 1 << 22;
+
+	std::vector< std::string >
+	vertex_names( const std::size_t count )
+	{
+		std::vector< std::string > names;
+		names.reserve( count );
+
+		for ( std::size_t name = 0; name < count; ++name )
+		{
+			names.push_back( "vertex-" + std::to_string( name * 2654435761u % 1000000007u ) );
+		}
+
+		return names;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "intern" ).c_str() )
+	{
+		dictionary_type dictionary;
+
+		REQUIRE( dictionary.empty() );
+		REQUIRE( dictionary.find( "Alpha" ) == dictionary_type::npos );
+
+		REQUIRE( dictionary.intern( "Alpha" ) == 0 );
+		REQUIRE( dictionary.intern( "Beta" ) == 1 );
+		REQUIRE( dictionary.intern( "Alpha" ) == 0 );
+		REQUIRE( dictionary.intern( "" ) == 2 );
+		REQUIRE( dictionary.intern( "Alph" ) == 3 );
+
+		REQUIRE( dictionary.size() == 4 );
+		REQUIRE( dictionary.find( "Beta" ) == 1 );
+		REQUIRE( dictionary.contains( "" ) );
+		REQUIRE_FALSE( dictionary.contains( "Gamma" ) );
+
+		REQUIRE( dictionary.name( 0 ) == "Alpha" );
+		REQUIRE( dictionary.name( 2 ).empty() );
+		REQUIRE( dictionary.name( 3 ) == "Alph" );
+		REQUIRE_THROWS_AS( dictionary.name( 4 ), const std::out_of_range& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "empty_name_first" ).c_str() )
+	{
+		dictionary_type dictionary;
+
+		// The empty name leaves the arena empty, and is looked up again before
+		// and after the arena holds characters.
+		REQUIRE( dictionary.intern( "" ) == 0 );
+		REQUIRE( dictionary.intern( "" ) == 0 );
+		REQUIRE( dictionary.find( "" ) == 0 );
+		REQUIRE( dictionary.name( 0 ).empty() );
+
+		REQUIRE( dictionary.intern( "Alpha" ) == 1 );
+		REQUIRE( dictionary.intern( "" ) == 0 );
+		REQUIRE( dictionary.find( "Alpha" ) == 1 );
+		REQUIRE( dictionary.size() == 2 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "growth" ).c_str() )
+	{
+		const auto names = vertex_names( NAMES );
+		dictionary_type dictionary;
+
+		for ( std::size_t name = 0; name < names.size(); ++name )
+		{
+			REQUIRE( dictionary.intern( names[ name ] ) == name );
+		}
+
+		// Once the index has grown many times, every name still maps to its id.
+		for ( std::size_t name = 0; name < names.size(); ++name )
+		{
+			REQUIRE( dictionary.find( names[ name ] ) == name );
+			REQUIRE( dictionary.name( static_cast< dictionary_type::id_type >( name ) ) == names[ name ] );
+		}
+
+		auto copy = dictionary;
+		copy.reserve( 4 * NAMES );
+
+		REQUIRE( copy.intern( names.back() ) == NAMES - 1 );
+		REQUIRE( copy.intern( "another" ) == NAMES );
+		REQUIRE_FALSE( dictionary.contains( "another" ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "named edges" ).c_str() )
+	{
+		vertex_dictionary< std::uint32_t > dictionary;
+		const std::vector< named_edge<> > edges =
+		{
+			{ "Seattle", "Portland", 174 },
+			{ "Portland", "Boise", 430 },
+			{ "Seattle", "Spokane", 279 },
+			{ "Spokane", "Boise", 289 }
+		};
+
+		const auto interned = intern_edges( dictionary, edges );
+		const csr_graph<> graph( dictionary.size(), interned );
+
+		REQUIRE( dictionary.size() == 4 );
+		REQUIRE( dictionary.name( 0 ) == "Seattle" );
+		REQUIRE( dictionary.name( 3 ) == "Spokane" );
+
+		const auto seattle = dictionary.find( "Seattle" );
+		const auto targets = graph.neighbors( seattle );
+
+		REQUIRE( targets.size() == 2 );
+		REQUIRE( dictionary.name( targets[ 0 ] ) == "Portland" );
+		REQUIRE( dictionary.name( targets[ 1 ] ) == "Spokane" );
+		REQUIRE( graph.neighbors( dictionary.find( "Boise" ) ).size() == 0 );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		const auto names = vertex_names( BENCHMARK_NAMES );
+		generator< std::uint32_t > generator;
+		std::vector< named_edge<> > edges( BENCHMARK_EDGES );
+
+		for ( auto& edge : edges )
+		{
+			edge = { names[ generator() % BENCHMARK_NAMES ], names[ generator() % BENCHMARK_NAMES ], 1 };
+		}
+
+		const auto measure = [&]( const auto& build )
+		{
+			const auto [ vertices, milliseconds ] = timed( build );
+
+			REQUIRE( vertices <= BENCHMARK_NAMES );
+
+			return milliseconds;
+		};
+
+		WARN( BENCHMARK_NAMES << " names, " << BENCHMARK_EDGES << " named edges" );
+		WARN( "std::unordered_map< std::string, id >: " << measure( [&]
+		{
+			std::unordered_map< std::string, std::uint32_t > ids;
+			std::vector< csr_graph<>::edge > result;
+			result.reserve( edges.size() );
+
+			const auto intern = [&ids]( const std::string_view name )
+			{
+				return ids.emplace( std::string( name ), static_cast< std::uint32_t >( ids.size() ) ).first->second;
+			};
+
+			for ( const auto& edge : edges )
+			{
+				const auto source = intern( edge.source );
+
+				result.push_back( { source, intern( edge.target ), edge.weight } );
+			}
+
+			return csr_graph<>( ids.size(), result ).vertex_count();
+		} ) << " ms" );
+		WARN( "vertex_dictionary: " << measure( [&]
+		{
+			vertex_dictionary< std::uint32_t > dictionary;
+			const auto result = intern_edges( dictionary, edges );
+
+			return csr_graph<>( dictionary.size(), result ).vertex_count();
+		} ) << " ms" );
+	}
+}
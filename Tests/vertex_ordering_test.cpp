@@ -0,0 +1,235 @@
+/**
+ * Daniel Sebastian Iliescu, http://dansil.net
+ * MIT License (MIT), http://opensource.org/licenses/MIT
+ *
+ * Tester for the vertex orderings and relabeling.
+ */
+
+#include "graphs/breadth_first_search.hpp"
+#include "graphs/csr_graph.hpp"
+#include "graphs/vertex_ordering.hpp"
+
+#include "utilities/benchmark.hpp"
+#include "utilities/graph_fixtures.hpp"
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+	const std::string UNIT_NAME = "vertex_ordering_";
+
+	using graph_type = dsa::csr_graph<>;
+	using vertex_type = graph_type::vertex_type;
+	using edge_type = graph_type::edge;
+
+	constexpr unsigned SCALE = 12;
+	constexpr std::size_t EDGE_FACTOR = 16;
+	constexpr unsigned BENCHMARK_SCALE = 20;
+	constexpr std::size_t GRID_SIDE = 40;
+	constexpr std::size_t BENCHMARK_GRID_SIDE = 2000;
+	constexpr std::size_t SWEEPS = 10;
+	constexpr std::size_t BENCHMARK_SOURCE = 0;
+
+	/**
+	 * Largest label difference between the endpoints of an edge.
+	 */
+	std::size_t
+	bandwidth( const graph_type& graph )
+	{
+		std::size_t result = 0;
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			for ( const auto target : graph.neighbors( vertex ) )
+			{
+				result = std::max< std::size_t >( result, vertex > target ? vertex - target : target - vertex );
+			}
+		}
+
+		return result;
+	}
+
+	bool
+	is_permutation( const std::vector< vertex_type >& labels )
+	{
+		std::vector< vertex_type > sorted( labels );
+		std::sort( std::begin( sorted ), std::end( sorted ) );
+
+		for ( std::size_t index = 0; index < sorted.size(); ++index )
+		{
+			if ( sorted[ index ] != index )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Sorted (source, target, weight) triples of the graph, renamed through labels.
+	 */
+	std::vector< std::tuple< vertex_type, vertex_type, std::int32_t > >
+	renamed_edges(
+		const graph_type& graph,
+		const std::vector< vertex_type >& labels )
+	{
+		std::vector< std::tuple< vertex_type, vertex_type, std::int32_t > > edges;
+
+		for ( vertex_type vertex = 0; vertex < graph.vertex_count(); ++vertex )
+		{
+			const auto neighbors = graph.neighbors( vertex );
+
+			for ( std::size_t edge = 0; edge < neighbors.size(); ++edge )
+			{
+				edges.emplace_back( labels[ vertex ], labels[ neighbors[ edge ] ], graph.weighted() ? graph.neighbor_weights( vertex )[ edge ] : 0 );
+			}
+		}
+
+		std::sort( std::begin( edges ), std::end( edges ) );
+
+		return edges;
+	}
+}
+
+namespace dsa
+{
+	TEST_CASE( ( UNIT_NAME + "relabel" ).c_str() )
+	{
+		const auto graph = rmat_graph( SCALE, EDGE_FACTOR, true, 0, 99, true );
+		const auto labels = shuffled_labels( graph.vertex_count() );
+		const auto relabeled = relabel( graph, labels );
+
+		std::vector< vertex_type > identity( graph.vertex_count() );
+		std::iota( std::begin( identity ), std::end( identity ), vertex_type { 0 } );
+
+		REQUIRE( relabeled.vertex_count() == graph.vertex_count() );
+		REQUIRE( relabeled.weighted() );
+		REQUIRE( renamed_edges( graph, labels ) == renamed_edges( relabeled, identity ) );
+
+		for ( vertex_type vertex = 0; vertex < relabeled.vertex_count(); ++vertex )
+		{
+			const auto neighbors = relabeled.neighbors( vertex );
+
+			REQUIRE( std::is_sorted( neighbors.begin(), neighbors.end() ) );
+		}
+
+		REQUIRE_THROWS_AS( relabel( graph, std::vector< vertex_type >( 3 ) ), const std::invalid_argument& );
+		REQUIRE_THROWS_AS( relabel( graph, std::vector< vertex_type >( graph.vertex_count(), 0 ) ), const std::invalid_argument& );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "degree" ).c_str() )
+	{
+		const auto graph = rmat_graph( SCALE, EDGE_FACTOR, true, 0, 99, true );
+		const auto labels = degree_ordering( graph );
+
+		REQUIRE( is_permutation( labels ) );
+
+		const auto relabeled = relabel( graph, labels );
+
+		for ( vertex_type vertex = 1; vertex < relabeled.vertex_count(); ++vertex )
+		{
+			REQUIRE( relabeled.degree( vertex - 1 ) >= relabeled.degree( vertex ) );
+		}
+
+		REQUIRE( ( degree_ordering( graph_type( 3, {} ) ) == std::vector< vertex_type > { 0, 1, 2 } ) );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "reverse_cuthill_mckee" ).c_str() )
+	{
+		// A shuffled path and grid get back their narrow band.
+		const auto path_labels = shuffled_labels( 100 );
+		std::vector< edge_type > path_edges;
+
+		for ( vertex_type vertex = 0; vertex + 1 < 100; ++vertex )
+		{
+			path_edges.push_back( { path_labels[ vertex ], path_labels[ vertex + 1 ], 1 } );
+			path_edges.push_back( { path_labels[ vertex + 1 ], path_labels[ vertex ], 1 } );
+		}
+
+		const graph_type path( 100, path_edges, false );
+		const auto path_ordering = reverse_cuthill_mckee_ordering( path );
+
+		REQUIRE( is_permutation( path_ordering ) );
+		REQUIRE( bandwidth( relabel( path, path_ordering ) ) == 1 );
+
+		const auto grid = grid_graph( GRID_SIDE );
+		const auto grid_ordering = reverse_cuthill_mckee_ordering( grid );
+
+		REQUIRE( is_permutation( grid_ordering ) );
+		REQUIRE( bandwidth( relabel( grid, grid_ordering ) ) <= GRID_SIDE + 1 );
+		REQUIRE( bandwidth( grid ) > 10 * GRID_SIDE );
+
+		// Disconnected graphs and isolated vertices are labeled as well.
+		const graph_type scattered( 6, { { 4, 1, 1 }, { 1, 4, 1 }, { 2, 5, 1 } }, false );
+
+		REQUIRE( is_permutation( reverse_cuthill_mckee_ordering( scattered ) ) );
+		REQUIRE( reverse_cuthill_mckee_ordering( graph_type() ).empty() );
+	}
+
+	TEST_CASE( ( UNIT_NAME + "benchmark" ).c_str(), "[.benchmark]" )
+	{
+		thread_pool pool;
+
+		const auto measure = [&]( const graph_type& graph, const vertex_type source )
+		{
+			std::vector< double > values( graph.vertex_count(), 1.0 );
+			std::vector< double > sums( graph.vertex_count() );
+
+			// Pull sweeps (as in PageRank), then a top-down search.
+			const auto [ tree, milliseconds ] = timed( [&]
+			{
+				for ( std::size_t sweep = 0; sweep < SWEEPS; ++sweep )
+				{
+					pool.parallel_for( 0, graph.vertex_count(), [&]( const std::size_t vertex )
+					{
+						double sum = 0;
+
+						for ( const auto target : graph.neighbors( static_cast< vertex_type >( vertex ) ) )
+						{
+							sum += values[ target ];
+						}
+
+						sums[ vertex ] = sum;
+					} );
+
+					values.swap( sums );
+				}
+
+				return breadth_first_search( graph, graph, source, pool, 0 );
+			} );
+
+			REQUIRE( tree.distances[ source ] == 0 );
+
+			return milliseconds;
+		};
+
+		// Every search starts from the same input vertex, under its new label.
+		const auto compare = [&]( const graph_type& graph )
+		{
+			const auto degree = degree_ordering( graph );
+			const auto cuthill_mckee = reverse_cuthill_mckee_ordering( graph );
+
+			WARN( "input order: " << measure( graph, BENCHMARK_SOURCE ) << " ms" );
+			WARN( "degree: " << measure( relabel( graph, degree ), degree[ BENCHMARK_SOURCE ] ) << " ms" );
+			WARN( "reverse Cuthill-McKee: " << measure( relabel( graph, cuthill_mckee ), cuthill_mckee[ BENCHMARK_SOURCE ] ) << " ms" );
+		};
+
+		const auto rmat = rmat_graph( BENCHMARK_SCALE, EDGE_FACTOR, true, 0, 99, true );
+
+		WARN( "R-MAT scale " << BENCHMARK_SCALE << ", " << rmat.edge_count() << " edges, " << pool.size() << " threads, " << SWEEPS << " sweeps and a search" );
+		compare( rmat );
+
+		const auto grid = grid_graph( BENCHMARK_GRID_SIDE );
+
+		WARN( BENCHMARK_GRID_SIDE << "x" << BENCHMARK_GRID_SIDE << " grid, " << grid.edge_count() << " edges" );
+		compare( grid );
+	}
+}